@@ -0,0 +1,596 @@
+#!/usr/bin/env python3
+"""
+Local stand-in for the global API, for testing the plugin's WebSocket client without the real service.
+
+Only needs the Python standard library. Point the server config at it and give it any key:
+
+    "apiUrl" "http://127.0.0.1:8080"
+    "apiKey" "local"
+
+    python3 scripts/mock_api_server.py --encoding msgpack --approve-map surf_beginner
+
+The server answers the handshake with the encoding passed in --encoding (or the plugin's first choice with "auto"),
+accepts permessage-deflate unless --no-deflate is given, and keeps submitted records in memory so the world record
+cache and record queries return something. Records resubmitted with the same idempotency key are only stored once.
+Every message is logged with its size on the wire.
+"""
+
+import argparse
+import asyncio
+import base64
+import hashlib
+import json
+import struct
+import time
+import zlib
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+OP_CONTINUATION = 0x0
+OP_TEXT = 0x1
+OP_BINARY = 0x2
+OP_CLOSE = 0x8
+OP_PING = 0x9
+OP_PONG = 0xA
+
+# --------------------------------------------------------------------------------------------------------------------
+# MessagePack (the subset nlohmann produces: nil, bool, int, float, str, bin, array, map)
+# --------------------------------------------------------------------------------------------------------------------
+
+
+def msgpack_encode(value, out=None):
+    out = bytearray() if out is None else out
+    if value is None:
+        out.append(0xC0)
+    elif value is True:
+        out.append(0xC3)
+    elif value is False:
+        out.append(0xC2)
+    elif isinstance(value, int):
+        if 0 <= value < 0x80:
+            out.append(value)
+        elif -32 <= value < 0:
+            out.append(value & 0xFF)
+        elif value >= 0:
+            for limit, code, fmt in ((0xFF, 0xCC, ">B"), (0xFFFF, 0xCD, ">H"), (0xFFFFFFFF, 0xCE, ">I")):
+                if value <= limit:
+                    out.append(code)
+                    out += struct.pack(fmt, value)
+                    break
+            else:
+                out.append(0xCF)
+                out += struct.pack(">Q", value)
+        else:
+            for limit, code, fmt in ((-0x80, 0xD0, ">b"), (-0x8000, 0xD1, ">h"), (-0x80000000, 0xD2, ">i")):
+                if value >= limit:
+                    out.append(code)
+                    out += struct.pack(fmt, value)
+                    break
+            else:
+                out.append(0xD3)
+                out += struct.pack(">q", value)
+    elif isinstance(value, float):
+        out.append(0xCB)
+        out += struct.pack(">d", value)
+    elif isinstance(value, str):
+        data = value.encode("utf-8")
+        if len(data) < 32:
+            out.append(0xA0 | len(data))
+        elif len(data) <= 0xFF:
+            out += bytes((0xD9, len(data)))
+        elif len(data) <= 0xFFFF:
+            out.append(0xDA)
+            out += struct.pack(">H", len(data))
+        else:
+            out.append(0xDB)
+            out += struct.pack(">I", len(data))
+        out += data
+    elif isinstance(value, (bytes, bytearray)):
+        out.append(0xC6)
+        out += struct.pack(">I", len(value))
+        out += value
+    elif isinstance(value, (list, tuple)):
+        if len(value) < 16:
+            out.append(0x90 | len(value))
+        else:
+            out.append(0xDD)
+            out += struct.pack(">I", len(value))
+        for item in value:
+            msgpack_encode(item, out)
+    elif isinstance(value, dict):
+        if len(value) < 16:
+            out.append(0x80 | len(value))
+        else:
+            out.append(0xDF)
+            out += struct.pack(">I", len(value))
+        for key, item in value.items():
+            msgpack_encode(key, out)
+            msgpack_encode(item, out)
+    else:
+        raise TypeError(f"cannot encode {type(value).__name__} as MessagePack")
+    return bytes(out)
+
+
+def msgpack_decode(data):
+    value, offset = _msgpack_decode(data, 0)
+    if offset != len(data):
+        raise ValueError("trailing bytes after MessagePack document")
+    return value
+
+
+def _msgpack_decode(data, offset):
+    code = data[offset]
+    offset += 1
+
+    def take(fmt):
+        nonlocal offset
+        size = struct.calcsize(fmt)
+        (result,) = struct.unpack_from(fmt, data, offset)
+        offset += size
+        return result
+
+    def raw(size):
+        nonlocal offset
+        result = data[offset : offset + size]
+        offset += size
+        return result
+
+    if code < 0x80:
+        return code, offset
+    if code >= 0xE0:
+        return code - 0x100, offset
+    if 0x80 <= code <= 0x8F or code in (0xDE, 0xDF):
+        count = code & 0x0F if code <= 0x8F else take(">H" if code == 0xDE else ">I")
+        result = {}
+        for _ in range(count):
+            key, offset = _msgpack_decode(data, offset)
+            result[key], offset = _msgpack_decode(data, offset)
+        return result, offset
+    if 0x90 <= code <= 0x9F or code in (0xDC, 0xDD):
+        count = code & 0x0F if code <= 0x9F else take(">H" if code == 0xDC else ">I")
+        result = []
+        for _ in range(count):
+            item, offset = _msgpack_decode(data, offset)
+            result.append(item)
+        return result, offset
+    if 0xA0 <= code <= 0xBF or code in (0xD9, 0xDA, 0xDB):
+        size = code & 0x1F if code <= 0xBF else take({0xD9: ">B", 0xDA: ">H", 0xDB: ">I"}[code])
+        return raw(size).decode("utf-8"), offset
+    if code in (0xC4, 0xC5, 0xC6):
+        return bytes(raw(take({0xC4: ">B", 0xC5: ">H", 0xC6: ">I"}[code]))), offset
+    simple = {0xC0: None, 0xC2: False, 0xC3: True}
+    if code in simple:
+        return simple[code], offset
+    formats = {
+        0xCA: ">f",
+        0xCB: ">d",
+        0xCC: ">B",
+        0xCD: ">H",
+        0xCE: ">I",
+        0xCF: ">Q",
+        0xD0: ">b",
+        0xD1: ">h",
+        0xD2: ">i",
+        0xD3: ">q",
+    }
+    if code in formats:
+        return take(formats[code]), offset
+    raise ValueError(f"unsupported MessagePack type 0x{code:02x}")
+
+
+# --------------------------------------------------------------------------------------------------------------------
+# CBOR (definite lengths only, which is all nlohmann writes)
+# --------------------------------------------------------------------------------------------------------------------
+
+
+def _cbor_head(major, length, out):
+    if length < 24:
+        out.append((major << 5) | length)
+    elif length <= 0xFF:
+        out += bytes(((major << 5) | 24, length))
+    elif length <= 0xFFFF:
+        out.append((major << 5) | 25)
+        out += struct.pack(">H", length)
+    elif length <= 0xFFFFFFFF:
+        out.append((major << 5) | 26)
+        out += struct.pack(">I", length)
+    else:
+        out.append((major << 5) | 27)
+        out += struct.pack(">Q", length)
+
+
+def cbor_encode(value, out=None):
+    out = bytearray() if out is None else out
+    if value is None:
+        out.append(0xF6)
+    elif value is True:
+        out.append(0xF5)
+    elif value is False:
+        out.append(0xF4)
+    elif isinstance(value, int):
+        if value >= 0:
+            _cbor_head(0, value, out)
+        else:
+            _cbor_head(1, -1 - value, out)
+    elif isinstance(value, float):
+        out.append(0xFB)
+        out += struct.pack(">d", value)
+    elif isinstance(value, str):
+        data = value.encode("utf-8")
+        _cbor_head(3, len(data), out)
+        out += data
+    elif isinstance(value, (bytes, bytearray)):
+        _cbor_head(2, len(value), out)
+        out += value
+    elif isinstance(value, (list, tuple)):
+        _cbor_head(4, len(value), out)
+        for item in value:
+            cbor_encode(item, out)
+    elif isinstance(value, dict):
+        _cbor_head(5, len(value), out)
+        for key, item in value.items():
+            cbor_encode(key, out)
+            cbor_encode(item, out)
+    else:
+        raise TypeError(f"cannot encode {type(value).__name__} as CBOR")
+    return bytes(out)
+
+
+def cbor_decode(data):
+    value, offset = _cbor_decode(data, 0)
+    if offset != len(data):
+        raise ValueError("trailing bytes after CBOR document")
+    return value
+
+
+def _cbor_decode(data, offset):
+    initial = data[offset]
+    offset += 1
+    major, info = initial >> 5, initial & 0x1F
+
+    if major == 7:
+        if info == 20:
+            return False, offset
+        if info == 21:
+            return True, offset
+        if info in (22, 23):
+            return None, offset
+        if info == 25:
+            return struct.unpack_from(">e", data, offset)[0], offset + 2
+        if info == 26:
+            return struct.unpack_from(">f", data, offset)[0], offset + 4
+        if info == 27:
+            return struct.unpack_from(">d", data, offset)[0], offset + 8
+        raise ValueError(f"unsupported CBOR simple value {info}")
+
+    if info < 24:
+        length = info
+    elif info in (24, 25, 26, 27):
+        fmt = {24: ">B", 25: ">H", 26: ">I", 27: ">Q"}[info]
+        (length,) = struct.unpack_from(fmt, data, offset)
+        offset += struct.calcsize(fmt)
+    else:
+        raise ValueError("indefinite length CBOR items are not supported")
+
+    if major == 0:
+        return length, offset
+    if major == 1:
+        return -1 - length, offset
+    if major == 2:
+        return bytes(data[offset : offset + length]), offset + length
+    if major == 3:
+        return data[offset : offset + length].decode("utf-8"), offset + length
+    if major == 4:
+        result = []
+        for _ in range(length):
+            item, offset = _cbor_decode(data, offset)
+            result.append(item)
+        return result, offset
+    if major == 5:
+        result = {}
+        for _ in range(length):
+            key, offset = _cbor_decode(data, offset)
+            result[key], offset = _cbor_decode(data, offset)
+        return result, offset
+    if major == 6:
+        # Tags carry no meaning for us, decode the tagged item.
+        return _cbor_decode(data, offset)
+    raise ValueError(f"unsupported CBOR major type {major}")
+
+
+CODECS = {
+    "msgpack": (msgpack_encode, msgpack_decode),
+    "cbor": (cbor_encode, cbor_decode),
+}
+
+# --------------------------------------------------------------------------------------------------------------------
+# Fake API state
+# --------------------------------------------------------------------------------------------------------------------
+
+
+class MockApi:
+    def __init__(self, args):
+        self.args = args
+        self.map = None
+        self.next_record_id = 1
+        # idempotency key -> record id, so resubmitted records are only stored once
+        self.submitted = {}
+        # (map id, filter id) -> list of records in API format
+        self.records = {}
+
+    def make_map(self, name):
+        if name not in self.args.approve_map:
+            return None
+        map_id = self.args.approve_map.index(name) + 1
+        return {
+            "id": map_id,
+            "workshop_id": 0,
+            "name": name,
+            "description": None,
+            "state": "approved",
+            "vpk_checksum": "",
+            "mappers": [{"id": 76561197960265728, "name": "mock"}],
+            "courses": [
+                {
+                    "id": map_id * 100 + 1,
+                    "name": "Main",
+                    "description": None,
+                    "mappers": [],
+                    "filters": {"64tick": {"id": map_id * 100 + 1, "tier": "easy", "state": "ranked", "notes": None}},
+                }
+            ],
+            "approved_at": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+        }
+
+    def hello_ack(self, hello, encoding):
+        self.map = self.make_map(hello.get("map", ""))
+        return {
+            "heartbeat_interval": self.args.heartbeat,
+            "encoding": encoding,
+            "map": self.map,
+            "modes": [{"mode": "64tick", "linux_checksum": "", "windows_checksum": ""}],
+            "styles": [{"style": "lowgrav", "linux_checksum": "", "windows_checksum": ""}],
+        }
+
+    def world_records(self):
+        if not self.map:
+            return []
+        result = []
+        for (map_id, _), records in self.records.items():
+            if map_id == self.map["id"] and records:
+                result.append(min(records, key=lambda record: record["time"]))
+        return result
+
+    def handle(self, event, data):
+        """Returns the `data` of the response, or None if the event has no response."""
+        if event == "map-change":
+            self.map = self.make_map(data.get("new_map", ""))
+            return {"map": self.map}
+        if event == "player-join":
+            return {"is_banned": False, "preferences": {}}
+        if event == "player-leave":
+            return None
+        if event == "new-record":
+            if not self.map:
+                return {"record_id": 0}
+            key = data.get("idempotency_key")
+            if key in self.submitted:
+                print(f"  duplicate submission {key}, returning record {self.submitted[key]}")
+                return {"record_id": self.submitted[key]}
+            course = self.map["courses"][0]
+            record = {
+                "id": self.next_record_id,
+                "player": {"id": data["player_id"], "name": str(data["player_id"])},
+                "map": {"id": self.map["id"], "name": self.map["name"]},
+                "course": {"id": course["id"], "name": course["name"]},
+                "mode": "64tick",
+                "time": data["time"],
+            }
+            self.next_record_id += 1
+            if key:
+                self.submitted[key] = record["id"]
+            self.records.setdefault((self.map["id"], data["filter_id"]), []).append(record)
+            return {"record_id": record["id"]}
+        if event == "want-world-records-for-cache":
+            return {"records": self.world_records()}
+        if event == "want-player-records":
+            return {"records": [r for r in self.world_records() if r["player"]["id"] == data.get("player_id")]}
+        if event == "want-course-top":
+            records = sorted((r for r in self.world_records()), key=lambda record: record["time"])
+            return {"map": None, "course": None, "overall": records[: data.get("limit", 10)]}
+        if event in ("want-world-records", "want-personal-best"):
+            records = self.world_records()
+            response = {"map": None, "course": None, "overall": records[0] if records else None}
+            if event == "want-personal-best":
+                response["player"] = None
+            return response
+        print(f"  unknown event `{event}`, not answering")
+        return None
+
+
+# --------------------------------------------------------------------------------------------------------------------
+# WebSocket connection
+# --------------------------------------------------------------------------------------------------------------------
+
+
+class Connection:
+    def __init__(self, reader, writer, api, args):
+        self.reader = reader
+        self.writer = writer
+        self.api = api
+        self.args = args
+        self.deflate = False
+        self.inflater = None
+        self.encoding = "json"
+
+    async def handshake(self):
+        request = await self.reader.readuntil(b"\r\n\r\n")
+        lines = request.decode("latin-1").split("\r\n")
+        headers = {}
+        for line in lines[1:]:
+            if ":" in line:
+                name, value = line.split(":", 1)
+                headers[name.strip().lower()] = value.strip()
+
+        print(f"< {lines[0]} (authorization: {headers.get('authorization', 'none')})")
+        accept = base64.b64encode(hashlib.sha1((headers["sec-websocket-key"] + WS_GUID).encode()).digest()).decode()
+        response = [
+            "HTTP/1.1 101 Switching Protocols",
+            "Upgrade: websocket",
+            "Connection: Upgrade",
+            f"Sec-WebSocket-Accept: {accept}",
+        ]
+        offered = headers.get("sec-websocket-extensions", "")
+        if not self.args.no_deflate and "permessage-deflate" in offered:
+            # We compress every message on its own, the client may keep its context since we keep ours.
+            response.append("Sec-WebSocket-Extensions: permessage-deflate; server_no_context_takeover")
+            self.deflate = True
+            self.inflater = zlib.decompressobj(-zlib.MAX_WBITS)
+        print(f"  permessage-deflate: {'on' if self.deflate else 'off'}")
+        self.writer.write(("\r\n".join(response) + "\r\n\r\n").encode())
+        await self.writer.drain()
+
+    async def read_frame(self):
+        head = await self.reader.readexactly(2)
+        fin, rsv1, opcode = head[0] & 0x80, head[0] & 0x40, head[0] & 0x0F
+        masked, length = head[1] & 0x80, head[1] & 0x7F
+        if length == 126:
+            (length,) = struct.unpack(">H", await self.reader.readexactly(2))
+        elif length == 127:
+            (length,) = struct.unpack(">Q", await self.reader.readexactly(8))
+        mask = await self.reader.readexactly(4) if masked else b"\0\0\0\0"
+        payload = bytearray(await self.reader.readexactly(length))
+        for i in range(length):
+            payload[i] ^= mask[i & 3]
+        return bool(fin), bool(rsv1), opcode, bytes(payload)
+
+    async def read_message(self):
+        """Returns (opcode, payload, wire size) of the next complete message."""
+        fin, compressed, opcode, payload = await self.read_frame()
+        wire_size = len(payload)
+        while not fin and opcode not in (OP_PING, OP_PONG, OP_CLOSE):
+            fin, _, continuation, more = await self.read_frame()
+            if continuation != OP_CONTINUATION:
+                raise ValueError("interleaved control frames inside fragmented messages are not supported")
+            payload += more
+            wire_size += len(more)
+        if compressed:
+            payload = self.inflater.decompress(payload + b"\x00\x00\xff\xff")
+        return opcode, payload, wire_size
+
+    async def send_frame(self, opcode, payload):
+        first = 0x80 | opcode
+        if self.deflate and opcode in (OP_TEXT, OP_BINARY):
+            compressor = zlib.compressobj(zlib.Z_DEFAULT_COMPRESSION, zlib.DEFLATED, -zlib.MAX_WBITS)
+            payload = compressor.compress(payload) + compressor.flush(zlib.Z_SYNC_FLUSH)
+            payload = payload[:-4]
+            first |= 0x40
+        header = bytearray((first,))
+        if len(payload) < 126:
+            header.append(len(payload))
+        elif len(payload) <= 0xFFFF:
+            header.append(126)
+            header += struct.pack(">H", len(payload))
+        else:
+            header.append(127)
+            header += struct.pack(">Q", len(payload))
+        self.writer.write(bytes(header) + payload)
+        await self.writer.drain()
+        return len(payload)
+
+    async def send(self, value, force_json=False):
+        if force_json or self.encoding == "json":
+            data = json.dumps(value).encode()
+            wire_size = await self.send_frame(OP_TEXT, data)
+        else:
+            data = CODECS[self.encoding][0](value)
+            wire_size = await self.send_frame(OP_BINARY, data)
+        print(f"> {len(data)} bytes ({wire_size} on the wire): {json.dumps(value)[:200]}")
+
+    def decode(self, opcode, payload):
+        if opcode == OP_TEXT:
+            return json.loads(payload)
+        if self.encoding == "json":
+            raise ValueError("binary message received before a binary encoding was negotiated")
+        return CODECS[self.encoding][1](payload)
+
+    def pick_encoding(self, offered):
+        if self.args.encoding == "auto":
+            for encoding in offered:
+                if encoding in CODECS or encoding == "json":
+                    return encoding
+            return "json"
+        if self.args.encoding in offered:
+            return self.args.encoding
+        print(f"  plugin did not offer `{self.args.encoding}`, using json")
+        return "json"
+
+    async def run(self):
+        await self.handshake()
+        hello_received = False
+        while True:
+            opcode, payload, wire_size = await self.read_message()
+            if opcode == OP_CLOSE:
+                print("< close")
+                await self.send_frame(OP_CLOSE, payload[:2])
+                return
+            if opcode == OP_PING:
+                await self.send_frame(OP_PONG, payload)
+                continue
+            if opcode == OP_PONG:
+                continue
+
+            message = self.decode(opcode, payload)
+            kind = "text" if opcode == OP_TEXT else self.encoding
+            print(f"< {len(payload)} bytes {kind} ({wire_size} on the wire): {json.dumps(message)[:200]}")
+
+            if not hello_received:
+                hello_received = True
+                encoding = self.pick_encoding(message.get("encodings", []))
+                # HelloAck is always JSON, everything after it uses the negotiated encoding.
+                await self.send(self.api.hello_ack(message, encoding), force_json=True)
+                self.encoding = encoding
+                print(f"  negotiated encoding: {encoding}")
+                continue
+
+            data = self.api.handle(message.get("event"), message.get("data", {}))
+            if data is not None:
+                await self.send({"id": message["id"], "data": data})
+
+
+async def serve(args):
+    api = MockApi(args)
+
+    async def on_connect(reader, writer):
+        peer = writer.get_extra_info("peername")
+        print(f"connection from {peer}")
+        try:
+            await Connection(reader, writer, api, args).run()
+        except (asyncio.IncompleteReadError, ConnectionError):
+            print(f"{peer} disconnected")
+        finally:
+            writer.close()
+
+    server = await asyncio.start_server(on_connect, args.host, args.port)
+    print(f"mock API listening on ws://{args.host}:{args.port}/auth/cs2 (encoding: {args.encoding})")
+    async with server:
+        await server.serve_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--encoding", choices=["auto", "json", "msgpack", "cbor"], default="auto")
+    parser.add_argument("--no-deflate", action="store_true", help="refuse permessage-deflate")
+    parser.add_argument("--heartbeat", type=float, default=30.0, help="heartbeat interval sent in HelloAck, in seconds")
+    parser.add_argument("--approve-map", action="append", default=[], help="treat this map as global, can be repeated")
+    args = parser.parse_args()
+    try:
+        asyncio.run(serve(args))
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -17,6 +17,7 @@
 #include "surf/goto/surf_goto.h"
 #include "surf/style/surf_style.h"
 #include "surf/quiet/surf_quiet.h"
+#include "surf/replays/surf_replays.h"
 #include "surf/tip/surf_tip.h"
 #include "surf/option/surf_option.h"
 #include "surf/language/surf_language.h"
@@ -59,6 +60,7 @@ bool SurfPlugin::Load(PluginId id, ISmmAPI *ismm, char *error, size_t maxlen, bo
 	SurfZoneBeamService::Init();
 	Surf::misc::Init();
 	SurfQuietService::Init();
+	SurfReplayService::Init();
 	if (!Surf::mode::CheckModeCvars())
 	{
 		return false;
@@ -97,6 +99,7 @@ bool SurfPlugin::Unload(char *error, size_t maxlen)
 	SurfGlobalService::Cleanup();
 	SurfLanguageService::Cleanup();
 	SurfOptionService::Cleanup();
+	SurfReplayService::Cleanup();
 	ConVar_Unregister();
 	return true;
 }
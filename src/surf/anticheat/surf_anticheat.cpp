@@ -35,8 +35,8 @@ static_function void ValidateCvar(CPlayerSlot nSlot, ECvarValueStatus eStatus, c
 	{
 		if (atof(pszCvarValue) > MAXIMUM_M_YAW)
 		{
-			player->languageService->PrintChat(true, false, "Kick Player m_yaw");
-			player->languageService->PrintConsole(false, false, "Kick Player m_yaw (Console)");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Kick Player m_yaw"));
+			player->languageService->PrintConsole(false, false, SURF_PHRASE("Kick Player m_yaw (Console)"));
 			player->anticheatService->MarkHasInvalidCvars();
 			player->timerService->TimerStop();
 			StartTimer<CPlayerUserId>(KickPlayerInvalidSettings, player->GetClient()->GetUserID(), KICK_DELAY, true, true);
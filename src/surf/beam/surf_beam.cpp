@@ -44,7 +44,7 @@ SCMD(surf_beam, SCFL_MISC | SCFL_PREFERENCE)
 		}
 		else
 		{
-			player->languageService->PrintChat(true, false, "Beam Command Usage");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Beam Command Usage"));
 			return MRES_HANDLED;
 		}
 	}
@@ -53,12 +53,12 @@ SCMD(surf_beam, SCFL_MISC | SCFL_PREFERENCE)
 	{
 		case SurfBeamService::BEAM_NONE:
 		{
-			player->languageService->PrintChat(true, false, "Beam Changed (None)");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Beam Changed (None)"));
 			break;
 		}
 		case SurfBeamService::BEAM_FEET:
 		{
-			player->languageService->PrintChat(true, false, "Beam Changed (Feet)");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Beam Changed (Feet)"));
 			break;
 		}
 	}
@@ -73,15 +73,15 @@ SCMD(surf_beamoffset, SCFL_MISC | SCFL_PREFERENCE)
 	SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(controller);
 	if (args->ArgC() < 4 || !utils::IsNumeric(args->Arg(1)) || !utils::IsNumeric(args->Arg(2)) || !utils::IsNumeric(args->Arg(3)))
 	{
-		player->languageService->PrintChat(true, false, "Beam Offset Command Usage");
-		player->languageService->PrintChat(true, false, "Current Beam Offset", player->beamService->playerBeamOffset.x,
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Beam Offset Command Usage"));
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Current Beam Offset"), player->beamService->playerBeamOffset.x,
 										   player->beamService->playerBeamOffset.y, player->beamService->playerBeamOffset.z);
 		return MRES_HANDLED;
 	}
 	player->beamService->playerBeamOffset = Vector(atof(args->Arg(1)), atof(args->Arg(2)), atof(args->Arg(3)));
 
 	player->optionService->SetPreferenceVector("beamOffset", player->beamService->playerBeamOffset);
-	player->languageService->PrintChat(true, false, "Current Beam Offset", player->beamService->playerBeamOffset.x,
+	player->languageService->PrintChat(true, false, SURF_PHRASE("Current Beam Offset"), player->beamService->playerBeamOffset.x,
 									   player->beamService->playerBeamOffset.y, player->beamService->playerBeamOffset.z);
 	return MRES_HANDLED;
 }
@@ -99,7 +99,7 @@ void SurfCheckpointService::SetCheckpoint()
 	this->checkpoints.AddToTail(cp);
 	// newest checkpoints aren't deleted after using prev cp.
 	this->currentCpIndex = this->checkpoints.Count() - 1;
-	this->player->languageService->PrintChat(true, false, "Make Checkpoint", this->GetCheckpointCount());
+	this->player->languageService->PrintChat(true, false, SURF_PHRASE("Make Checkpoint"), this->GetCheckpointCount());
 	this->PlayCheckpointSound();
 }
 
@@ -113,13 +113,13 @@ void SurfCheckpointService::UndoTeleport()
 
 	if (this->checkpoints.Count() <= 0 || this->undoTeleportData.origin.IsZero() || this->tpCount <= 0)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Undo (No Teleports)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Undo (No Teleports)"));
 		this->player->PlayErrorSound();
 		return;
 	}
 	if (!this->undoTeleportData.teleportOnGround)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Undo (TP Was Midair)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Undo (TP Was Midair)"));
 		this->player->PlayErrorSound();
 		return;
 	}
@@ -131,7 +131,7 @@ void SurfCheckpointService::DoTeleport(i32 index)
 {
 	if (this->checkpoints.Count() <= 0)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Teleport (No Checkpoints)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Teleport (No Checkpoints)"));
 		this->player->PlayErrorSound();
 		return;
 	}
@@ -143,7 +143,7 @@ void SurfCheckpointService::DoTeleport(i32 index)
 			return;
 		}
 	}
-	this->player->languageService->PrintChat(true, false, "Can't Teleport (Not TAS)");
+	this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Teleport (Not TAS)"));
 }
 
 void SurfCheckpointService::DoTeleport(const Checkpoint cp)
@@ -241,7 +241,7 @@ void SurfCheckpointService::TpToPrevCp()
 {
 	if (this->checkpoints.Count() <= 0)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Teleport (No Checkpoints)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Teleport (No Checkpoints)"));
 		this->player->PlayErrorSound();
 		return;
 	}
@@ -253,7 +253,7 @@ void SurfCheckpointService::TpToNextCp()
 {
 	if (this->checkpoints.Count() <= 0)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Teleport (No Checkpoints)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Teleport (No Checkpoints)"));
 		this->player->PlayErrorSound();
 		return;
 	}
@@ -320,13 +320,13 @@ void SurfCheckpointService::SetStartPosition()
 	CCSPlayerPawn *pawn = this->player->GetPlayerPawn();
 	if (!pawn)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Set Custom Start Position (Generic)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Set Custom Start Position (Generic)"));
 		this->player->PlayErrorSound();
 		return;
 	}
 	if (!this->player->timerService->InStartzone())
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Set Custom Start Position (Generic)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Set Custom Start Position (Generic)"));
 		this->player->PlayErrorSound();
 		return;
 	}
@@ -357,7 +357,7 @@ void SurfCheckpointService::SetStartPosition()
 			player->optionService->SetPreferenceTable("startPositions", ssps);
 		}
 	}
-	this->player->languageService->PrintChat(true, false, "Set Custom Start Position");
+	this->player->languageService->PrintChat(true, false, SURF_PHRASE("Set Custom Start Position"));
 }
 
 void SurfCheckpointService::ClearStartPosition()
@@ -377,7 +377,7 @@ void SurfCheckpointService::ClearStartPosition()
 		}
 	}
 
-	this->player->languageService->PrintChat(true, false, "Cleared Custom Start Position");
+	this->player->languageService->PrintChat(true, false, SURF_PHRASE("Cleared Custom Start Position"));
 }
 
 void SurfCheckpointService::TpToStartPosition()
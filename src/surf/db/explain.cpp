@@ -0,0 +1,143 @@
+#include "surf_db.h"
+#include "statement.h"
+#include "queries/course_top.h"
+#include "queries/courses.h"
+#include "queries/maps.h"
+#include "queries/modes.h"
+#include "queries/personal_best.h"
+#include "queries/players.h"
+#include "queries/save_time.h"
+#include "queries/styles.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include <algorithm>
+
+#include "tier0/memdbgon.h"
+
+/*
+	surf_db_explain: print the query plan of every read query the plugin sends, to check that none of them scans a whole table.
+*/
+
+using namespace Surf::Database;
+
+struct CannedQuery
+{
+	const char *name;
+	const char *sqlTemplate;
+	// Queries with a list of players are explained with a single player, bound between the two halves.
+	const char *sqlTemplateEnd;
+};
+
+#define CANNED_QUERY(query)                  {#query, query, nullptr}
+#define CANNED_PLAYER_LIST_QUERY(query, end) {#query, query, end}
+
+// clang-format off
+static_global const CannedQuery cannedQueries[] =
+{
+	CANNED_QUERY(sql_getpb),
+	CANNED_QUERY(sql_getmaprank),
+	CANNED_QUERY(sql_getlowestmaprank),
+	CANNED_PLAYER_LIST_QUERY(sql_getpbs, sql_getpbs_end),
+	CANNED_QUERY(sql_getcoursetop),
+	CANNED_QUERY(sql_getsrs),
+	CANNED_QUERY(sql_getleaderboards),
+	CANNED_QUERY(sql_savetime_getpb),
+	CANNED_QUERY(sql_savetime_getmaprank),
+	CANNED_QUERY(sql_savetime_getlowestmaprank),
+	CANNED_QUERY(sql_mapcourses_findall),
+	CANNED_QUERY(sql_mapcourses_findfirst_mapname),
+	CANNED_QUERY(sql_maps_findid),
+	CANNED_QUERY(sql_modes_fetch_all),
+	CANNED_QUERY(sql_modes_findid),
+	CANNED_QUERY(sql_styles_fetch_all),
+	CANNED_QUERY(sql_styles_findid),
+	CANNED_QUERY(sql_players_get_infos),
+	CANNED_QUERY(sql_players_searchbyalias),
+};
+
+// clang-format on
+
+static_function const char *Explain_GetString(ISQLResult *result, i32 column)
+{
+	const char *value = result->GetString(column);
+	return value ? value : "NULL";
+}
+
+// Prints the plan of one query, returns how many steps go through a whole table.
+static_function u32 Explain_PrintPlan(ISQLResult *result, bool mysql)
+{
+	u32 fullScans = 0;
+	// SQLite lists subqueries it evaluated on its own as SCAN too, those only hold the rows the subquery kept.
+	std::vector<std::string> subqueries;
+	while (result && result->FetchRow())
+	{
+		bool fullScan = false;
+		if (mysql)
+		{
+			// id, select_type, table, partitions, type, possible_keys, key, key_len, ref, rows, filtered, Extra
+			const char *type = Explain_GetString(result, 4);
+			fullScan = SURF_STREQ(type, "ALL") || SURF_STREQ(type, "index");
+			META_CONPRINTF("    %s: %s, key %s, ~%s rows, %s%s\n", Explain_GetString(result, 2), type, Explain_GetString(result, 6),
+						   Explain_GetString(result, 9), Explain_GetString(result, 11), fullScan ? " <-- full scan" : "");
+		}
+		else
+		{
+			// id, parent, notused, detail
+			const char *detail = Explain_GetString(result, 3);
+			if (V_strncmp(detail, "MATERIALIZE ", 12) == 0 || V_strncmp(detail, "CO-ROUTINE ", 11) == 0)
+			{
+				subqueries.emplace_back(V_strstr(detail, " ") + 1);
+			}
+			else if (V_strncmp(detail, "SCAN ", 5) == 0 && !V_strstr(detail, "CONSTANT ROW"))
+			{
+				std::string table(detail + 5, strcspn(detail + 5, " "));
+				fullScan = std::find(subqueries.begin(), subqueries.end(), table) == subqueries.end();
+			}
+			META_CONPRINTF("    %s%s\n", detail, fullScan ? " <-- full scan" : "");
+		}
+		fullScans += fullScan;
+	}
+	return fullScans;
+}
+
+CON_COMMAND_F(surf_db_explain, "Print the query plans of the local database queries.", FCVAR_NONE)
+{
+	if (!SurfDatabaseService::IsReady())
+	{
+		META_CONPRINTF("[Surf::DB] The local database isn't ready.\n");
+		return;
+	}
+	bool mysql = SurfDatabaseService::GetDatabaseType() == DatabaseType::MySQL;
+	CUtlString mapName = g_pSurfUtils->GetCurrentMapName();
+	i64 exampleID = MAX(SurfDatabaseService::GetMapID(), 1);
+
+	Transaction txn;
+	for (const CannedQuery &query : cannedQueries)
+	{
+		std::string statement = mysql ? "EXPLAIN " : "EXPLAIN QUERY PLAN ";
+		statement += BindStatementExample(query.sqlTemplate, exampleID, 1.0, mapName.Get());
+		if (query.sqlTemplateEnd)
+		{
+			statement += std::to_string(exampleID);
+			statement += BindStatementExample(query.sqlTemplateEnd, exampleID, 1.0, mapName.Get());
+		}
+		txn.queries.push_back(std::move(statement));
+	}
+
+	auto onSuccess = [mysql](std::vector<ISQLQuery *> queries)
+	{
+		u32 fullScans = 0;
+		for (u32 i = 0; i < queries.size(); i++)
+		{
+			META_CONPRINTF("[Surf::DB] %s\n", cannedQueries[i].name);
+			fullScans += Explain_PrintPlan(queries[i]->GetResultSet(), mysql);
+		}
+		META_CONPRINTF("[Surf::DB] %u queries, %u full scans.\n", (u32)queries.size(), fullScans);
+	};
+	auto onFailure = [](std::string error, int failIndex)
+	{
+		const char *name = failIndex >= 0 && failIndex < (int)SURF_ARRAYSIZE(cannedQueries) ? cannedQueries[failIndex].name : "?";
+		META_CONPRINTF("[Surf::DB] Failed to explain %s (%s).\n", name, error.c_str());
+	};
+	SurfDatabaseService::ExecuteTransaction("surf_db_explain", txn, onSuccess, onFailure);
+}
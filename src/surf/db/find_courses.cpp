@@ -1,17 +1,13 @@
 #include "surf_db.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
+#include "statement.h"
 #include "queries/courses.h"
 
 void SurfDatabaseService::FindFirstCourseByMapName(CUtlString mapName, TransactionSuccessCallbackFunc onSuccess,
 												   TransactionFailureCallbackFunc onFailure)
 {
-	auto cleanMapName = SurfDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
-	char query[1024];
-	V_snprintf(query, sizeof(query), sql_mapcourses_findfirst_mapname, cleanMapName.c_str(), cleanMapName.c_str());
-
 	Transaction txn;
-	txn.queries.push_back(query);
+	txn.queries.push_back(Surf::Database::BindStatement(sql_mapcourses_findfirst_mapname, mapName, mapName));
 
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	SurfDatabaseService::ExecuteTransaction("sql_mapcourses_findfirst_mapname", txn, onSuccess, onFailure);
 }
@@ -1,58 +1,51 @@
 #include "surf_db.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
+#include "statement.h"
 #include "queries/personal_best.h"
 
+using namespace Surf::Database;
+
 void SurfDatabaseService::QueryPB(u64 steamID64, CUtlString mapName, CUtlString courseName, u32 modeID, TransactionSuccessCallbackFunc onSuccess,
 								  TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = SurfDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-	std::string cleanedCourseName = SurfDatabaseService::GetDatabaseConnection()->Escape(courseName.Get());
-
 	Transaction txn;
 
-	char query[1024];
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getpb, steamID64, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, 0ull, 1);
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_getpb, steamID64, mapName, courseName, modeID, 0ull, 1));
 
 	// Get Rank
-	V_snprintf(query, sizeof(query), sql_getmaprank, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, steamID64, cleanedMapName.c_str(),
-			   cleanedCourseName.c_str(), modeID);
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_getmaprank, mapName, courseName, modeID, steamID64, mapName, courseName, modeID));
 
 	// Get Number of Players with Times
-	V_snprintf(query, sizeof(query), sql_getlowestmaprank, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID);
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_getlowestmaprank, mapName, courseName, modeID));
 
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	SurfDatabaseService::ExecuteTransaction("sql_getmaprank", txn, onSuccess, onFailure);
 }
 
 void SurfDatabaseService::QueryPBRankless(u64 steamID64, CUtlString mapName, CUtlString courseName, u32 modeID, u64 styleIDFlags,
 										  TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = SurfDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
-	std::string cleanedCourseName = SurfDatabaseService::GetDatabaseConnection()->Escape(courseName.Get());
-
-	char query[1024];
 	Transaction txn;
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getpb, steamID64, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, styleIDFlags, 1);
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_getpb, steamID64, mapName, courseName, modeID, styleIDFlags, 1));
 
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	SurfDatabaseService::ExecuteTransaction("sql_getpb", txn, onSuccess, onFailure);
 }
 
-void SurfDatabaseService::QueryAllPBs(u64 steamID64, CUtlString mapName, TransactionSuccessCallbackFunc onSuccess,
+void SurfDatabaseService::QueryAllPBs(const std::vector<u64> &steamID64s, CUtlString mapName, TransactionSuccessCallbackFunc onSuccess,
 									  TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = SurfDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
 	Transaction txn;
 
-	char query[1024];
-	// Get PB
-	V_snprintf(query, sizeof(query), sql_getpbs, steamID64, cleanedMapName.c_str());
-	txn.queries.push_back(query);
-
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	// Get the PBs of every player in one go
+	std::string query = BindStatement(sql_getpbs, mapName);
+	for (u32 i = 0; i < steamID64s.size(); i++)
+	{
+		query += i == 0 ? "" : ", ";
+		query += BindStatement(sql_getpbs_player, steamID64s[i]);
+	}
+	query += BindStatement(sql_getpbs_end);
+	txn.queries.push_back(std::move(query));
+
+	SurfDatabaseService::ExecuteTransaction("sql_getpbs", txn, onSuccess, onFailure);
 }
@@ -1,6 +1,7 @@
 #include "surf_db.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
+#include "statement.h"
 #include "queries/players.h"
 
 void SurfDatabaseService::FindPlayerByAlias(CUtlString playerName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
@@ -11,12 +12,9 @@ void SurfDatabaseService::FindPlayerByAlias(CUtlString playerName, TransactionSu
 	}
 
 	Transaction txn;
-	char query[1024];
 
 	// Get player's steamID through their alias.
-	std::string cleanedPlayerName = SurfDatabaseService::GetDatabaseConnection()->Escape(playerName.Get());
-	V_snprintf(query, sizeof(query), sql_players_searchbyalias, cleanedPlayerName.c_str(), cleanedPlayerName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Surf::Database::BindStatement(sql_players_searchbyalias, playerName, playerName));
 
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	SurfDatabaseService::ExecuteTransaction("sql_players_searchbyalias", txn, onSuccess, onFailure);
 }
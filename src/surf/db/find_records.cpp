@@ -1,33 +1,35 @@
 #include "surf_db.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
+#include "statement.h"
 #include "queries/course_top.h"
 
 void SurfDatabaseService::QueryAllRecords(CUtlString mapName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = SurfDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
 	Transaction txn;
 
-	char query[1024];
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getsrs, cleanedMapName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Surf::Database::BindStatement(sql_getsrs, mapName));
 
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	SurfDatabaseService::ExecuteTransaction("sql_getsrs", txn, onSuccess, onFailure);
 }
 
 void SurfDatabaseService::QueryRecords(CUtlString mapName, CUtlString courseName, u32 modeID, u32 count, u32 offset,
 									   TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = SurfDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-	std::string cleanedCourseName = SurfDatabaseService::GetDatabaseConnection()->Escape(courseName.Get());
-
 	Transaction txn;
 
-	char query[1024];
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getcoursetop, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, count, offset);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Surf::Database::BindStatement(sql_getcoursetop, mapName, courseName, modeID, count, offset));
+
+	SurfDatabaseService::ExecuteTransaction("sql_getcoursetop", txn, onSuccess, onFailure);
+}
+
+void SurfDatabaseService::QueryMapLeaderboards(i32 mapID, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
+{
+	Transaction txn;
+
+	// Get every PB of the map
+	txn.queries.push_back(Surf::Database::BindStatement(sql_getleaderboards, mapID));
 
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	SurfDatabaseService::ExecuteTransaction("sql_getleaderboards", txn, onSuccess, onFailure);
 }
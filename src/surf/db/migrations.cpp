@@ -4,6 +4,7 @@
 #include <regex>
 #include "checksum_crc.h"
 
+#include "statement.h"
 #include "queries/migrations.h"
 #include "queries/courses.h"
 #include "queries/maps.h"
@@ -39,6 +40,11 @@ static_global const std::string mysqlMigrations[] =
 	trimString(mysql_mapcourses_create),
 	trimString(mysql_times_create),
 	trimString(mysql_startpos_create),
+	trimString(mysql_pbs_create),
+	trimString(sql_pbs_backfill),
+	trimString(mysql_times_create_course_index),
+	trimString(mysql_times_create_player_index),
+	trimString(sql_times_add_splits),
 };
 
 static_global const std::string sqliteMigrations[] = 
@@ -50,6 +56,12 @@ static_global const std::string sqliteMigrations[] =
 	trimString(sqlite_mapcourses_create),
 	trimString(sqlite_times_create),
 	trimString(sqlite_startpos_create),
+	trimString(sqlite_pbs_create),
+	trimString(sqlite_pbs_create_leaderboard_index),
+	trimString(sql_pbs_backfill),
+	trimString(sqlite_times_create_course_index),
+	trimString(sqlite_times_create_player_index),
+	trimString(sql_times_add_splits),
 };
 
 // clang-format on
@@ -72,7 +84,7 @@ void SurfDatabaseService::RunMigrations()
 	}
 	txn.queries.push_back(sql_migrations_fetchall);
 
-	GetDatabaseConnection()->ExecuteTransaction(txn, SurfDatabaseService::CheckMigrations, OnGenericTxnFailure);
+	ExecuteTransaction("sql_migrations_fetchall", txn, SurfDatabaseService::CheckMigrations, OnGenericTxnFailure);
 }
 
 void SurfDatabaseService::CheckMigrations(std::vector<ISQLQuery *> queries)
@@ -156,7 +168,6 @@ void SurfDatabaseService::CheckMigrations(std::vector<ISQLQuery *> queries)
 	}
 
 	Transaction txn;
-	char query[1024];
 	for (u32 i = current; i < max; i++)
 	{
 		switch (SurfDatabaseService::GetDatabaseType())
@@ -164,23 +175,22 @@ void SurfDatabaseService::CheckMigrations(std::vector<ISQLQuery *> queries)
 			case DatabaseType::MySQL:
 			{
 				txn.queries.push_back(mysqlMigrations[i]);
-				V_snprintf(query, sizeof(query), sql_migrations_insert,
-						   CRC32_ProcessSingleBuffer(mysqlMigrations[i].c_str(), mysqlMigrations[i].length()));
+				txn.queries.push_back(
+					BindStatement(sql_migrations_insert, CRC32_ProcessSingleBuffer(mysqlMigrations[i].c_str(), mysqlMigrations[i].length())));
 				break;
 			}
 			case DatabaseType::SQLite:
 			{
 				txn.queries.push_back(sqliteMigrations[i]);
-				V_snprintf(query, sizeof(query), sql_migrations_insert,
-						   CRC32_ProcessSingleBuffer(sqliteMigrations[i].c_str(), sqliteMigrations[i].length()));
+				txn.queries.push_back(
+					BindStatement(sql_migrations_insert, CRC32_ProcessSingleBuffer(sqliteMigrations[i].c_str(), sqliteMigrations[i].length())));
 				break;
 			}
 		}
-		txn.queries.push_back(query);
 	}
 
-	GetDatabaseConnection()->ExecuteTransaction(
-		txn, [onSuccess](std::vector<ISQLQuery *> queries) { onSuccess(); }, [onFailure](std::string error, int failIndex) { onFailure(); });
+	ExecuteTransaction(
+		"migrations", txn, [onSuccess](std::vector<ISQLQuery *> queries) { onSuccess(); }, [onFailure](std::string error, int failIndex) { onFailure(); });
 }
 
 bool SurfDatabaseService::IsReady()
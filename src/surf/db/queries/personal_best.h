@@ -1,59 +1,61 @@
 
 constexpr char sql_getpb[] = R"(
-    SELECT Times.RunTime
-        FROM Times
-        INNER JOIN MapCourses ON Times.MapCourseID = MapCourses.ID
+    SELECT PersonalBests.RunTime
+        FROM PersonalBests
+        INNER JOIN MapCourses ON PersonalBests.MapCourseID = MapCourses.ID
         INNER JOIN Maps ON MapCourses.MapID = Maps.ID
-        WHERE Times.SteamID64=%llu 
+        WHERE PersonalBests.SteamID64=%llu 
         AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=%llu
-        ORDER BY Times.RunTime 
+        AND PersonalBests.ModeID=%d AND PersonalBests.StyleIDFlags=%llu
         LIMIT %d
 )";
 
 // The following queries should have no style!
 
 constexpr char sql_getmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) + 1
+        FROM PersonalBests pb
+        INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
         WHERE Players.Cheater=0 AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.RunTime < 
-            (SELECT MIN(Times.RunTime) 
-            FROM Times 
-            INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.RunTime < 
+            (SELECT own.RunTime 
+            FROM PersonalBests own 
+            INNER JOIN MapCourses ON MapCourses.ID=own.MapCourseID 
             INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-            INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-            WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Maps.Name='%s'
-            AND MapCourses.Name='%s' AND Times.ModeID=%d AND Times.StyleIDFlags=0) 
-    + 1
+            WHERE own.SteamID64=%llu AND Maps.Name='%s'
+            AND MapCourses.Name='%s' AND own.ModeID=%d AND own.StyleIDFlags=0)
 )";
 
 constexpr char sql_getlowestmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) 
+        FROM PersonalBests pb
+        INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
         WHERE Players.Cheater=0 AND Maps.Name='%s' 
-        AND MapCourses.Name='%s' AND Times.ModeID=%d 
-        AND Times.StyleIDFlags=0 AND Times.StyleIDFlags=0
+        AND MapCourses.Name='%s' AND pb.ModeID=%d 
+        AND pb.StyleIDFlags=0
 )";
 
-// Caching PBs
+// Caching PBs of several players at once: sql_getpbs, then one sql_getpbs_player per player separated by commas, then sql_getpbs_end.
 
 constexpr char sql_getpbs[] = R"(
-    SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
-        INNER JOIN Maps m ON m.ID = mc.MapID
-        INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
+    SELECT x.SteamID64, x.RunTime, x.MapCourseID, x.ModeID, COALESCE(t.Splits, t.Metadata)
+        FROM (
+            SELECT t.SteamID64, MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
                 FROM Times t
-                WHERE t.SteamID64=%llu
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s'
+                INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
+                INNER JOIN Maps m ON m.ID = mc.MapID
+                WHERE m.Name = '%s' AND t.SteamID64 IN (
+)";
+
+constexpr char sql_getpbs_player[] = "%llu";
+
+constexpr char sql_getpbs_end[] = R"(
+                )
+                GROUP BY t.SteamID64, t.MapCourseID, t.ModeID
+        ) x
+        INNER JOIN Times t ON t.SteamID64 = x.SteamID64 AND t.MapCourseID = x.MapCourseID AND t.ModeID = x.ModeID AND t.RunTime = x.RunTime
 )";
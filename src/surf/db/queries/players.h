@@ -50,10 +50,25 @@ constexpr char sql_players_get_infos[] = R"(
         WHERE SteamID64=%lld
 )";
 
+// Multi-row upsert, followed by one sql_players_set_prefs_row per player and the conflict clause of the driver.
+// Only used for players that were already set up, but it inserts a bare row without alias or IP if the player is missing.
 constexpr char sql_players_set_prefs[] = R"(
-    UPDATE Players 
-        SET Preferences='%s'
-        WHERE SteamID64=%lld
+    INSERT INTO Players (SteamID64, Preferences) 
+        VALUES
+)";
+
+constexpr char sql_players_set_prefs_row[] = R"(
+    (%llu, '%s')
+)";
+
+constexpr char sqlite_players_set_prefs_conflict[] = R"(
+    ON CONFLICT(SteamID64) DO UPDATE SET 
+        Preferences = excluded.Preferences
+)";
+
+constexpr char mysql_players_set_prefs_conflict[] = R"(
+    ON DUPLICATE KEY UPDATE 
+        Preferences = VALUES(Preferences)
 )";
 
 constexpr char sql_players_set_cheater[] = R"(
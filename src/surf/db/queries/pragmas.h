@@ -0,0 +1,24 @@
+// =====[ SQLITE PRAGMAS ]=====
+
+// Pragmas can't be changed inside a transaction, these are sent as single queries.
+// Text values are checked against the values SQLite accepts before they are bound.
+
+constexpr char sqlite_pragma_journal_mode[] = R"(
+    PRAGMA journal_mode=%s
+)";
+
+constexpr char sqlite_pragma_synchronous[] = R"(
+    PRAGMA synchronous=%s
+)";
+
+constexpr char sqlite_pragma_cache_size[] = R"(
+    PRAGMA cache_size=%lld
+)";
+
+constexpr char sqlite_pragma_mmap_size[] = R"(
+    PRAGMA mmap_size=%lld
+)";
+
+constexpr char sqlite_pragma_temp_store[] = R"(
+    PRAGMA temp_store=%s
+)";
@@ -1,35 +1,30 @@
 // =====[ GENERAL ]=====
 
-constexpr char sql_getpb[] = R"(
-    SELECT Times.RunTime
-        FROM Times 
-        WHERE Times.MapCourseID=%d
-        AND Times.SteamID64=%llu
-        AND Times.ModeID=%d AND Times.StyleIDFlags=%llu
-        ORDER BY Times.RunTime 
-        LIMIT %d
+constexpr char sql_savetime_getpb[] = R"(
+    SELECT RunTime, TimeID
+        FROM PersonalBests 
+        WHERE SteamID64=%llu AND MapCourseID=%d
+        AND ModeID=%d AND StyleIDFlags=%llu
 )";
 
 // The following queries should have no style!
 
-constexpr char sql_getmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.RunTime < 
-        (SELECT MIN(Times.RunTime) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0) 
-    + 1
+constexpr char sql_savetime_getmaprank[] = R"(
+    SELECT COUNT(*) + 1
+        FROM PersonalBests 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND PersonalBests.MapCourseID=%d
+        AND PersonalBests.ModeID=%d AND PersonalBests.StyleIDFlags=0 AND PersonalBests.RunTime < 
+        (SELECT RunTime 
+        FROM PersonalBests 
+        WHERE SteamID64=%llu AND MapCourseID=%d
+        AND ModeID=%d AND StyleIDFlags=0)
 )";
 
-constexpr char sql_getlowestmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0
+constexpr char sql_savetime_getlowestmaprank[] = R"(
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND PersonalBests.MapCourseID=%d
+        AND PersonalBests.ModeID=%d AND PersonalBests.StyleIDFlags=0
 )";
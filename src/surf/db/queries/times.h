@@ -39,12 +39,135 @@ constexpr char mysql_times_create[] = R"(
         ON UPDATE CASCADE ON DELETE CASCADE)
 )";
 
+// Multi-row insert, followed by one sql_times_insert_row per run separated by commas.
 constexpr char sql_times_insert[] = R"(
-    INSERT INTO Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Metadata) 
-        VALUES (%llu, %d, %d, %llu, %.7f, '%s')
+    INSERT INTO Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Splits) 
+        VALUES
+)";
+
+constexpr char sql_times_insert_row[] = R"(
+    (%llu, %d, %d, %llu, %.7f, '%s')
+)";
+
+// Split times of new runs, Metadata is only filled for runs saved before this column existed.
+constexpr char sql_times_add_splits[] = R"(
+    ALTER TABLE Times ADD COLUMN Splits TEXT
 )";
 
 constexpr char sql_times_delete[] = R"(
     DELETE FROM Times 
         WHERE ID=%d
 )";
+
+// Records and course lookups, RunTime comes right after the filtered columns so the fastest run is the first entry of the range.
+constexpr char sqlite_times_create_course_index[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Times_Course 
+        ON Times (MapCourseID, ModeID, StyleIDFlags, RunTime, SteamID64)
+)";
+
+// Lookups of a single player's runs.
+constexpr char sqlite_times_create_player_index[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Times_Player 
+        ON Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime)
+)";
+
+constexpr char mysql_times_create_course_index[] = R"(
+    CREATE INDEX IX_Times_Course 
+        ON Times (MapCourseID, ModeID, StyleIDFlags, RunTime, SteamID64)
+)";
+
+constexpr char mysql_times_create_player_index[] = R"(
+    CREATE INDEX IX_Times_Player 
+        ON Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime)
+)";
+
+// =====[ PERSONAL BESTS ]=====
+
+// Best time of every player on every course, mode and style combination, kept up to date by SaveTime.
+// Ranks and leaderboards are read from here instead of aggregating Times.
+
+constexpr char sqlite_pbs_create[] = R"(
+    CREATE TABLE IF NOT EXISTS PersonalBests ( 
+        SteamID64 INTEGER NOT NULL, 
+        MapCourseID INTEGER NOT NULL, 
+        ModeID INTEGER NOT NULL, 
+        StyleIDFlags INTEGER NOT NULL, 
+        TimeID INTEGER NOT NULL, 
+        RunTime REAL NOT NULL, 
+        CONSTRAINT PK_PersonalBests PRIMARY KEY (SteamID64, MapCourseID, ModeID, StyleIDFlags), 
+        CONSTRAINT FK_PersonalBests_SteamID64 FOREIGN KEY (SteamID64) REFERENCES Players(SteamID64) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_MapCourseID FOREIGN KEY (MapCourseID) REFERENCES MapCourses(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_Mode FOREIGN KEY (ModeID) REFERENCES Modes(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE)
+)";
+
+// SQLite's counterpart of IX_PersonalBests_Rank. SQLite doesn't add the primary key to secondary indexes, so SteamID64 and TimeID
+// are part of it to let rank and leaderboard queries join Players and read the run without going back to the table.
+constexpr char sqlite_pbs_create_leaderboard_index[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_PersonalBests_Leaderboard 
+        ON PersonalBests (MapCourseID, ModeID, StyleIDFlags, RunTime, SteamID64, TimeID)
+)";
+
+constexpr char mysql_pbs_create[] = R"(
+    CREATE TABLE IF NOT EXISTS PersonalBests ( 
+        SteamID64 BIGINT UNSIGNED NOT NULL, 
+        MapCourseID INTEGER UNSIGNED NOT NULL, 
+        ModeID INTEGER UNSIGNED NOT NULL, 
+        StyleIDFlags INTEGER UNSIGNED NOT NULL, 
+        TimeID INTEGER UNSIGNED NOT NULL, 
+        RunTime DOUBLE UNSIGNED NOT NULL, 
+        CONSTRAINT PK_PersonalBests PRIMARY KEY (SteamID64, MapCourseID, ModeID, StyleIDFlags), 
+        INDEX IX_PersonalBests_Rank (MapCourseID, ModeID, StyleIDFlags, RunTime), 
+        CONSTRAINT FK_PersonalBests_SteamID64 FOREIGN KEY (SteamID64) REFERENCES Players(SteamID64) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_MapCourseID FOREIGN KEY (MapCourseID) REFERENCES MapCourses(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_Mode FOREIGN KEY (ModeID) REFERENCES Modes(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE)
+)";
+
+// Fills the table from the times that were saved before it existed. Ties go to the oldest run.
+constexpr char sql_pbs_backfill[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, TimeID, RunTime) 
+        SELECT t.SteamID64, t.MapCourseID, t.ModeID, t.StyleIDFlags, MIN(t.ID), t.RunTime 
+        FROM Times t 
+        INNER JOIN ( 
+            SELECT SteamID64, MapCourseID, ModeID, StyleIDFlags, MIN(RunTime) AS RunTime 
+                FROM Times 
+                GROUP BY SteamID64, MapCourseID, ModeID, StyleIDFlags 
+        ) x ON x.SteamID64 = t.SteamID64 AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID 
+        AND x.StyleIDFlags = t.StyleIDFlags AND x.RunTime = t.RunTime 
+        GROUP BY t.SteamID64, t.MapCourseID, t.ModeID, t.StyleIDFlags, t.RunTime
+)";
+
+// Multi-row upsert that must directly follow a sql_times_insert of the same runs in the same transaction, followed by one row per run
+// and the conflict clause of the driver. Rows are numbered in insert order, the IDs of a multi-row insert are consecutive.
+constexpr char sql_pbs_upsert[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, TimeID, RunTime) 
+        VALUES
+)";
+
+// The last inserted run has the highest ID, the number is how many runs were inserted after this one.
+constexpr char sqlite_pbs_upsert_row[] = R"(
+    (%llu, %d, %d, %llu, (SELECT MAX(ID) FROM Times) - %d, %.7f)
+)";
+
+constexpr char sqlite_pbs_upsert_conflict[] = R"(
+    ON CONFLICT(SteamID64, MapCourseID, ModeID, StyleIDFlags) DO UPDATE SET 
+        TimeID = excluded.TimeID, RunTime = excluded.RunTime 
+        WHERE excluded.RunTime < PersonalBests.RunTime
+)";
+
+// LAST_INSERT_ID() is the ID of the first run of a multi-row insert, the number is how many runs were inserted before this one.
+constexpr char mysql_pbs_upsert_row[] = R"(
+    (%llu, %d, %d, %llu, LAST_INSERT_ID() + %d * @@auto_increment_increment, %.7f)
+)";
+
+// TimeID is assigned first so it still compares against the old RunTime.
+constexpr char mysql_pbs_upsert_conflict[] = R"(
+    ON DUPLICATE KEY UPDATE 
+        TimeID = IF(VALUES(RunTime) < RunTime, VALUES(TimeID), TimeID), 
+        RunTime = LEAST(RunTime, VALUES(RunTime))
+)";
@@ -1,9 +1,5 @@
 #include "surf_db.h"
-#include "surf/option/surf_option.h"
-
-#include "vendor/sql_mm/src/public/sql_mm.h"
-
-#include "queries/players.h"
+#include "write_queue.h"
 
 void SurfDatabaseService::SavePrefs(CUtlString prefs)
 {
@@ -11,15 +7,5 @@ void SurfDatabaseService::SavePrefs(CUtlString prefs)
 	{
 		return;
 	}
-	u64 steamID64 = this->player->GetSteamId64();
-	std::string cleanedPrefs = SurfDatabaseService::GetDatabaseConnection()->Escape(prefs);
-
-	Transaction txn;
-
-	CUtlString query;
-	query.Format(sql_players_set_prefs, prefs.Get(), steamID64);
-
-	txn.queries.push_back(query.Get());
-
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, OnGenericTxnSuccess, OnGenericTxnFailure);
+	Surf::Database::QueuePrefs(this->player->GetSteamId64(), prefs);
 }
@@ -1,14 +1,9 @@
 #include "surf_db.h"
-#include "surf/mode/surf_mode.h"
-#include "surf/style/surf_style.h"
-#include "surf/timer/surf_timer.h"
-#include "queries/save_time.h"
-#include "queries/times.h"
-#include "vendor/sql_mm/src/public/sql_mm.h"
+#include "write_queue.h"
 
 using namespace Surf::Database;
 
-void SurfDatabaseService::SaveTime(u64 steamID, u32 courseID, i32 modeID, f64 time, u64 styleIDs, std::string_view metadata,
+void SurfDatabaseService::SaveTime(u64 steamID, u32 courseID, i32 modeID, f64 time, u64 styleIDs, std::string_view splits, bool queryRanks,
 								   TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
 	if (!SurfDatabaseService::IsReady())
@@ -16,26 +11,14 @@ void SurfDatabaseService::SaveTime(u64 steamID, u32 courseID, i32 modeID, f64 ti
 		return;
 	}
 
-	char query[1024];
-	Transaction txn;
-	V_snprintf(query, sizeof(query), sql_times_insert, steamID, courseID, modeID, styleIDs, time, metadata.data());
-	txn.queries.push_back(query);
-	if (styleIDs != 0)
+	QueuedTime run {steamID, courseID, modeID, time, styleIDs, std::string(splits)};
+	// Runs with styles don't have a rank, nobody waits for their results.
+	if (styleIDs == 0)
 	{
-		SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, OnGenericTxnSuccess, OnGenericTxnFailure);
-	}
-	else
-	{
-		// Get Top 2 PBs
-		V_snprintf(query, sizeof(query), sql_getpb, courseID, steamID, modeID, styleIDs, 2);
-		txn.queries.push_back(query);
-		// Get Rank
-		V_snprintf(query, sizeof(query), sql_getmaprank, courseID, modeID, steamID, courseID, modeID);
-		txn.queries.push_back(query);
-		// Get Number of Players with Times
-		V_snprintf(query, sizeof(query), sql_getlowestmaprank, courseID, modeID);
-		txn.queries.push_back(query);
-
-		SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+		run.queryResults = true;
+		run.queryRanks = queryRanks;
+		run.onSuccess = onSuccess;
+		run.onFailure = onFailure;
 	}
+	QueueTime(std::move(run));
 }
@@ -2,6 +2,7 @@
 #include "surf/option/surf_option.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
+#include "statement.h"
 #include "queries/players.h"
 
 using namespace Surf::Database;
@@ -17,11 +18,9 @@ void SurfDatabaseService::SetupClient()
 		return;
 	}
 	// Setup Client Step 1 - Upsert them into Players Table
-	char query[1024];
 
 	// Note: The player must have been authenticated and have a valid steamID at this point.
 	const char *clientName = this->player->GetName();
-	std::string escapedName = GetDatabaseConnection()->Escape(clientName);
 	u64 steamID64 = this->player->GetClient()->GetClientSteamID().ConvertToUint64();
 	const char *clientIP = this->player->GetIpAddress();
 
@@ -32,28 +31,24 @@ void SurfDatabaseService::SetupClient()
 		case DatabaseType::SQLite:
 		{
 			// UPDATE OR IGNORE
-			V_snprintf(query, sizeof(query), sqlite_players_update, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(BindStatement(sqlite_players_update, clientName, clientIP, steamID64));
 			// INSERT OR IGNORE
-			V_snprintf(query, sizeof(query), sqlite_players_insert, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(BindStatement(sqlite_players_insert, clientName, clientIP, steamID64));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
 			// INSERT ... ON DUPLICATE KEY ...
-			V_snprintf(query, sizeof(query), mysql_players_upsert, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(BindStatement(mysql_players_upsert, clientName, clientIP, steamID64));
 			break;
 		}
 	}
 
-	V_snprintf(query, sizeof(query), sql_players_get_infos, steamID64);
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_players_get_infos, steamID64));
 	CPlayerUserId userID = this->player->GetClient()->GetUserID();
 
-	GetDatabaseConnection()->ExecuteTransaction(
-		txn,
+	ExecuteTransaction(
+		"sql_players_get_infos", txn,
 		[&, userID, steamID64](std::vector<ISQLQuery *> queries)
 		{
 			SurfPlayer *pl = g_pSurfPlayerManager->ToPlayer(userID);
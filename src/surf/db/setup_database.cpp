@@ -1,11 +1,82 @@
 #include "surf_db.h"
 #include "surf/option/surf_option.h"
+#include "statement.h"
+#include "queries/pragmas.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 #include "vendor/sql_mm/src/public/sqlite_mm.h"
 #include "vendor/sql_mm/src/public/mysql_mm.h"
 
 using namespace Surf::Database;
 
+// Defaults of the "sqlite" section of the database config.
+#define SURF_DB_SQLITE_DEFAULT_JOURNAL_MODE "WAL"
+#define SURF_DB_SQLITE_DEFAULT_SYNCHRONOUS  "NORMAL"
+#define SURF_DB_SQLITE_DEFAULT_CACHE_SIZE   -16000
+#define SURF_DB_SQLITE_DEFAULT_MMAP_SIZE    268435456
+#define SURF_DB_SQLITE_DEFAULT_TEMP_STORE   "MEMORY"
+
+static_function bool SetupDatabase_IsAllowedValue(const char *value, const char *const *allowed, u32 count)
+{
+	for (u32 i = 0; i < count; i++)
+	{
+		if (!V_stricmp(value, allowed[i]))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Queue a text pragma, an empty value keeps SQLite's default.
+template<u32 N>
+static_function void SetupDatabase_SetTextPragma(const char *sqlTemplate, const char *name, const char *value, const char *const (&allowed)[N])
+{
+	if (!value || !value[0])
+	{
+		return;
+	}
+	if (!SetupDatabase_IsAllowedValue(value, allowed, N))
+	{
+		META_CONPRINTF("[Surf::DB] Ignoring invalid SQLite %s \"%s\".\n", name, value);
+		return;
+	}
+	std::string pragma(name);
+	auto onSuccess = [pragma](ISQLQuery *query)
+	{
+		ISQLResult *result = query->GetResultSet();
+		// Only some pragmas report their new value.
+		if (result && result->FetchRow())
+		{
+			META_CONPRINTF("[Surf::DB] SQLite %s: %s\n", pragma.c_str(), result->GetString(0));
+		}
+	};
+	SurfDatabaseService::Query("sqlite_pragma", BindStatement(sqlTemplate, value), onSuccess);
+}
+
+// Connection tuning, applied before anything else is sent on the connection.
+static_function void SetupDatabase_ApplySQLitePragmas()
+{
+	static_persist const char *const journalModes[] = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+	static_persist const char *const synchronousModes[] = {"OFF", "NORMAL", "FULL", "EXTRA", "0", "1", "2", "3"};
+	static_persist const char *const tempStores[] = {"DEFAULT", "FILE", "MEMORY", "0", "1", "2"};
+
+	KeyValues *config = SurfOptionService::GetOptionKV("db");
+	KeyValues *pragmas = config ? config->FindKey("sqlite") : nullptr;
+	auto getString = [pragmas](const char *key, const char *defaultValue) { return pragmas ? pragmas->GetString(key, defaultValue) : defaultValue; };
+	auto getInt = [pragmas](const char *key, i32 defaultValue) { return pragmas ? pragmas->GetInt(key, defaultValue) : defaultValue; };
+
+	SetupDatabase_SetTextPragma(sqlite_pragma_journal_mode, "journal_mode", getString("journal_mode", SURF_DB_SQLITE_DEFAULT_JOURNAL_MODE),
+								journalModes);
+	SetupDatabase_SetTextPragma(sqlite_pragma_synchronous, "synchronous", getString("synchronous", SURF_DB_SQLITE_DEFAULT_SYNCHRONOUS),
+								synchronousModes);
+	SetupDatabase_SetTextPragma(sqlite_pragma_temp_store, "temp_store", getString("temp_store", SURF_DB_SQLITE_DEFAULT_TEMP_STORE), tempStores);
+
+	SurfDatabaseService::Query("sqlite_pragma", BindStatement(sqlite_pragma_cache_size, getInt("cache_size", SURF_DB_SQLITE_DEFAULT_CACHE_SIZE)),
+							   SurfDatabaseService::OnGenericQuerySuccess);
+	i32 mmapSize = MAX(getInt("mmap_size", SURF_DB_SQLITE_DEFAULT_MMAP_SIZE), 0);
+	SurfDatabaseService::Query("sqlite_pragma", BindStatement(sqlite_pragma_mmap_size, mmapSize), SurfDatabaseService::OnGenericQuerySuccess);
+}
+
 void SurfDatabaseService::SetupDatabase()
 {
 	KeyValues *config = SurfOptionService::GetOptionKV("db");
@@ -49,6 +120,10 @@ void SurfDatabaseService::OnDatabaseConnected(bool connect)
 	if (connect)
 	{
 		META_CONPRINT("[Surf::DB] LocalDB connected.\n");
+		if (databaseType == DatabaseType::SQLite)
+		{
+			SetupDatabase_ApplySQLitePragmas();
+		}
 		SurfDatabaseService::RunMigrations();
 	}
 	else
@@ -1,4 +1,6 @@
 #include "surf_db.h"
+#include "statement.h"
+#include "write_queue.h"
 #include "queries/maps.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
@@ -19,6 +21,8 @@ bool SurfDatabaseService::IsMapSetUp()
 
 void SurfDatabaseService::SetupMap()
 {
+	// Runs of the previous map shouldn't wait for the new one.
+	Surf::Database::FlushWriteQueue();
 	mapSetUp = false;
 	if (!SurfDatabaseService::IsReady())
 	{
@@ -27,39 +31,32 @@ void SurfDatabaseService::SetupMap()
 	}
 
 	Transaction txn;
-	char query[1024];
 	CUtlString mapName = g_pSurfUtils->GetServerGlobals()->mapname.ToCStr();
-	auto escapedMapName = SurfDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
 	auto databaseType = SurfDatabaseService::GetDatabaseType();
 	switch (databaseType)
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_maps_insert, escapedMapName.c_str());
-			txn.queries.push_back(query);
-			V_snprintf(query, sizeof(query), sqlite_maps_update, escapedMapName.c_str());
-			txn.queries.push_back(query);
+			txn.queries.push_back(BindStatement(sqlite_maps_insert, mapName));
+			txn.queries.push_back(BindStatement(sqlite_maps_update, mapName));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_maps_upsert, escapedMapName.c_str());
-			txn.queries.push_back(query);
+			txn.queries.push_back(BindStatement(mysql_maps_upsert, mapName));
 			break;
 		}
 		default:
 		{
 			// This shouldn't happen.
-			query[0] = 0;
 			break;
 		}
 	}
 
-	V_snprintf(query, sizeof(query), sql_maps_findid, escapedMapName.c_str(), escapedMapName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_maps_findid, mapName, mapName));
 	// clang-format off
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn, 
+	SurfDatabaseService::ExecuteTransaction(
+		"sql_maps_findid", txn, 
 		[databaseType, mapName](std::vector<ISQLQuery *> queries) 
 		{
 			auto currentMapName = g_pSurfUtils->GetServerGlobals()->mapname.ToCStr();
@@ -1,5 +1,6 @@
 #include "surf_db.h"
 
+#include "statement.h"
 #include "queries/courses.h"
 
 #include "vendor/sql_mm/src/public/sql_mm.h"
@@ -15,39 +16,33 @@ bool SurfDatabaseService::AreCoursesSetUp()
 
 void SurfDatabaseService::SetupCourses(CUtlVector<SurfCourseDescriptor *> &courses)
 {
-	char query[1024];
 	Transaction txn;
 	FOR_EACH_VEC(courses, i)
 	{
 		SurfCourseDescriptor *course = courses[i];
-		std::string cleanCourseName = SurfDatabaseService::GetDatabaseConnection()->Escape(course->GetName());
 		switch (databaseType)
 		{
 			case DatabaseType::SQLite:
 			{
-				V_snprintf(query, sizeof(query), sqlite_mapcourses_insert, SurfDatabaseService::GetMapID(), cleanCourseName.c_str(), course->id);
-				txn.queries.push_back(query);
+				txn.queries.push_back(BindStatement(sqlite_mapcourses_insert, SurfDatabaseService::GetMapID(), course->GetName(), course->id));
 				break;
 			}
 			case DatabaseType::MySQL:
 			{
-				V_snprintf(query, sizeof(query), mysql_mapcourses_insert, SurfDatabaseService::GetMapID(), cleanCourseName.c_str(), course->id);
-				txn.queries.push_back(query);
+				txn.queries.push_back(BindStatement(mysql_mapcourses_insert, SurfDatabaseService::GetMapID(), course->GetName(), course->id));
 				break;
 			}
 			default:
 			{
 				// This shouldn't happen.
-				query[0] = 0;
 				break;
 			}
 		}
 	}
-	V_snprintf(query, sizeof(query), sql_mapcourses_findall, SurfDatabaseService::GetMapID());
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_mapcourses_findall, SurfDatabaseService::GetMapID()));
 	// clang-format off
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn,
+	SurfDatabaseService::ExecuteTransaction(
+		"sql_mapcourses_findall", txn,
 		[](std::vector<ISQLQuery *> queries) 
 		{
 			auto resultSet = queries.back()->GetResultSet();
@@ -1,5 +1,6 @@
 #include "surf_db.h"
 #include "surf/mode/surf_mode.h"
+#include "statement.h"
 #include "queries/modes.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
@@ -12,7 +13,7 @@ void SurfDatabaseService::UpdateModeIDs()
 		return;
 	}
 	// clang-format off
-	SurfDatabaseService::GetDatabaseConnection()->Query(sql_modes_fetch_all,
+	SurfDatabaseService::Query("sql_modes_fetch_all", sql_modes_fetch_all,
 		[](ISQLQuery *query)
 		{
 			auto resultSet = query->GetResultSet();
@@ -31,32 +32,29 @@ void SurfDatabaseService::InsertAndUpdateModeIDs(CUtlString modeName, CUtlString
 		return;
 	}
 	Transaction txn;
-	char query[1024];
 	switch (SurfDatabaseService::GetDatabaseType())
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_modes_insert, modeName.Get(), shortName.Get());
+			txn.queries.push_back(BindStatement(sqlite_modes_insert, modeName, shortName));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_modes_insert, modeName.Get(), shortName.Get());
+			txn.queries.push_back(BindStatement(mysql_modes_insert, modeName, shortName));
 			break;
 		}
 		default:
 		{
 			// Should never happen.
-			query[0] = 0;
+			txn.queries.push_back({});
 		}
 	}
-	txn.queries.push_back(query);
 
-	V_snprintf(query, sizeof(query), sql_modes_findid, modeName.Get());
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_modes_findid, modeName));
 	// clang-format off
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn, 
+	SurfDatabaseService::ExecuteTransaction(
+		"sql_modes_findid", txn, 
 		[modeName](std::vector<ISQLQuery *> queries) 
 		{
 			auto resultSet = queries[1]->GetResultSet();
@@ -1,5 +1,6 @@
 #include "surf_db.h"
 #include "surf/style/surf_style.h"
+#include "statement.h"
 #include "queries/styles.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
@@ -12,7 +13,7 @@ void SurfDatabaseService::UpdateStyleIDs()
 		return;
 	}
 	// clang-format off
-	SurfDatabaseService::GetDatabaseConnection()->Query(sql_styles_fetch_all,
+	SurfDatabaseService::Query("sql_styles_fetch_all", sql_styles_fetch_all,
 		[](ISQLQuery *query)
 		{
 			auto resultSet = query->GetResultSet();
@@ -31,32 +32,29 @@ void SurfDatabaseService::InsertAndUpdateStyleIDs(CUtlString styleName, CUtlStri
 		return;
 	}
 	Transaction txn;
-	char query[1024];
 	switch (SurfDatabaseService::GetDatabaseType())
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_styles_insert, styleName.Get(), shortName.Get());
+			txn.queries.push_back(BindStatement(sqlite_styles_insert, styleName, shortName));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_styles_insert, styleName.Get(), shortName.Get());
+			txn.queries.push_back(BindStatement(mysql_styles_insert, styleName, shortName));
 			break;
 		}
 		default:
 		{
 			// Should never happen.
-			query[0] = 0;
+			txn.queries.push_back({});
 		}
 	}
-	txn.queries.push_back(query);
 
-	V_snprintf(query, sizeof(query), sql_styles_findid, styleName.Get());
-	txn.queries.push_back(query);
+	txn.queries.push_back(BindStatement(sql_styles_findid, styleName));
 	// clang-format off
-	SurfDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn, 
+	SurfDatabaseService::ExecuteTransaction(
+		"sql_styles_findid", txn, 
 		[styleName](std::vector<ISQLQuery *> queries) 
 		{
 			auto resultSet = queries[1]->GetResultSet();
@@ -0,0 +1,294 @@
+#include "surf_db.h"
+#include "statement.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include <charconv>
+#include <unordered_map>
+
+#include "tier0/memdbgon.h"
+
+using namespace Surf::Database;
+
+enum class PlaceholderType : u8
+{
+	Integer,
+	Float,
+	String
+};
+
+struct Placeholder
+{
+	PlaceholderType type;
+	// printf conversion used for floats so the template keeps control over the precision, e.g. "%.7f".
+	char floatFormat[16];
+};
+
+struct PreparedStatement
+{
+	// One more literal than there are placeholders, literals[i] comes right before placeholders[i].
+	std::vector<std::string> literals;
+	std::vector<Placeholder> placeholders;
+	size_t literalLength;
+};
+
+// Keyed by the address of the template, templates are constant arrays so the address never changes.
+// Only used from the main thread.
+static_global std::unordered_map<const char *, PreparedStatement> g_preparedStatements;
+
+static_function void Statement_AppendLiteral(std::string &literal, char c, bool inQuotes)
+{
+	// The templates are indented raw strings, there is no point in sending the indentation every time.
+	// Leading whitespace is skipped before parsing, an empty literal here directly follows a placeholder.
+	if (!inQuotes && (c == ' ' || c == '\t' || c == '\n' || c == '\r'))
+	{
+		if (literal.empty() || literal.back() != ' ')
+		{
+			literal.push_back(' ');
+		}
+		return;
+	}
+	literal.push_back(c);
+}
+
+static_function PreparedStatement Statement_Parse(const char *sqlTemplate)
+{
+	PreparedStatement statement {};
+	std::string literal;
+	bool inQuotes = false;
+	const char *c = sqlTemplate;
+	while (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r')
+	{
+		c++;
+	}
+	for (; *c; c++)
+	{
+		if (*c != '%')
+		{
+			if (*c == '\'')
+			{
+				inQuotes = !inQuotes;
+			}
+			Statement_AppendLiteral(literal, *c, inQuotes);
+			continue;
+		}
+		if (c[1] == '%')
+		{
+			literal.push_back('%');
+			c++;
+			continue;
+		}
+
+		// Flags, width, precision and length modifiers, then the conversion.
+		const char *start = c++;
+		while (*c && strchr("-+ #0123456789.lhzjt", *c))
+		{
+			c++;
+		}
+		Placeholder placeholder {};
+		switch (*c)
+		{
+			case 'd':
+			case 'i':
+			case 'u':
+			case 'x':
+			case 'X':
+			{
+				placeholder.type = PlaceholderType::Integer;
+				break;
+			}
+			case 'f':
+			case 'F':
+			case 'g':
+			case 'G':
+			case 'e':
+			case 'E':
+			{
+				placeholder.type = PlaceholderType::Float;
+				V_strncpy(placeholder.floatFormat, start, MIN((i32)(c - start) + 2, (i32)sizeof(placeholder.floatFormat)));
+				break;
+			}
+			case 's':
+			{
+				placeholder.type = PlaceholderType::String;
+				break;
+			}
+			default:
+			{
+				META_CONPRINTF("[Surf::DB] Unsupported placeholder in query template: %s\n", sqlTemplate);
+				return {};
+			}
+		}
+		statement.literalLength += literal.size();
+		statement.literals.push_back(std::move(literal));
+		statement.placeholders.push_back(placeholder);
+		literal.clear();
+	}
+	while (!literal.empty() && literal.back() == ' ')
+	{
+		literal.pop_back();
+	}
+	statement.literalLength += literal.size();
+	statement.literals.push_back(std::move(literal));
+	return statement;
+}
+
+static_function const PreparedStatement &Statement_Prepare(const char *sqlTemplate)
+{
+	auto it = g_preparedStatements.find(sqlTemplate);
+	if (it == g_preparedStatements.end())
+	{
+		it = g_preparedStatements.emplace(sqlTemplate, Statement_Parse(sqlTemplate)).first;
+	}
+	return it->second;
+}
+
+static_function void Statement_AppendString(std::string &query, std::string_view value)
+{
+	// Escape expects a null terminated string.
+	std::string raw(value);
+	query += SurfDatabaseService::GetDatabaseConnection()->Escape(raw.c_str());
+}
+
+template<typename T>
+static_function void Statement_AppendNumber(std::string &query, T value)
+{
+	char buffer[32];
+	auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	query.append(buffer, result.ptr);
+}
+
+static_function bool Statement_AppendValue(std::string &query, const Placeholder &placeholder, const BindValue &value)
+{
+	switch (placeholder.type)
+	{
+		case PlaceholderType::Integer:
+		{
+			switch (value.type)
+			{
+				case BindType::Integer:
+				{
+					Statement_AppendNumber(query, value.integer);
+					return true;
+				}
+				case BindType::Unsigned:
+				{
+					Statement_AppendNumber(query, value.unsignedInteger);
+					return true;
+				}
+				case BindType::Float:
+				{
+					Statement_AppendNumber(query, (i64)value.floating);
+					return true;
+				}
+				default:
+				{
+					return false;
+				}
+			}
+		}
+		case PlaceholderType::Float:
+		{
+			if (value.type == BindType::String)
+			{
+				return false;
+			}
+			f64 number = value.type == BindType::Float ? value.floating
+						 : value.type == BindType::Integer ? (f64)value.integer
+														   : (f64)value.unsignedInteger;
+			char buffer[64];
+			V_snprintf(buffer, sizeof(buffer), placeholder.floatFormat, number);
+			query += buffer;
+			return true;
+		}
+		case PlaceholderType::String:
+		{
+			switch (value.type)
+			{
+				case BindType::String:
+				{
+					Statement_AppendString(query, value.string);
+					return true;
+				}
+				case BindType::Integer:
+				{
+					Statement_AppendNumber(query, value.integer);
+					return true;
+				}
+				case BindType::Unsigned:
+				{
+					Statement_AppendNumber(query, value.unsignedInteger);
+					return true;
+				}
+				default:
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+std::string Surf::Database::BindStatementValues(const char *sqlTemplate, const BindValue *values, u32 count)
+{
+	const PreparedStatement &statement = Statement_Prepare(sqlTemplate);
+	if (statement.literals.empty())
+	{
+		return {};
+	}
+	if (count != statement.placeholders.size())
+	{
+		META_CONPRINTF("[Surf::DB] Query template expects %i values but %i were bound.\n", (i32)statement.placeholders.size(), count);
+		return {};
+	}
+
+	std::string query;
+	size_t valueLength = 0;
+	for (u32 i = 0; i < count; i++)
+	{
+		valueLength += values[i].type == BindType::String ? values[i].string.size() + 8 : 24;
+	}
+	query.reserve(statement.literalLength + valueLength);
+
+	for (u32 i = 0; i < count; i++)
+	{
+		query += statement.literals[i];
+		// Never let a string end up outside of quotes.
+		if (!Statement_AppendValue(query, statement.placeholders[i], values[i]))
+		{
+			META_CONPRINTF("[Surf::DB] Value %i bound to a query template has the wrong type.\n", i + 1);
+			return {};
+		}
+	}
+	query += statement.literals.back();
+	return query;
+}
+
+std::string Surf::Database::BindStatementExample(const char *sqlTemplate, i64 integer, f64 floating, std::string_view string)
+{
+	const PreparedStatement &statement = Statement_Prepare(sqlTemplate);
+	std::vector<BindValue> values;
+	values.reserve(statement.placeholders.size());
+	for (const Placeholder &placeholder : statement.placeholders)
+	{
+		switch (placeholder.type)
+		{
+			case PlaceholderType::Integer:
+			{
+				values.emplace_back(integer);
+				break;
+			}
+			case PlaceholderType::Float:
+			{
+				values.emplace_back(floating);
+				break;
+			}
+			case PlaceholderType::String:
+			{
+				values.emplace_back(string);
+				break;
+			}
+		}
+	}
+	return BindStatementValues(sqlTemplate, values.data(), values.size());
+}
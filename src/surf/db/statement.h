@@ -0,0 +1,91 @@
+#pragma once
+#include "common.h"
+#include "utlstring.h"
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/*
+	Typed parameter binding for the query templates in the queries folder.
+
+	sql_mm only accepts complete SQL strings, so there is no server side statement to keep around. What is kept is the parsed
+	template: the first time a template is used its placeholders are located and typed once, later calls only copy the literal
+	pieces and render the bound values. Strings are escaped for the active driver when they are bound, callers pass them as is.
+*/
+
+namespace Surf
+{
+	namespace Database
+	{
+		enum class BindType : u8
+		{
+			Integer,
+			Unsigned,
+			Float,
+			String
+		};
+
+		struct BindValue
+		{
+			BindType type;
+
+			union
+			{
+				i64 integer;
+				u64 unsignedInteger;
+				f64 floating;
+			};
+
+			std::string_view string;
+
+			template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+			BindValue(T value)
+			{
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					this->type = BindType::Float;
+					this->floating = value;
+				}
+				else if constexpr (std::is_signed_v<T>)
+				{
+					this->type = BindType::Integer;
+					this->integer = value;
+				}
+				else
+				{
+					this->type = BindType::Unsigned;
+					this->unsignedInteger = value;
+				}
+			}
+
+			BindValue(const char *value) : type(BindType::String), integer(0), string(value ? value : "") {}
+
+			BindValue(std::string_view value) : type(BindType::String), integer(0), string(value) {}
+
+			BindValue(const std::string &value) : type(BindType::String), integer(0), string(value) {}
+
+			BindValue(const CUtlString &value) : type(BindType::String), integer(0), string(value.Get(), value.Length()) {}
+		};
+
+		// Render a query template with `count` values, in the order of its placeholders.
+		std::string BindStatementValues(const char *sqlTemplate, const BindValue *values, u32 count);
+
+		// Render a query template with the same value for every placeholder of a type, used to look at query plans.
+		std::string BindStatementExample(const char *sqlTemplate, i64 integer, f64 floating, std::string_view string);
+
+		template<typename... Args>
+		std::string BindStatement(const char *sqlTemplate, const Args &...args)
+		{
+			if constexpr (sizeof...(Args) == 0)
+			{
+				return BindStatementValues(sqlTemplate, nullptr, 0);
+			}
+			else
+			{
+				const BindValue values[] = {BindValue(args)...};
+				return BindStatementValues(sqlTemplate, values, sizeof...(Args));
+			}
+		}
+	} // namespace Database
+} // namespace Surf
@@ -0,0 +1,216 @@
+#include "surf_db.h"
+#include "surf/option/surf_option.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include <algorithm>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "tier0/memdbgon.h"
+
+/*
+	Latency of every transaction sent to the local database, from the moment it is queued until its callback runs on the main
+	thread, so it includes waiting behind other queries. Samples are kept in log-linear histograms per query name: exact below
+	16us, then 8 buckets per power of two, which keeps every percentile within 12.5% of the real value.
+*/
+
+// Milliseconds, 0 disables the slow query log.
+#define SURF_DB_DEFAULT_SLOW_QUERY_THRESHOLD 250
+#define SURF_DB_SLOW_QUERY_LOG_DIRECTORY     "addons/cs2surf/logs"
+#define SURF_DB_SLOW_QUERY_LOG_FILE          "slow_queries.log"
+// Longer queries are cut in the slow query log.
+#define SURF_DB_SLOW_QUERY_MAX_LENGTH        1024
+
+#define HISTOGRAM_LINEAR_BUCKETS 16
+#define HISTOGRAM_SUB_BUCKET_BITS 3
+#define HISTOGRAM_SUB_BUCKETS    (1 << HISTOGRAM_SUB_BUCKET_BITS)
+// Enough for about 9 hours in microseconds.
+#define HISTOGRAM_MAX_EXPONENT   35
+#define HISTOGRAM_BUCKETS        (HISTOGRAM_LINEAR_BUCKETS + (HISTOGRAM_MAX_EXPONENT - 3) * HISTOGRAM_SUB_BUCKETS)
+
+struct LatencyHistogram
+{
+	u32 buckets[HISTOGRAM_BUCKETS];
+	u64 count;
+	u64 failed;
+	u64 totalMicroseconds;
+	u64 maxMicroseconds;
+
+	static u32 GetBucket(u64 microseconds)
+	{
+		if (microseconds < HISTOGRAM_LINEAR_BUCKETS)
+		{
+			return (u32)microseconds;
+		}
+		u32 exponent = 0;
+		for (u64 value = microseconds; value > 1; value >>= 1)
+		{
+			exponent++;
+		}
+		if (exponent > HISTOGRAM_MAX_EXPONENT)
+		{
+			return HISTOGRAM_BUCKETS - 1;
+		}
+		u32 subBucket = (microseconds >> (exponent - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1);
+		return HISTOGRAM_LINEAR_BUCKETS + (exponent - 4) * HISTOGRAM_SUB_BUCKETS + subBucket;
+	}
+
+	// Largest value that goes into the bucket.
+	static u64 GetBucketLimit(u32 bucket)
+	{
+		if (bucket < HISTOGRAM_LINEAR_BUCKETS)
+		{
+			return bucket;
+		}
+		u32 exponent = (bucket - HISTOGRAM_LINEAR_BUCKETS) / HISTOGRAM_SUB_BUCKETS + 4;
+		u64 subBucket = (bucket - HISTOGRAM_LINEAR_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+		u64 step = 1ull << (exponent - HISTOGRAM_SUB_BUCKET_BITS);
+		return (1ull << exponent) + (subBucket + 1) * step - 1;
+	}
+
+	void Record(u64 microseconds, bool success)
+	{
+		this->buckets[GetBucket(microseconds)]++;
+		this->count++;
+		this->failed += !success;
+		this->totalMicroseconds += microseconds;
+		this->maxMicroseconds = MAX(this->maxMicroseconds, microseconds);
+	}
+
+	u64 GetPercentile(f64 percentile) const
+	{
+		u64 target = (u64)ceil(this->count * percentile / 100.0);
+		u64 seen = 0;
+		for (u32 i = 0; i < HISTOGRAM_BUCKETS; i++)
+		{
+			seen += this->buckets[i];
+			if (seen >= target && seen > 0)
+			{
+				return MIN(GetBucketLimit(i), this->maxMicroseconds);
+			}
+		}
+		return this->maxMicroseconds;
+	}
+};
+
+// Main thread only.
+static_global std::unordered_map<std::string, LatencyHistogram> g_queryStats;
+
+static_function void Stats_LogSlowQuery(const char *name, f64 milliseconds, const std::vector<std::string> &queries)
+{
+	char path[MAX_PATH];
+	g_SMAPI->PathFormat(path, sizeof(path), "%s/%s", g_SMAPI->GetBaseDir(), SURF_DB_SLOW_QUERY_LOG_DIRECTORY);
+#ifdef _WIN32
+	_mkdir(path);
+#else
+	mkdir(path, 0775);
+#endif
+	g_SMAPI->PathFormat(path, sizeof(path), "%s/%s/%s", g_SMAPI->GetBaseDir(), SURF_DB_SLOW_QUERY_LOG_DIRECTORY, SURF_DB_SLOW_QUERY_LOG_FILE);
+	FILE *file = fopen(path, "a");
+	if (!file)
+	{
+		return;
+	}
+	char date[32];
+	time_t now = time(nullptr);
+	strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+	fprintf(file, "[%s] %s took %.1f ms\n", date, name, milliseconds);
+	for (const std::string &query : queries)
+	{
+		fprintf(file, "    %.*s%s\n", (i32)MIN(query.size(), (size_t)SURF_DB_SLOW_QUERY_MAX_LENGTH), query.c_str(),
+				query.size() > SURF_DB_SLOW_QUERY_MAX_LENGTH ? "..." : "");
+	}
+	fclose(file);
+}
+
+// Returns what has to be called from the callback to record the sample. The text of the queries is only read if they were slow,
+// it is shared with what is sent to the database rather than copied.
+static_function std::function<void(bool)> Stats_Start(const char *name, std::shared_ptr<const std::vector<std::string>> queries)
+{
+	f64 start = Plat_FloatTime();
+	f64 threshold = SurfOptionService::GetOptionFloat("dbSlowQueryThreshold", SURF_DB_DEFAULT_SLOW_QUERY_THRESHOLD);
+	if (threshold <= 0.0)
+	{
+		queries.reset();
+	}
+	return [name, start, threshold, queries = std::move(queries)](bool success)
+	{
+		f64 milliseconds = (Plat_FloatTime() - start) * 1000.0;
+		g_queryStats[name].Record((u64)(milliseconds * 1000.0), success);
+		if (queries && milliseconds >= threshold)
+		{
+			Stats_LogSlowQuery(name, milliseconds, *queries);
+		}
+	};
+}
+
+void SurfDatabaseService::ExecuteTransaction(const char *name, Transaction &txn, TransactionSuccessCallbackFunc onSuccess,
+											 TransactionFailureCallbackFunc onFailure)
+{
+	// Kept alive by the callbacks so that the text can still be logged if the transaction turns out to be slow.
+	auto owned = std::make_shared<Transaction>(std::move(txn));
+	auto record = Stats_Start(name, std::shared_ptr<const std::vector<std::string>>(owned, &owned->queries));
+	auto onSuccessTimed = [record, onSuccess](std::vector<ISQLQuery *> queries)
+	{
+		record(true);
+		onSuccess(queries);
+	};
+	auto onFailureTimed = [record, onFailure](std::string error, int failIndex)
+	{
+		record(false);
+		onFailure(error, failIndex);
+	};
+	GetDatabaseConnection()->ExecuteTransaction(*owned, onSuccessTimed, onFailureTimed);
+}
+
+void SurfDatabaseService::Query(const char *name, std::string query, QuerySuccessCallbackFunc onSuccess)
+{
+	auto owned = std::make_shared<std::vector<std::string>>();
+	owned->push_back(std::move(query));
+	auto record = Stats_Start(name, owned);
+	auto onSuccessTimed = [record, onSuccess](ISQLQuery *result)
+	{
+		record(true);
+		onSuccess(result);
+	};
+	GetDatabaseConnection()->Query(owned->front().c_str(), onSuccessTimed);
+}
+
+void SurfDatabaseService::PrintQueryStats(bool reset)
+{
+	std::vector<std::pair<const std::string *, const LatencyHistogram *>> entries;
+	for (const auto &[name, histogram] : g_queryStats)
+	{
+		entries.emplace_back(&name, &histogram);
+	}
+	// Whatever keeps the database busy the longest comes first.
+	std::sort(entries.begin(), entries.end(),
+			  [](const auto &a, const auto &b) { return a.second->totalMicroseconds > b.second->totalMicroseconds; });
+
+	META_CONPRINTF("[Surf::DB] Query latency in ms, from queueing to callback:\n");
+	META_CONPRINTF("%-36s %8s %6s %9s %9s %9s %9s %9s\n", "name", "count", "failed", "mean", "p50", "p90", "p99", "max");
+	for (const auto &[name, histogram] : entries)
+	{
+		META_CONPRINTF("%-36s %8llu %6llu %9.2f %9.2f %9.2f %9.2f %9.2f\n", name->c_str(), histogram->count, histogram->failed,
+					   histogram->totalMicroseconds / 1000.0 / MAX(histogram->count, 1ull), histogram->GetPercentile(50.0) / 1000.0,
+					   histogram->GetPercentile(90.0) / 1000.0, histogram->GetPercentile(99.0) / 1000.0, histogram->maxMicroseconds / 1000.0);
+	}
+	if (reset)
+	{
+		g_queryStats.clear();
+		META_CONPRINTF("[Surf::DB] Query statistics reset.\n");
+	}
+}
+
+CON_COMMAND_F(surf_db_stats, "Print local database query latency statistics. Pass \"reset\" to clear them.", FCVAR_NONE)
+{
+	SurfDatabaseService::PrintQueryStats(args.ArgC() > 1 && SURF_STREQI(args.Arg(1), "reset"));
+}
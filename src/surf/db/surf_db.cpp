@@ -1,4 +1,5 @@
 #include "surf_db.h"
+#include "write_queue.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 using namespace Surf::Database;
@@ -30,8 +31,17 @@ void SurfDatabaseService::Init()
 
 void SurfDatabaseService::Cleanup()
 {
+	Surf::Database::FlushWriteQueue();
 	if (databaseConnection)
 	{
+		// Transaction callbacks only run between frames, so there is no waiting for the last flush here.
+		u32 times, prefs;
+		Surf::Database::GetUnconfirmedWrites(times, prefs);
+		if (times > 0 || prefs > 0)
+		{
+			META_CONPRINTF("[Surf::DB] Unloading with %u runs and %u player preferences not confirmed as written, they may be lost.\n", times,
+						   prefs);
+		}
 		databaseConnection->Destroy();
 		databaseConnection = NULL;
 	}
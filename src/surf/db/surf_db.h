@@ -4,6 +4,8 @@
 
 class ISQLConnection;
 class ISQLQuery;
+struct Transaction;
+typedef std::function<void(ISQLQuery *)> QuerySuccessCallbackFunc;
 typedef std::function<void(std::vector<ISQLQuery *>)> TransactionSuccessCallbackFunc;
 typedef std::function<void(std::string, int)> TransactionFailureCallbackFunc;
 
@@ -87,6 +89,13 @@ public:
 
 	static void OnGenericQuerySuccess(ISQLQuery *query) {}
 
+	// Send a transaction or a single query to the local database. The time until the callback runs is recorded under `name`,
+	// usually the name of the main query template, see surf_db_stats. The queries are moved out of `txn`.
+	static void ExecuteTransaction(const char *name, Transaction &txn, TransactionSuccessCallbackFunc onSuccess,
+								   TransactionFailureCallbackFunc onFailure);
+	static void Query(const char *name, std::string query, QuerySuccessCallbackFunc onSuccess);
+	static void PrintQueryStats(bool reset);
+
 	static void SetupDatabase();
 	static void OnDatabaseConnected(bool connect);
 
@@ -134,9 +143,14 @@ public:
 	static void InsertAndUpdateStyleIDs(CUtlString styleName, CUtlString shortName);
 
 	// Times
-	static void SaveTime(u64 steamID, u32 courseID, i32 modeID, f64 time, u64 styleIDs, std::string_view metadata,
+	// Runs are saved through the write queue, the callbacks are only used for runs without styles.
+	// Their queries are: PB before the run, insert, PB update, PB after the run,
+	// then rank and number of ranked players if `queryRanks` is set.
+	static void SaveTime(u64 steamID, u32 courseID, i32 modeID, f64 time, u64 styleIDs, std::string_view splits, bool queryRanks,
 						 TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure);
-	static void QueryAllPBs(u64 steamID64, CUtlString mapName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure);
+	// PBs of every course and mode of the map for several players, rows start with the SteamID64 of the player.
+	static void QueryAllPBs(const std::vector<u64> &steamID64s, CUtlString mapName, TransactionSuccessCallbackFunc onSuccess,
+							TransactionFailureCallbackFunc onFailure);
 	static void QueryPB(u64 steamID64, CUtlString mapName, CUtlString courseName, u32 modeID, TransactionSuccessCallbackFunc onSuccess,
 						TransactionFailureCallbackFunc onFailure);
 	static void QueryPBRankless(u64 steamID64, CUtlString mapName, CUtlString courseName, u32 modeID, u64 styleIDFlags,
@@ -145,4 +159,5 @@ public:
 	static void QueryAllRecords(CUtlString mapName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure);
 	static void QueryRecords(CUtlString mapName, CUtlString courseName, u32 modeID, u32 count, u32 offset, TransactionSuccessCallbackFunc onSuccess,
 							 TransactionFailureCallbackFunc onFailure);
+	static void QueryMapLeaderboards(i32 mapID, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure);
 };
@@ -0,0 +1,260 @@
+#include "write_queue.h"
+#include "statement.h"
+#include "queries/players.h"
+#include "queries/save_time.h"
+#include "queries/times.h"
+#include "surf/option/surf_option.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include <unordered_map>
+
+#include "tier0/memdbgon.h"
+
+using namespace Surf::Database;
+
+// Seconds a write may wait for others to join its batch.
+#define SURF_DB_DEFAULT_WRITE_DELAY 0.25
+// A batch with this many runs is sent without waiting.
+#define SURF_DB_WRITE_BATCH_MAX_TIMES 64
+
+// Main thread only.
+static_global struct
+{
+	std::vector<QueuedTime> times;
+	// Latest preferences of every player, in the order the players were first queued.
+	std::unordered_map<u64, std::string> prefs;
+	std::vector<u64> prefsOrder;
+	// Zero while the queue is empty.
+	f64 flushTime;
+	// Sent to the database but not confirmed yet.
+	u32 unconfirmedTimes;
+	u32 unconfirmedPrefs;
+} g_writeQueue;
+
+static_function void WriteQueue_OnWrite()
+{
+	if (g_writeQueue.flushTime == 0.0)
+	{
+		f64 delay = MAX(SurfOptionService::GetOptionFloat("dbWriteDelay", SURF_DB_DEFAULT_WRITE_DELAY), 0.0);
+		g_writeQueue.flushTime = Plat_FloatTime() + delay;
+	}
+}
+
+static_function void WriteQueue_AppendRow(std::string &query, const std::string &row, bool first)
+{
+	query += first ? " " : ", ";
+	query += row;
+}
+
+void Surf::Database::QueueTime(QueuedTime &&time)
+{
+	g_writeQueue.times.push_back(std::move(time));
+	WriteQueue_OnWrite();
+	if (g_writeQueue.times.size() >= SURF_DB_WRITE_BATCH_MAX_TIMES)
+	{
+		FlushWriteQueue();
+	}
+}
+
+void Surf::Database::QueuePrefs(u64 steamID64, const CUtlString &prefs)
+{
+	auto result = g_writeQueue.prefs.insert_or_assign(steamID64, std::string(prefs.Get(), prefs.Length()));
+	if (result.second)
+	{
+		g_writeQueue.prefsOrder.push_back(steamID64);
+	}
+	WriteQueue_OnWrite();
+}
+
+void Surf::Database::ProcessWriteQueue()
+{
+	if (g_writeQueue.flushTime != 0.0 && Plat_FloatTime() >= g_writeQueue.flushTime)
+	{
+		FlushWriteQueue();
+	}
+}
+
+/*
+	Send runs and preferences in a single transaction. If a transaction with more than one write fails, each write is sent
+	again in a transaction of its own. That way one bad row or a busy database only costs the write it hit, not the whole batch.
+*/
+static_function void WriteQueue_Send(std::vector<QueuedTime> times, std::unordered_map<u64, std::string> prefs, std::vector<u64> prefsOrder)
+{
+	if (!SurfDatabaseService::IsReady())
+	{
+		META_CONPRINTF("[Surf::DB] Dropped %u runs and %u player preferences, the database isn't ready.\n", (u32)times.size(),
+					   (u32)prefsOrder.size());
+		for (const QueuedTime &run : times)
+		{
+			if (run.onFailure)
+			{
+				run.onFailure("Database isn't ready", -1);
+			}
+		}
+		return;
+	}
+	bool mysql = SurfDatabaseService::GetDatabaseType() == DatabaseType::MySQL;
+
+	Transaction txn;
+	// Queries of every run that wants its results: PB before the run, PB after the run, rank and number of ranked players.
+	struct RunQueries
+	{
+		i32 oldPB = -1;
+		i32 newPB = -1;
+		i32 rank = -1;
+		i32 maxRank = -1;
+	};
+
+	std::vector<RunQueries> runQueries(times.size());
+	for (u32 i = 0; i < times.size(); i++)
+	{
+		const QueuedTime &run = times[i];
+		if (run.queryResults)
+		{
+			runQueries[i].oldPB = txn.queries.size();
+			txn.queries.push_back(BindStatement(sql_savetime_getpb, run.steamID64, run.courseID, run.modeID, run.styleIDs));
+		}
+	}
+
+	i32 insertIndex = -1;
+	i32 upsertIndex = -1;
+	if (!times.empty())
+	{
+		std::string insert = BindStatement(sql_times_insert);
+		std::string upsert = BindStatement(sql_pbs_upsert);
+		const char *upsertRow = mysql ? mysql_pbs_upsert_row : sqlite_pbs_upsert_row;
+		u32 count = times.size();
+		for (u32 i = 0; i < count; i++)
+		{
+			const QueuedTime &run = times[i];
+			std::string row = BindStatement(sql_times_insert_row, run.steamID64, run.courseID, run.modeID, run.styleIDs, run.time, run.splits);
+			WriteQueue_AppendRow(insert, row, i == 0);
+			// Position of the run's ID relative to the one the driver reports for the insert.
+			u32 offset = mysql ? i : count - 1 - i;
+			WriteQueue_AppendRow(upsert, BindStatement(upsertRow, run.steamID64, run.courseID, run.modeID, run.styleIDs, offset, run.time), i == 0);
+		}
+		upsert += " ";
+		upsert += BindStatement(mysql ? mysql_pbs_upsert_conflict : sqlite_pbs_upsert_conflict);
+
+		insertIndex = txn.queries.size();
+		txn.queries.push_back(std::move(insert));
+		// Must directly follow the insert.
+		upsertIndex = txn.queries.size();
+		txn.queries.push_back(std::move(upsert));
+	}
+
+	for (u32 i = 0; i < times.size(); i++)
+	{
+		const QueuedTime &run = times[i];
+		if (!run.queryResults)
+		{
+			continue;
+		}
+		runQueries[i].newPB = txn.queries.size();
+		txn.queries.push_back(BindStatement(sql_savetime_getpb, run.steamID64, run.courseID, run.modeID, run.styleIDs));
+		if (run.queryRanks)
+		{
+			runQueries[i].rank = txn.queries.size();
+			txn.queries.push_back(BindStatement(sql_savetime_getmaprank, run.courseID, run.modeID, run.steamID64, run.courseID, run.modeID));
+			runQueries[i].maxRank = txn.queries.size();
+			txn.queries.push_back(BindStatement(sql_savetime_getlowestmaprank, run.courseID, run.modeID));
+		}
+	}
+
+	if (!prefsOrder.empty())
+	{
+		std::string query = BindStatement(sql_players_set_prefs);
+		for (u32 i = 0; i < prefsOrder.size(); i++)
+		{
+			WriteQueue_AppendRow(query, BindStatement(sql_players_set_prefs_row, prefsOrder[i], prefs[prefsOrder[i]]), i == 0);
+		}
+		query += " ";
+		query += BindStatement(mysql ? mysql_players_set_prefs_conflict : sqlite_players_set_prefs_conflict);
+		txn.queries.push_back(std::move(query));
+	}
+
+	u32 queryCount = txn.queries.size();
+	u32 timeCount = times.size();
+	u32 prefsCount = prefsOrder.size();
+	g_writeQueue.unconfirmedTimes += timeCount;
+	g_writeQueue.unconfirmedPrefs += prefsCount;
+	auto onSuccess = [times, runQueries, insertIndex, upsertIndex, queryCount, prefsCount](std::vector<ISQLQuery *> queries)
+	{
+		g_writeQueue.unconfirmedTimes -= times.size();
+		g_writeQueue.unconfirmedPrefs -= prefsCount;
+		if (queries.size() != queryCount)
+		{
+			META_CONPRINTF("[Surf::DB] Write queue expected %u results but got %u.\n", queryCount, (u32)queries.size());
+			return;
+		}
+		for (u32 i = 0; i < times.size(); i++)
+		{
+			const QueuedTime &run = times[i];
+			if (!run.queryResults || !run.onSuccess)
+			{
+				continue;
+			}
+			// Same layout as a run that was saved on its own.
+			const RunQueries &indices = runQueries[i];
+			std::vector<ISQLQuery *> results = {queries[indices.oldPB], queries[insertIndex], queries[upsertIndex], queries[indices.newPB]};
+			if (run.queryRanks)
+			{
+				results.push_back(queries[indices.rank]);
+				results.push_back(queries[indices.maxRank]);
+			}
+			run.onSuccess(results);
+		}
+		SurfDatabaseService::OnGenericTxnSuccess(queries);
+	};
+	auto onFailure = [times, prefs = std::move(prefs), prefsOrder = std::move(prefsOrder)](std::string error, int failIndex)
+	{
+		g_writeQueue.unconfirmedTimes -= times.size();
+		g_writeQueue.unconfirmedPrefs -= prefsOrder.size();
+		SurfDatabaseService::OnGenericTxnFailure(error, failIndex);
+		if (times.size() + prefsOrder.size() > 1)
+		{
+			META_CONPRINTF("[Surf::DB] Retrying %u runs and %u player preferences of the failed write batch one by one.\n", (u32)times.size(),
+						   (u32)prefsOrder.size());
+			for (const QueuedTime &run : times)
+			{
+				WriteQueue_Send({run}, {}, {});
+			}
+			for (u64 steamID64 : prefsOrder)
+			{
+				WriteQueue_Send({}, {{steamID64, prefs.at(steamID64)}}, {steamID64});
+			}
+			return;
+		}
+		for (const QueuedTime &run : times)
+		{
+			if (run.onFailure)
+			{
+				run.onFailure(error, failIndex);
+			}
+		}
+	};
+	SurfDatabaseService::ExecuteTransaction(times.empty() ? "sql_players_set_prefs" : "sql_times_insert", txn, onSuccess, onFailure);
+}
+
+void Surf::Database::FlushWriteQueue()
+{
+	std::vector<QueuedTime> times = std::move(g_writeQueue.times);
+	std::unordered_map<u64, std::string> prefs = std::move(g_writeQueue.prefs);
+	std::vector<u64> prefsOrder = std::move(g_writeQueue.prefsOrder);
+	g_writeQueue.times.clear();
+	g_writeQueue.prefs.clear();
+	g_writeQueue.prefsOrder.clear();
+	g_writeQueue.flushTime = 0.0;
+
+	if (times.empty() && prefsOrder.empty())
+	{
+		return;
+	}
+	WriteQueue_Send(std::move(times), std::move(prefs), std::move(prefsOrder));
+}
+
+void Surf::Database::GetUnconfirmedWrites(u32 &times, u32 &prefs)
+{
+	times = g_writeQueue.unconfirmedTimes;
+	prefs = g_writeQueue.unconfirmedPrefs;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "surf_db.h"
+
+#include <string>
+
+/*
+	Write-behind queue for runs and preferences.
+
+	Writes are held back for a short moment so that everything queued in that window goes out as a single transaction with
+	multi-row inserts, instead of one transaction per run when a lot of players finish at the same time. Nothing waits longer
+	than the configured delay, a full batch is sent right away. Only a player's latest preferences are kept.
+*/
+
+namespace Surf
+{
+	namespace Database
+	{
+		struct QueuedTime
+		{
+			u64 steamID64;
+			u32 courseID;
+			i32 modeID;
+			f64 time;
+			u64 styleIDs;
+			// Encoded split times, see Surf::splits.
+			std::string splits;
+			// Also read the PB from before and after the run, and the rank if `queryRanks` is set. See SurfDatabaseService::SaveTime.
+			bool queryResults;
+			bool queryRanks;
+			TransactionSuccessCallbackFunc onSuccess;
+			TransactionFailureCallbackFunc onFailure;
+		};
+
+		void QueueTime(QueuedTime &&time);
+		// Replaces the preferences still waiting to be saved for this player.
+		void QueuePrefs(u64 steamID64, const CUtlString &prefs);
+
+		// Send everything that is queued now.
+		void FlushWriteQueue();
+		// Send the queue once its oldest write waited long enough, called every frame.
+		void ProcessWriteQueue();
+		// Writes that were sent but whose transaction hasn't finished yet.
+		void GetUnconfirmedWrites(u32 &times, u32 &prefs);
+	} // namespace Database
+} // namespace Surf
@@ -99,7 +99,7 @@ SCMD(surf_globalcheck, SCFL_GLOBAL | SCFL_MAP | SCFL_PLAYER)
 		// clang-format on
 
 		// clang-format off
-		player->languageService->PrintChat(true, false, "Global Check",
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Global Check"),
 				MakeStatusString(apiStatus),
 				MakeStatusString(serverStatus),
 				MakeStatusString(mapStatus),
@@ -129,7 +129,7 @@ SCMD(surf_globalcheck, SCFL_GLOBAL | SCFL_MAP | SCFL_PLAYER)
 			}
 
 			// clang-format off
-			player->languageService->PrintChat(true, false, "Global Check",
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Global Check"),
 					apiStatus,
 					serverStatus,
 					mapStatus,
@@ -145,3 +145,8 @@ SCMD(surf_globalcheck, SCFL_GLOBAL | SCFL_MAP | SCFL_PLAYER)
 }
 
 SCMD_LINK(surf_gc, surf_globalcheck);
+
+CON_COMMAND_F(surf_global_queue_stats, "Print main thread callback queue statistics. Pass \"reset\" to clear them.", FCVAR_NONE)
+{
+	SurfGlobalService::PrintCallbackQueueStats(args.ArgC() > 1 && SURF_STREQI(args.Arg(1), "reset"));
+}
@@ -41,7 +41,8 @@ bool Surf::API::events::NewRecord::ToJson(Json &json) const
 		&& json.Set("mode_md5", this->modeChecksum)
 		&& json.Set("time", this->time)
 		&& json.Set("styles", this->styles)
-		&& json.Set("metadata", this->metadata);
+		&& json.Set("metadata", this->metadata)
+		&& json.Set("idempotency_key", this->idempotencyKey);
 	// clang-format on
 }
 
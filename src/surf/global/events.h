@@ -65,6 +65,8 @@ namespace Surf::API::events
 		f64 time;
 		std::vector<StyleInfo> styles;
 		std::string_view metadata;
+		// Lets the API recognize records we submit more than once.
+		std::string_view idempotencyKey;
 
 		bool ToJson(Json &json) const;
 	};
@@ -1,12 +1,48 @@
 #include "handshake.h"
 
+bool Surf::API::handshake::DecodeEncodingString(std::string_view encodingString, Encoding &encoding)
+{
+	if (encodingString == "json")
+	{
+		encoding = Encoding::JSON;
+	}
+	else if (encodingString == "msgpack")
+	{
+		encoding = Encoding::MessagePack;
+	}
+	else if (encodingString == "cbor")
+	{
+		encoding = Encoding::CBOR;
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+const char *Surf::API::handshake::EncodingToString(Encoding encoding)
+{
+	switch (encoding)
+	{
+		case Encoding::MessagePack:
+			return "msgpack";
+		case Encoding::CBOR:
+			return "cbor";
+		default:
+			return "json";
+	}
+}
+
 bool Surf::API::handshake::Hello::ToJson(Json &json) const
 {
 	// clang-format off
 	return json.Set("plugin_version", PLUGIN_FULL_VERSION)
 		&& json.Set("plugin_version_checksum", this->checksum)
 		&& json.Set("map", this->currentMapName)
-		&& json.Set("players", this->players);
+		&& json.Set("players", this->players)
+		&& json.Set("encodings", this->encodings);
 	// clang-format on
 }
 
@@ -26,6 +62,19 @@ bool Surf::API::handshake::HelloAck::FromJson(const Json &json)
 
 	this->heartbeatInterval = heartbeatInterval;
 
+	std::optional<std::string> encoding;
+
+	if (!json.Get("encoding", encoding))
+	{
+		return false;
+	}
+
+	if (encoding.has_value() && !DecodeEncodingString(*encoding, this->encoding))
+	{
+		META_CONPRINTF("[Surf::Global] API picked unknown encoding `%s`.\n", encoding->c_str());
+		return false;
+	}
+
 	return json.Get("map", this->mapInfo) && json.Get("modes", this->modes) && json.Get("styles", this->styles);
 }
 
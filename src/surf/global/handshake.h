@@ -8,6 +8,22 @@
 
 namespace Surf::API::handshake
 {
+	/**
+	 * Wire format of the messages sent after the handshake.
+	 *
+	 * `Hello` and `HelloAck` are always JSON text, the API picks one of the encodings we offer in `Hello`.
+	 * APIs that don't know about this never send `encoding`, which means JSON.
+	 */
+	enum class Encoding : u8
+	{
+		JSON,
+		MessagePack,
+		CBOR,
+	};
+
+	bool DecodeEncodingString(std::string_view encodingString, Encoding &encoding);
+	const char *EncodingToString(Encoding encoding);
+
 	struct Hello
 	{
 		struct PlayerInfo
@@ -21,6 +37,8 @@ namespace Surf::API::handshake
 		std::string_view checksum;
 		std::string_view currentMapName;
 		std::unordered_map<u64, PlayerInfo> players;
+		// In order of preference.
+		std::vector<std::string_view> encodings;
 
 		Hello(std::string_view checksum, std::string_view currentMapName) : checksum(checksum), currentMapName(currentMapName) {}
 
@@ -57,6 +75,7 @@ namespace Surf::API::handshake
 		std::optional<Surf::API::Map> mapInfo {};
 		std::vector<ModeInfo> modes {};
 		std::vector<StyleInfo> styles {};
+		Encoding encoding = Encoding::JSON;
 
 		bool FromJson(const Json &json);
 	};
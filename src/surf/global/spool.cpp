@@ -0,0 +1,397 @@
+/*
+	Spool of record submissions that haven't been acknowledged by the API yet.
+
+	Every record is appended to the spool file before it is sent, and an acknowledgement line is appended once the API
+	answers. Whatever has no acknowledgement when the plugin loads is sent again after the handshake, in the order it was
+	recorded. Each record carries an idempotency key, so a record the API did receive but couldn't acknowledge before the
+	connection dropped is not counted twice.
+
+	The file is only written by the spool thread. Lines that pile up while it waits for the disk are written and synced
+	together. Sending is rate limited so a reconnect with a large backlog doesn't flood the API.
+*/
+
+#include "surf_global.h"
+#include "cs2surf.h"
+#include "surf/option/surf_option.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "tier0/memdbgon.h"
+
+#define SPOOL_FILE "addons/cs2surf/data/global_record_spool.jsonl"
+
+// Records are sent again if the API didn't answer within this many seconds.
+#define SPOOL_RESEND_TIMEOUT 30.0
+#define SPOOL_MAX_IN_FLIGHT  8
+
+struct SpooledRecord
+{
+	std::string key;
+	Json data;
+	bool inFlight;
+	f64 sentAt;
+	// Only set for records submitted since the plugin was loaded.
+	SmallFunction<void(Surf::API::events::NewRecordAck &)> callback;
+};
+
+struct SpoolWrite
+{
+	std::string line;
+	// Start over with an empty file instead of appending `line`.
+	bool truncate;
+};
+
+static_global struct
+{
+	// Main thread only.
+	std::deque<SpooledRecord> records;
+	f64 tokens;
+	f64 lastDrainTime;
+	f64 drainRate;
+	u32 maxRecords;
+	u64 keyNonce;
+	u32 keyCounter;
+
+	std::string path;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::vector<SpoolWrite> writes;
+	bool running;
+} g_spool;
+
+static_function void Spool_Sync(FILE *file)
+{
+	fflush(file);
+#ifdef _WIN32
+	_commit(_fileno(file));
+#else
+	fsync(fileno(file));
+#endif
+}
+
+static_function void Spool_Thread()
+{
+	FILE *file = fopen(g_spool.path.c_str(), "ab");
+	if (!file)
+	{
+		META_CONPRINTF("[Surf::Global] Failed to open record spool '%s', unacknowledged records will not survive a restart.\n", g_spool.path.c_str());
+	}
+
+	while (true)
+	{
+		std::vector<SpoolWrite> writes;
+		{
+			std::unique_lock lock(g_spool.mutex);
+			g_spool.condition.wait(lock, []() { return !g_spool.writes.empty() || !g_spool.running; });
+			if (g_spool.writes.empty())
+			{
+				break;
+			}
+			writes.swap(g_spool.writes);
+		}
+
+		for (const SpoolWrite &write : writes)
+		{
+			if (write.truncate)
+			{
+				if (file)
+				{
+					fclose(file);
+				}
+				file = fopen(g_spool.path.c_str(), "wb");
+				continue;
+			}
+			if (file)
+			{
+				fwrite(write.line.data(), 1, write.line.size(), file);
+				fputc('\n', file);
+			}
+		}
+
+		// One sync for everything that queued up while the previous one was running.
+		if (file)
+		{
+			Spool_Sync(file);
+		}
+	}
+
+	if (file)
+	{
+		fclose(file);
+	}
+}
+
+static_function void Spool_Write(SpoolWrite &&write)
+{
+	{
+		std::unique_lock lock(g_spool.mutex);
+		g_spool.writes.push_back(std::move(write));
+	}
+	g_spool.condition.notify_one();
+}
+
+static_function std::string Spool_MakeRecordLine(const SpooledRecord &record)
+{
+	Json line;
+	line.Set("type", "record");
+	line.Set("key", record.key);
+	line.Set("data", record.data);
+	return line.ToString();
+}
+
+// Reads the records that were never acknowledged, in the order they were spooled.
+static_function void Spool_Read(std::deque<SpooledRecord> &records)
+{
+	FILE *file = fopen(g_spool.path.c_str(), "rb");
+	if (!file)
+	{
+		return;
+	}
+	std::string contents;
+	char buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		contents.append(buffer, read);
+	}
+	fclose(file);
+
+	// Acknowledgements come after their record, drop those records once everything was read.
+	std::unordered_set<std::string> acked;
+	size_t start = 0;
+	while (start < contents.size())
+	{
+		size_t end = contents.find('\n', start);
+		if (end == std::string::npos)
+		{
+			// A line without a newline was cut short by a crash.
+			break;
+		}
+		Json line(contents.substr(start, end - start));
+		start = end + 1;
+
+		std::string type;
+		std::string key;
+		if (!line.IsValid() || !line.Get("type", type) || !line.Get("key", key))
+		{
+			continue;
+		}
+		if (type == "ack")
+		{
+			acked.insert(std::move(key));
+		}
+		else if (type == "record")
+		{
+			SpooledRecord record {key};
+			if (line.Get("data", record.data))
+			{
+				records.push_back(std::move(record));
+			}
+		}
+	}
+	if (!acked.empty())
+	{
+		records.erase(std::remove_if(records.begin(), records.end(), [&](const SpooledRecord &record) { return acked.count(record.key) > 0; }),
+					  records.end());
+	}
+}
+
+void SurfGlobalService::LoadSpool()
+{
+	char path[MAX_PATH];
+	g_SMAPI->PathFormat(path, sizeof(path), "%s/%s", g_SMAPI->GetBaseDir(), SPOOL_FILE);
+	g_spool.path = path;
+	g_spool.drainRate = MAX(SurfOptionService::GetOptionFloat("apiSpoolDrainRate", SURF_GLOBAL_SPOOL_DEFAULT_DRAIN_RATE), 0.1);
+	g_spool.maxRecords = (u32)MAX(SurfOptionService::GetOptionInt("apiSpoolMaxRecords", SURF_GLOBAL_SPOOL_DEFAULT_MAX_RECORDS), 1);
+	g_spool.tokens = g_spool.drainRate;
+	g_spool.lastDrainTime = Plat_FloatTime();
+	g_spool.keyNonce = ((u64)std::random_device {}() << 32) | std::random_device {}();
+	g_spool.keyCounter = 0;
+
+	g_spool.records.clear();
+	Spool_Read(g_spool.records);
+
+	// Compact the file so it only holds what is still pending.
+	std::string tempPath = g_spool.path + ".tmp";
+	FILE *file = fopen(tempPath.c_str(), "wb");
+	if (file)
+	{
+		for (const SpooledRecord &record : g_spool.records)
+		{
+			std::string line = Spool_MakeRecordLine(record);
+			fwrite(line.data(), 1, line.size(), file);
+			fputc('\n', file);
+		}
+		Spool_Sync(file);
+		fclose(file);
+		remove(g_spool.path.c_str());
+		rename(tempPath.c_str(), g_spool.path.c_str());
+	}
+
+	if (!g_spool.records.empty())
+	{
+		META_CONPRINTF("[Surf::Global] %i unacknowledged records will be submitted once connected.\n", (i32)g_spool.records.size());
+	}
+
+	g_spool.running = true;
+	g_spool.thread = std::thread(Spool_Thread);
+}
+
+void SurfGlobalService::CloseSpool()
+{
+	{
+		std::unique_lock lock(g_spool.mutex);
+		if (!g_spool.running)
+		{
+			return;
+		}
+		g_spool.running = false;
+	}
+	g_spool.condition.notify_one();
+	if (g_spool.thread.joinable())
+	{
+		g_spool.thread.join();
+	}
+	g_spool.records.clear();
+}
+
+std::string SurfGlobalService::MakeIdempotencyKey(u64 steamID)
+{
+	char key[64];
+	V_snprintf(key, sizeof(key), "%016llx-%llu-%u", g_spool.keyNonce, steamID, g_spool.keyCounter++);
+	return key;
+}
+
+bool SurfGlobalService::SpoolRecord(Json data, std::string key, SmallFunction<void(Surf::API::events::NewRecordAck &)> callback)
+{
+	if (g_spool.records.size() >= g_spool.maxRecords)
+	{
+		META_CONPRINTF("[Surf::Global] Record spool is full (%u records), record %s will not be retried.\n", g_spool.maxRecords, key.c_str());
+		if (SurfGlobalService::state.load() != State::HandshakeCompleted)
+		{
+			return false;
+		}
+		// clang-format off
+		return SurfGlobalService::SendMessage("new-record", data, [callback = std::move(callback)](Surf::API::events::NewRecordAck &ack) mutable
+		{
+			callback(ack);
+		});
+		// clang-format on
+	}
+
+	SpooledRecord &record = g_spool.records.emplace_back();
+	record.key = std::move(key);
+	record.data = std::move(data);
+	record.callback = std::move(callback);
+	Spool_Write({Spool_MakeRecordLine(record)});
+
+	SurfGlobalService::DrainSpool();
+	return g_spool.records.back().inFlight;
+}
+
+void SurfGlobalService::DrainSpool()
+{
+	if (g_spool.records.empty() || SurfGlobalService::state.load() != State::HandshakeCompleted)
+	{
+		return;
+	}
+
+	// Token bucket, at most one second worth of records can be sent at once.
+	f64 now = Plat_FloatTime();
+	g_spool.tokens = MIN(g_spool.tokens + (now - g_spool.lastDrainTime) * g_spool.drainRate, MAX(g_spool.drainRate, 1.0));
+	g_spool.lastDrainTime = now;
+
+	u32 inFlight = 0;
+	for (SpooledRecord &record : g_spool.records)
+	{
+		if (record.inFlight && now - record.sentAt > SPOOL_RESEND_TIMEOUT)
+		{
+			record.inFlight = false;
+		}
+		if (record.inFlight)
+		{
+			inFlight++;
+			continue;
+		}
+		// Stop at the first record that can't be sent so records go out in order.
+		if (g_spool.tokens < 1.0 || inFlight >= SPOOL_MAX_IN_FLIGHT)
+		{
+			break;
+		}
+
+		// clang-format off
+		bool sent = SurfGlobalService::SendMessage("new-record", record.data, [key = record.key](Surf::API::events::NewRecordAck &ack)
+		{
+			SurfGlobalService::AcknowledgeSpooledRecord(key, ack);
+		});
+		// clang-format on
+
+		if (!sent)
+		{
+			break;
+		}
+		record.inFlight = true;
+		record.sentAt = now;
+		g_spool.tokens -= 1.0;
+		inFlight++;
+	}
+}
+
+void SurfGlobalService::ResetSpoolInFlight()
+{
+	// Responses to anything sent over the previous connection will never arrive.
+	for (SpooledRecord &record : g_spool.records)
+	{
+		record.inFlight = false;
+	}
+}
+
+void SurfGlobalService::AcknowledgeSpooledRecord(const std::string &key, Surf::API::events::NewRecordAck &ack)
+{
+	auto found = std::find_if(g_spool.records.begin(), g_spool.records.end(), [&](const SpooledRecord &record) { return record.key == key; });
+	if (found == g_spool.records.end())
+	{
+		// Sent twice and already acknowledged.
+		return;
+	}
+
+	SmallFunction<void(Surf::API::events::NewRecordAck &)> callback = std::move(found->callback);
+	g_spool.records.erase(found);
+
+	Json line;
+	line.Set("type", "ack");
+	line.Set("key", key);
+	Spool_Write({line.ToString()});
+	if (g_spool.records.empty())
+	{
+		Spool_Write({"", true});
+	}
+
+	if (callback)
+	{
+		callback(ack);
+	}
+}
+
+void SurfGlobalService::PrintSpoolStats()
+{
+	u32 inFlight = 0;
+	for (const SpooledRecord &record : g_spool.records)
+	{
+		inFlight += record.inFlight;
+	}
+	META_CONPRINTF("[Surf::Global] %u records waiting for acknowledgement (%u in flight), draining at %.1f/s.\n", (u32)g_spool.records.size(),
+				   inFlight, g_spool.drainRate);
+}
@@ -138,10 +138,15 @@ void SurfGlobalService::Init()
 		{"Authorization", std::string("Bearer ") + key.data()},
 	});
 
+	// Only takes effect if ixwebsocket was built with zlib, otherwise the extension is never offered.
+	bool compression = SurfOptionService::GetOptionInt("apiCompression", 1) != 0;
+	SurfGlobalService::socket->setPerMessageDeflateOptions(ix::WebSocketPerMessageDeflateOptions(compression));
+
 	SurfGlobalService::socket->setOnMessageCallback(SurfGlobalService::OnWebSocketMessage);
 	SurfGlobalService::socket->start();
 
 	SurfGlobalService::EnforceConVars();
+	SurfGlobalService::LoadSpool();
 
 	SurfGlobalService::state.store(SurfGlobalService::State::Initialized);
 }
@@ -165,35 +170,64 @@ void SurfGlobalService::Cleanup()
 	}
 
 	SurfGlobalService::state.store(SurfGlobalService::State::Uninitialized);
+	SurfGlobalService::CloseSpool();
 
 	ix::uninitNetSystem();
 }
 
 void SurfGlobalService::OnServerGamePostSimulate()
 {
-	std::vector<std::function<void()>> callbacks;
+	auto &stats = SurfGlobalService::mainThreadCallbacks.stats;
+	stats.maxDepth = MAX(stats.maxDepth, SurfGlobalService::mainThreadCallbacks.queue.GetDepth());
+
+	f64 drainStart = Plat_FloatTime();
 
+	// clang-format off
+	SurfGlobalService::mainThreadCallbacks.queue.Drain([&](MainThreadCallback &entry)
 	{
-		std::unique_lock lock(SurfGlobalService::mainThreadCallbacks.mutex, std::defer_lock);
+		f64 latency = Plat_FloatTime() - entry.queuedAt;
+		stats.executed++;
+		stats.totalLatency += latency;
+		stats.maxLatency = MAX(stats.maxLatency, latency);
+		entry.callback();
+	});
+	// clang-format on
 
-		if (lock.try_lock())
-		{
-			SurfGlobalService::mainThreadCallbacks.queue.swap(callbacks);
+	if (SurfGlobalService::state.load() == SurfGlobalService::State::HandshakeCompleted
+		&& !SurfGlobalService::mainThreadCallbacks.whenConnectedQueue.empty())
+	{
+		std::vector<SmallFunction<void()>> callbacks;
+		callbacks.swap(SurfGlobalService::mainThreadCallbacks.whenConnectedQueue);
 
-			if (SurfGlobalService::state.load() == SurfGlobalService::State::HandshakeCompleted)
-			{
-				callbacks.reserve(callbacks.size() + SurfGlobalService::mainThreadCallbacks.whenConnectedQueue.size());
-				callbacks.insert(callbacks.end(), SurfGlobalService::mainThreadCallbacks.whenConnectedQueue.begin(),
-								 SurfGlobalService::mainThreadCallbacks.whenConnectedQueue.end());
-				SurfGlobalService::mainThreadCallbacks.whenConnectedQueue.clear();
-			}
+		for (SmallFunction<void()> &callback : callbacks)
+		{
+			callback();
 		}
 	}
 
-	for (const std::function<void()> &callback : callbacks)
+	stats.maxDrainTime = MAX(stats.maxDrainTime, Plat_FloatTime() - drainStart);
+
+	SurfGlobalService::DrainSpool();
+}
+
+void SurfGlobalService::PrintCallbackQueueStats(bool reset)
+{
+	auto &queue = SurfGlobalService::mainThreadCallbacks.queue;
+	auto &stats = SurfGlobalService::mainThreadCallbacks.stats;
+	f64 averageLatency = stats.executed ? stats.totalLatency / stats.executed : 0.0;
+
+	META_CONPRINTF("[Surf::Global] Main thread queue: %u/%u queued (max %u), %llu spilled.\n", queue.GetDepth(), queue.GetCapacity(), stats.maxDepth,
+				   queue.GetSpillCount());
+	META_CONPRINTF("[Surf::Global] %llu callbacks executed, latency %.3f ms average, %.3f ms max. Longest drain took %.3f ms.\n", stats.executed,
+				   averageLatency * 1000.0, stats.maxLatency * 1000.0, stats.maxDrainTime * 1000.0);
+
+	if (reset)
 	{
-		callback();
+		stats = {};
+		META_CONPRINTF("[Surf::Global] Queue statistics reset.\n");
 	}
+
+	SurfGlobalService::PrintSpoolStats();
 }
 
 void SurfGlobalService::OnActivateServer()
@@ -398,6 +432,7 @@ void SurfGlobalService::OnWebSocketMessage(const ix::WebSocketMessagePtr &messag
 		case ix::WebSocketMessageType::Open:
 		{
 			META_CONPRINTF("[Surf::Global] Connection established!\n");
+			SurfGlobalService::encoding.store(Surf::API::handshake::Encoding::JSON);
 			SurfGlobalService::state.store(SurfGlobalService::State::Connected);
 			SurfGlobalService::AddMainThreadCallback(SurfGlobalService::InitiateHandshake);
 		}
@@ -488,9 +523,16 @@ void SurfGlobalService::OnWebSocketMessage(const ix::WebSocketMessagePtr &messag
 
 		case ix::WebSocketMessageType::Message:
 		{
-			META_CONPRINTF("[Surf::Global] Received WebSocket message:\n-----\n%s\n------\n", message->str.c_str());
+			if (message->binary)
+			{
+				META_CONPRINTF("[Surf::Global] Received binary WebSocket message (%i bytes).\n", (i32)message->str.size());
+			}
+			else
+			{
+				META_CONPRINTF("[Surf::Global] Received WebSocket message:\n-----\n%s\n------\n", message->str.c_str());
+			}
 
-			Json payload(message->str);
+			Json payload = SurfGlobalService::DecodePayload(message);
 
 			switch (SurfGlobalService::state.load())
 			{
@@ -504,6 +546,9 @@ void SurfGlobalService::OnWebSocketMessage(const ix::WebSocketMessagePtr &messag
 						break;
 					}
 
+					META_CONPRINTF("[Surf::Global] Using %s encoding.\n", Surf::API::handshake::EncodingToString(helloAck.encoding));
+					SurfGlobalService::encoding.store(helloAck.encoding);
+
 					SurfGlobalService::AddMainThreadCallback([ack = std::move(helloAck)]() mutable { SurfGlobalService::CompleteHandshake(ack); });
 				}
 				break;
@@ -524,7 +569,7 @@ void SurfGlobalService::OnWebSocketMessage(const ix::WebSocketMessagePtr &messag
 						break;
 					}
 
-					SurfGlobalService::AddMainThreadCallback([=]() { SurfGlobalService::ExecuteMessageCallback(messageID, payload); });
+					SurfGlobalService::DispatchMessageCallback(messageID, payload);
 				}
 				break;
 			}
@@ -567,6 +612,29 @@ void SurfGlobalService::InitiateHandshake()
 		}
 	}
 
+	// JSON always comes last so every API can fall back to it.
+	std::string_view preferredEncoding = SurfOptionService::GetOptionStr("apiEncoding", "auto");
+
+	if (preferredEncoding == "auto")
+	{
+		data.encodings = {"msgpack", "cbor"};
+	}
+	else if (preferredEncoding != "json")
+	{
+		Surf::API::handshake::Encoding encoding;
+
+		if (Surf::API::handshake::DecodeEncodingString(preferredEncoding, encoding))
+		{
+			data.encodings.push_back(Surf::API::handshake::EncodingToString(encoding));
+		}
+		else
+		{
+			META_CONPRINTF("[Surf::Global] Unknown `apiEncoding` value, falling back to JSON.\n");
+		}
+	}
+
+	data.encodings.push_back("json");
+
 	SurfGlobalService::SendMessage(event, data);
 	SurfGlobalService::state.store(State::HandshakeInitiated);
 }
@@ -574,6 +642,7 @@ void SurfGlobalService::InitiateHandshake()
 void SurfGlobalService::CompleteHandshake(Surf::API::handshake::HelloAck &ack)
 {
 	SurfGlobalService::state.store(State::HandshakeCompleted);
+	SurfGlobalService::ResetSpoolInFlight();
 
 	// clang-format off
 	std::thread([heartbeatInterval = std::chrono::milliseconds(static_cast<i64>(ack.heartbeatInterval * 800))]()
@@ -604,23 +673,74 @@ void SurfGlobalService::CompleteHandshake(Surf::API::handshake::HelloAck &ack)
 	META_CONPRINTF("[Surf::Global] Completed handshake!\n");
 }
 
-void SurfGlobalService::ExecuteMessageCallback(u32 messageID, const Json &payload)
+void SurfGlobalService::SendPayload(const Json &payload)
 {
-	std::function<void(u32, const Json &)> callback;
+	switch (SurfGlobalService::encoding.load())
+	{
+		case Surf::API::handshake::Encoding::MessagePack:
+			SurfGlobalService::socket->sendBinary(payload.ToMsgPack());
+			break;
+
+		case Surf::API::handshake::Encoding::CBOR:
+			SurfGlobalService::socket->sendBinary(payload.ToCBOR());
+			break;
 
+		default:
+			SurfGlobalService::socket->send(payload.ToString());
+			break;
+	}
+}
+
+Json SurfGlobalService::DecodePayload(const ix::WebSocketMessagePtr &message)
+{
+	// The API may still answer with text, for example to report errors.
+	if (!message->binary)
 	{
-		std::unique_lock lock(SurfGlobalService::messageCallbacks.mutex);
-		std::unordered_map<u32, std::function<void(u32, const Json &)>> &callbacks = SurfGlobalService::messageCallbacks.queue;
+		return Json(message->str);
+	}
 
-		if (auto found = callbacks.extract(messageID); !found.empty())
-		{
-			callback = found.mapped();
-		}
+	switch (SurfGlobalService::encoding.load())
+	{
+		case Surf::API::handshake::Encoding::MessagePack:
+			return Json::FromMsgPack(message->str);
+
+		case Surf::API::handshake::Encoding::CBOR:
+			return Json::FromCBOR(message->str);
+
+		default:
+			return Json(message->str);
+	}
+}
+
+void SurfGlobalService::DispatchMessageCallback(u32 messageID, const Json &payload)
+{
+	std::unordered_map<u32, MessageCallback> &callbacks = SurfGlobalService::messageCallbacks.callbacks;
+
+	// Callbacks are registered before their message is sent, so the one we're looking for is in here if it isn't in the map yet.
+	// clang-format off
+	SurfGlobalService::messageCallbacks.pending.Drain([&](PendingMessageCallback &pending)
+	{
+		callbacks[pending.messageID] = std::move(pending.callback);
+	});
+	// clang-format on
+
+	auto found = callbacks.extract(messageID);
+
+	if (found.empty())
+	{
+		return;
 	}
 
+	SmallFunction<void()> callback = found.mapped()(payload);
+
 	if (callback)
 	{
-		META_CONPRINTF("[Surf::Global] Executing callback #%i\n", messageID);
-		callback(messageID, payload);
+		// clang-format off
+		SurfGlobalService::AddMainThreadCallback([messageID, callback = std::move(callback)]() mutable
+		{
+			META_CONPRINTF("[Surf::Global] Executing callback #%i\n", messageID);
+			callback();
+		});
+		// clang-format on
 	}
 }
@@ -10,6 +10,7 @@
 #include <vendor/ixwebsocket/ixwebsocket/IXWebSocket.h>
 
 #include "utils/json.h"
+#include "utils/mpsc_queue.h"
 
 #include "surf/surf.h"
 #include "surf/global/api.h"
@@ -17,6 +18,14 @@
 #include "surf/global/events.h"
 #include "surf/timer/announce.h"
 
+// Ring sizes of the lock-free callback queues. Bursts beyond this still work, but take a lock.
+#define SURF_GLOBAL_CALLBACK_QUEUE_SIZE         1024
+#define SURF_GLOBAL_MESSAGE_CALLBACK_QUEUE_SIZE 256
+
+// Defaults for the record spool, see spool.cpp.
+#define SURF_GLOBAL_SPOOL_DEFAULT_DRAIN_RATE  5.0
+#define SURF_GLOBAL_SPOOL_DEFAULT_MAX_RECORDS 10000
+
 class SurfGlobalService : public SurfBaseService
 {
 	using SurfBaseService::SurfBaseService;
@@ -94,6 +103,11 @@ public:
 	static void OnServerGamePostSimulate();
 	static void OnActivateServer();
 
+	/**
+	 * Prints the depth and drain latency counters of the main thread callback queue.
+	 */
+	static void PrintCallbackQueueStats(bool reset);
+
 public:
 	void OnPlayerAuthorized();
 	void OnClientDisconnect();
@@ -113,6 +127,7 @@ public:
 	{
 		/**
 		 * We are not connected to the API and also won't connect later.
+		 * The record is kept in the spool and submitted after the next successful connection.
 		 */
 		NotConnected,
 
@@ -122,12 +137,13 @@ public:
 		PlayerNotAuthenticated,
 
 		/**
-		 * The current map is not global.
+		 * The current map is not global, or its information wasn't received yet. Nothing is spooled then, the record has no
+		 * filter to be submitted with.
 		 */
 		MapNotGlobal,
 
 		/**
-		 * We are not currently connected to the API, but we queued up the record to be submitted later (if possible).
+		 * The record was spooled and will be submitted once we are connected and older records went through.
 		 */
 		Queued,
 
@@ -168,19 +184,20 @@ public:
 		data.time = time;
 		data.metadata = metadata;
 
-		switch (SurfGlobalService::state.load())
-		{
-			case SurfGlobalService::State::HandshakeCompleted:
-				SurfGlobalService::SendMessage("new-record", data, cb);
-				return SubmitRecordResult::Submitted;
+		std::string idempotencyKey = SurfGlobalService::MakeIdempotencyKey(data.playerID);
+		data.idempotencyKey = idempotencyKey;
 
-			case SurfGlobalService::State::Disconnected:
-				return SubmitRecordResult::NotConnected;
+		if (SurfGlobalService::SpoolRecord(Json(data), std::move(idempotencyKey), std::forward<CB>(cb)))
+		{
+			return SubmitRecordResult::Submitted;
+		}
 
-			default:
-				SurfGlobalService::AddMainThreadCallback([=]() { SurfGlobalService::SendMessage("new-record", data, cb); });
-				return SubmitRecordResult::Queued;
+		if (SurfGlobalService::state.load() == SurfGlobalService::State::Disconnected)
+		{
+			return SubmitRecordResult::NotConnected;
 		}
+
+		return SubmitRecordResult::Queued;
 	}
 
 	/**
@@ -280,24 +297,54 @@ private:
 	 */
 	static inline std::atomic<State> state = State::Uninitialized;
 
-	static inline struct
+	struct MainThreadCallback
 	{
-		std::mutex mutex;
+		SmallFunction<void()> callback;
+
+		/**
+		 * `Plat_FloatTime()` at the time the callback was queued
+		 */
+		f64 queuedAt;
+	};
 
+	static inline struct
+	{
 		/**
 		 * Callbacks to execute on the main thread as soon as possible
 		 */
-		std::vector<std::function<void()>> queue;
+		MPSCQueue<MainThreadCallback, SURF_GLOBAL_CALLBACK_QUEUE_SIZE> queue;
 
 		/**
 		 * Callbacks to execute on the main thread as soon as we are fully connected to the API
+		 *
+		 * Only accessed from the main thread.
+		 */
+		std::vector<SmallFunction<void()>> whenConnectedQueue;
+
+		/**
+		 * Counters for `surf_global_queue_stats`, only accessed from the main thread.
 		 */
-		std::vector<std::function<void()>> whenConnectedQueue;
+		struct
+		{
+			u32 maxDepth;
+			u64 executed;
+			f64 totalLatency;
+			f64 maxLatency;
+			f64 maxDrainTime;
+		} stats;
 	} mainThreadCallbacks {};
 
 	// invariant: should be `nullptr` if `state == Uninitialized` and otherwise a valid pointer
 	static inline ix::WebSocket *socket = nullptr;
 
+	/**
+	 * The encoding the API picked in `HelloAck`, JSON until then.
+	 *
+	 * Written on the WebSocket thread as soon as `HelloAck` is decoded, so responses
+	 * to our first messages are already decoded correctly.
+	 */
+	static inline std::atomic<Surf::API::handshake::Encoding> encoding = Surf::API::handshake::Encoding::JSON;
+
 	/**
 	 * The ID we'll use for the next message we send to the API.
 	 */
@@ -306,13 +353,29 @@ private:
 	/**
 	 * Callbacks to execute when we receive responses to messages we sent earlier.
 	 *
-	 * The key is the message ID we're looking for, and the callback will be
-	 * invoked with that message ID and the payload.
+	 * The key is the message ID we're looking for. The callback is invoked on the
+	 * WebSocket thread with the payload, decodes it, and returns the function that
+	 * should run on the main thread with the decoded response.
 	 */
+	using MessageCallback = SmallFunction<SmallFunction<void()>(const Json &)>;
+
+	struct PendingMessageCallback
+	{
+		u32 messageID;
+		MessageCallback callback;
+	};
+
 	static inline struct
 	{
-		std::mutex mutex;
-		std::unordered_map<u32, std::function<void(u32, const Json &)>> queue;
+		/**
+		 * Callbacks that were registered but haven't been moved into `callbacks` yet.
+		 */
+		MPSCQueue<PendingMessageCallback, SURF_GLOBAL_MESSAGE_CALLBACK_QUEUE_SIZE> pending;
+
+		/**
+		 * Only accessed from the WebSocket thread.
+		 */
+		std::unordered_map<u32, MessageCallback> callbacks;
 	} messageCallbacks {};
 
 	/**
@@ -345,6 +408,32 @@ private:
 	static void EnforceConVars();
 	static void RestoreConVars();
 
+	/**
+	 * Record spool, see spool.cpp. Everything but `LoadSpool()` and `CloseSpool()` has to be called from the main thread.
+	 */
+	static void LoadSpool();
+	static void CloseSpool();
+	static std::string MakeIdempotencyKey(u64 steamID);
+
+	/**
+	 * Appends a record to the spool and sends it right away if nothing is holding it back.
+	 *
+	 * Returns whether the record was sent.
+	 */
+	static bool SpoolRecord(Json data, std::string key, SmallFunction<void(Surf::API::events::NewRecordAck &)> callback);
+
+	/**
+	 * Sends spooled records, as many as the drain rate allows.
+	 */
+	static void DrainSpool();
+
+	/**
+	 * Marks every spooled record as unsent, for when we reconnected.
+	 */
+	static void ResetSpoolInFlight();
+	static void AcknowledgeSpooledRecord(const std::string &key, Surf::API::events::NewRecordAck &ack);
+	static void PrintSpoolStats();
+
 	/**
 	 * Callback we pass to `IXWebSocket`.
 	 *
@@ -372,38 +461,47 @@ private:
 	template<typename CB>
 	static void AddMainThreadCallback(CB &&callback)
 	{
-		std::unique_lock lock(SurfGlobalService::mainThreadCallbacks.mutex);
-		SurfGlobalService::mainThreadCallbacks.queue.emplace_back(std::move(callback));
+		SurfGlobalService::mainThreadCallbacks.queue.Push({std::forward<CB>(callback), Plat_FloatTime()});
 	}
 
 	/**
 	 * Queues a callback to be executed on the main thread as soon as we have an established connection to the API.
+	 *
+	 * Has to be called from the main thread.
 	 */
 	template<typename CB>
 	static void AddWhenConnectedCallback(CB &&callback)
 	{
-		std::unique_lock lock(SurfGlobalService::mainThreadCallbacks.mutex);
-		SurfGlobalService::mainThreadCallbacks.whenConnectedQueue.emplace_back(std::move(callback));
+		SurfGlobalService::mainThreadCallbacks.whenConnectedQueue.emplace_back(std::forward<CB>(callback));
 	}
 
 	/**
 	 * Queues a callback to be executed when we receive a message with the given ID.
 	 *
-	 * The callback will be executed on the main thread.
+	 * The callback will be executed on the WebSocket thread.
 	 */
 	template<typename CB>
 	static void AddMessageCallback(u32 messageID, CB &&callback)
 	{
-		std::unique_lock lock(SurfGlobalService::messageCallbacks.mutex);
-		SurfGlobalService::messageCallbacks.queue[messageID] = std::move(callback);
+		SurfGlobalService::messageCallbacks.pending.Push({messageID, std::forward<CB>(callback)});
 	}
 
 	/**
-	 * Executes the callback with the given ID, if any.
+	 * Decodes a response with the callback registered for its ID, if any, and queues the result for the main thread.
 	 *
-	 * The callback will be executed on the main thread.
+	 * Has to be called from the WebSocket thread.
 	 */
-	static void ExecuteMessageCallback(u32 messageID, const Json &payload);
+	static void DispatchMessageCallback(u32 messageID, const Json &payload);
+
+	/**
+	 * Sends a prepared message in the negotiated encoding.
+	 */
+	static void SendPayload(const Json &payload);
+
+	/**
+	 * Decodes a message we received from the API. Binary messages use the negotiated encoding.
+	 */
+	static Json DecodePayload(const ix::WebSocketMessagePtr &message);
 
 	/**
 	 * Prepares a message to be sent to the API.
@@ -462,7 +560,7 @@ private:
 			return false;
 		}
 
-		SurfGlobalService::socket->send(payload.ToString());
+		SurfGlobalService::SendPayload(payload);
 		return true;
 	}
 
@@ -481,27 +579,22 @@ private:
 		}
 
 		// clang-format off
-		SurfGlobalService::AddMessageCallback(messageID, [callback = std::move(callback)](u32 messageID, const Json& payload)
+		// Decoding happens on the WebSocket thread, the main thread only gets the finished struct.
+		SurfGlobalService::AddMessageCallback(messageID, [callback = std::move(callback)](const Json& payload) mutable -> SmallFunction<void()>
 		{
-			if (!payload.IsValid())
-			{
-				META_CONPRINTF("[Surf::Global] WebSocket message is not valid JSON.\n");
-				return;
-			}
-
 			std::remove_reference_t<typename decltype(std::function(callback))::argument_type> decoded;
 
 			if (!payload.Get("data", decoded))
 			{
 				META_CONPRINTF("[Surf::Global] WebSocket message does not contain a valid `data` field.\n");
-				return;
+				return {};
 			}
 
-			callback(decoded);
+			return [callback = std::move(callback), decoded = std::move(decoded)]() mutable { callback(decoded); };
 		});
 		// clang-format on
 
-		SurfGlobalService::socket->send(payload.ToString());
+		SurfGlobalService::SendPayload(payload);
 		return true;
 	}
 };
@@ -16,13 +16,13 @@ bool SurfGotoService::GotoPlayer(const char *playerNamePart)
 {
 	if (!playerNamePart || !V_stricmp("", playerNamePart))
 	{
-		player->languageService->PrintChat(true, false, "Goto - Command Usage");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Goto - Command Usage"));
 		return false;
 	}
 
 	if (this->player->timerService->GetTimerRunning())
 	{
-		this->player->languageService->PrintChat(true, false, "Goto - Error Message (Timer Running)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Goto - Error Message (Timer Running)"));
 		return false;
 	}
 
@@ -40,7 +40,7 @@ bool SurfGotoService::GotoPlayer(const char *playerNamePart)
 		{
 			if (otherPlayer->GetController()->GetTeam() == CS_TEAM_SPECTATOR)
 			{
-				this->player->languageService->PrintChat(true, false, "Goto - Error Message (Player In Spec)", otherPlayer->GetName());
+				this->player->languageService->PrintChat(true, false, SURF_PHRASE("Goto - Error Message (Player In Spec)"), otherPlayer->GetName());
 				return false;
 			}
 
@@ -68,7 +68,7 @@ bool SurfGotoService::GotoPlayer(const char *playerNamePart)
 			otherPlayer->GetAngles(&angles);
 
 			this->player->GetPlayerPawn()->Teleport(&origin, &angles, &NULL_VECTOR);
-			this->player->languageService->PrintChat(true, false, "Goto - Teleported", otherPlayer->GetName());
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Goto - Teleported"), otherPlayer->GetName());
 			if (this->player->GetPlayerPawn()->m_Collision().m_CollisionGroup() != SURF_COLLISION_GROUP_STANDARD)
 			{
 				this->player->GetPlayerPawn()->m_Collision().m_CollisionGroup() = SURF_COLLISION_GROUP_STANDARD;
@@ -78,7 +78,7 @@ bool SurfGotoService::GotoPlayer(const char *playerNamePart)
 		}
 	}
 
-	player->languageService->PrintChat(true, false, "Error Message (Player Not Found)", playerNamePart);
+	player->languageService->PrintChat(true, false, SURF_PHRASE("Error Message (Player Not Found)"), playerNamePart);
 	return false;
 }
 
@@ -13,6 +13,23 @@
 
 #define HUD_ON_GROUND_THRESHOLD 0.07f
 
+struct RenderedPanels
+{
+	SurfLanguageService::LanguageID language;
+	std::string centerText;
+	std::string alertText;
+	std::string htmlText;
+};
+
+// Panels rendered this tick per observed player, shared by everyone watching them with the same language. Main thread only.
+static_global struct
+{
+	i32 tick = -1;
+	u32 count;
+	// Kept across ticks so the strings keep their buffers.
+	std::vector<RenderedPanels> panels;
+} g_renderedPanels[MAXPLAYERS + 1];
+
 static_global class SurfTimerServiceEventListener_HUD : public SurfTimerServiceEventListener
 {
 	virtual void OnTimerStopped(SurfPlayer *player, u32 courseGUID) override;
@@ -38,9 +55,47 @@ void SurfHUDService::Reset()
 	this->showPanel = this->player->optionService->GetPreferenceBool("showPanel", true);
 	this->timerStoppedTime = {};
 	this->currentTimeWhenTimerStopped = {};
+	this->ResetSentPanels();
+	// Whatever was rendered belonged to whoever had the slot before.
+	g_renderedPanels[this->player->index].tick = -1;
 }
 
-std::string SurfHUDService::GetSpeedText(const char *language)
+bool SurfHUDService::ShouldSendPanel(PanelType type, const std::string &text)
+{
+	auto &last = this->lastSentPanels[type];
+	if (text.empty())
+	{
+		// Nothing is sent, make sure the next panel goes out right away.
+		last.text.clear();
+		last.time = 0.0;
+		return false;
+	}
+	f64 now = g_pSurfUtils->GetServerGlobals()->curtime;
+	f64 elapsed = now - last.time;
+	// The time goes back on map change.
+	if (elapsed >= 0.0)
+	{
+		bool changed = text != last.text;
+		if (elapsed < (changed ? SURF_HUD_PANEL_MIN_INTERVAL : SURF_HUD_PANEL_REFRESH_INTERVAL))
+		{
+			return false;
+		}
+	}
+	last.text = text;
+	last.time = now;
+	return true;
+}
+
+void SurfHUDService::ResetSentPanels()
+{
+	for (auto &last : this->lastSentPanels)
+	{
+		last.text.clear();
+		last.time = 0.0;
+	}
+}
+
+std::string SurfHUDService::GetSpeedText(SurfLanguageService::LanguageID language)
 {
 	Vector velocity, baseVelocity;
 	this->player->GetVelocity(&velocity);
@@ -51,17 +106,17 @@ std::string SurfHUDService::GetSpeedText(const char *language)
 		 && g_pSurfUtils->GetServerGlobals()->curtime - this->player->landingTime > HUD_ON_GROUND_THRESHOLD)
 		|| (this->player->GetPlayerPawn()->m_MoveType == MOVETYPE_LADDER && !player->IsButtonPressed(IN_JUMP)))
 	{
-		return SurfLanguageService::PrepareMessageWithLang(language, "HUD - Speed Text", velocity.Length2D());
+		return SurfLanguageService::PrepareMessageWithLang(language, SURF_PHRASE("HUD - Speed Text"), velocity.Length2D());
 	}
-	return SurfLanguageService::PrepareMessageWithLang(language, "HUD - Speed Text (Takeoff)", velocity.Length2D(),
+	return SurfLanguageService::PrepareMessageWithLang(language, SURF_PHRASE("HUD - Speed Text (Takeoff)"), velocity.Length2D(),
 													   this->player->takeoffVelocity.Length2D());
 }
 
-std::string SurfHUDService::GetKeyText(const char *language)
+std::string SurfHUDService::GetKeyText(SurfLanguageService::LanguageID language)
 {
 	// clang-format off
 
-	return SurfLanguageService::PrepareMessageWithLang(language, "HUD - Key Text",
+	return SurfLanguageService::PrepareMessageWithLang(language, SURF_PHRASE("HUD - Key Text"),
 		this->player->IsButtonPressed(IN_MOVELEFT) ? 'A' : '_',
 		this->player->IsButtonPressed(IN_FORWARD) ? 'W' : '_',
 		this->player->IsButtonPressed(IN_BACK) ? 'S' : '_',
@@ -73,19 +128,19 @@ std::string SurfHUDService::GetKeyText(const char *language)
 	// clang-format on
 }
 
-std::string SurfHUDService::GetStageText(const char *language)
+std::string SurfHUDService::GetStageText(SurfLanguageService::LanguageID language)
 {
 	// clang-format off
 
 	int stage = this->player->timerService->GetStage();
 	return stage > 0 
-		? SurfLanguageService::PrepareMessageWithLang(language, "HUD - Stage Text", stage)
+		? SurfLanguageService::PrepareMessageWithLang(language, SURF_PHRASE("HUD - Stage Text"), stage)
 		: "";
 
 	// clang-format on
 }
 
-std::string SurfHUDService::GetTimerText(const char *language)
+std::string SurfHUDService::GetTimerText(SurfLanguageService::LanguageID language)
 {
 	if (this->player->timerService->GetTimerRunning() || this->ShouldShowTimerAfterStop())
 	{
@@ -99,23 +154,53 @@ std::string SurfHUDService::GetTimerText(const char *language)
 
 
 		SurfTimerService::FormatTime(time, timeText, sizeof(timeText));
-		return SurfLanguageService::PrepareMessageWithLang(language, "HUD - Timer Text",
+		return SurfLanguageService::PrepareMessageWithLang(language, SURF_PHRASE("HUD - Timer Text"),
 			timeText,
-			player->timerService->GetTimerRunning() ? "" : SurfLanguageService::PrepareMessageWithLang(language, "HUD - Stopped Text").c_str(),
-			player->timerService->GetPaused() ? SurfLanguageService::PrepareMessageWithLang(language, "HUD - Paused Text").c_str() : ""
+			player->timerService->GetTimerRunning() ? "" : SurfLanguageService::PrepareMessageWithLang(language, SURF_PHRASE("HUD - Stopped Text")).c_str(),
+			player->timerService->GetPaused() ? SurfLanguageService::PrepareMessageWithLang(language, SURF_PHRASE("HUD - Paused Text")).c_str() : ""
 		);
 		// clang-format on
 	}
 	return std::string("");
 }
 
-void SurfHUDService::DrawPanels(SurfPlayer *player, SurfPlayer *target)
+static_function void HUD_TrimNewlines(std::string &str)
 {
-	if (!target->hudService->IsShowingPanel())
+	// Remove leading newlines
+	size_t start = str.find_first_not_of('\n');
+	if (start == std::string::npos)
 	{
+		str.clear();
 		return;
 	}
-	const char *language = target->languageService->GetLanguage();
+	// Remove trailing newlines
+	size_t end = str.find_last_not_of('\n');
+	str.erase(end + 1);
+	str.erase(0, start);
+}
+
+const RenderedPanels &SurfHUDService::RenderPanels(SurfPlayer *player, SurfLanguageService::LanguageID language)
+{
+	auto &cache = g_renderedPanels[player->index];
+	i32 tick = g_pSurfUtils->GetServerGlobals()->tickcount;
+	if (cache.tick != tick)
+	{
+		cache.tick = tick;
+		cache.count = 0;
+	}
+	for (u32 i = 0; i < cache.count; i++)
+	{
+		if (cache.panels[i].language == language)
+		{
+			return cache.panels[i];
+		}
+	}
+	if (cache.count == cache.panels.size())
+	{
+		cache.panels.emplace_back();
+	}
+	RenderedPanels &panels = cache.panels[cache.count++];
+	panels.language = language;
 
 	std::string keyText = player->hudService->GetKeyText(language);
 	std::string timerText = player->hudService->GetTimerText(language);
@@ -123,45 +208,41 @@ void SurfHUDService::DrawPanels(SurfPlayer *player, SurfPlayer *target)
 	std::string stageText = player->hudService->GetStageText(language);
 
 	// clang-format off
-	std::string centerText = SurfLanguageService::PrepareMessageWithLang(language, "HUD - Center Text", 
+	panels.centerText = SurfLanguageService::RenderMessageWithLang(language, SURF_PHRASE("HUD - Center Text"), 
 		keyText.c_str(), stageText.c_str(), timerText.c_str(), speedText.c_str());
-	std::string alertText = SurfLanguageService::PrepareMessageWithLang(language, "HUD - Alert Text", 
+	panels.alertText = SurfLanguageService::RenderMessageWithLang(language, SURF_PHRASE("HUD - Alert Text"), 
 		keyText.c_str(), stageText.c_str(), timerText.c_str(), speedText.c_str());
-	std::string htmlText = SurfLanguageService::PrepareMessageWithLang(language, "HUD - Html Center Text",
+	panels.htmlText = SurfLanguageService::RenderMessageWithLang(language, SURF_PHRASE("HUD - Html Center Text"),
 		keyText.c_str(), stageText.c_str(), timerText.c_str(), speedText.c_str());
 
 	// clang-format on
 
-	auto trimNewlines = [](std::string &str)
-	{
-		// Remove leading newlines
-		size_t start = str.find_first_not_of('\n');
-		if (start == std::string::npos)
-		{
-			str.clear();
-			return;
-		}
-		// Remove trailing newlines
-		size_t end = str.find_last_not_of('\n');
-		str = str.substr(start, end - start + 1);
-	};
+	// Remove leading & trailing newlines just in case a line is empty.
+	HUD_TrimNewlines(panels.centerText);
+	HUD_TrimNewlines(panels.alertText);
+	HUD_TrimNewlines(panels.htmlText);
+	return panels;
+}
 
-	trimNewlines(centerText);
-	trimNewlines(alertText);
-	trimNewlines(htmlText);
+void SurfHUDService::DrawPanels(SurfPlayer *player, SurfPlayer *target)
+{
+	if (!target->hudService->IsShowingPanel())
+	{
+		return;
+	}
+	const RenderedPanels &panels = SurfHUDService::RenderPanels(player, target->languageService->GetLanguageID());
 
-	// Remove leading & trailing newlines just in case a line is empty.
-	if (!centerText.empty())
+	if (target->hudService->ShouldSendPanel(PANEL_CENTRE, panels.centerText))
 	{
-		target->PrintCentre(false, false, centerText.c_str());
+		target->PrintCentre(false, false, panels.centerText.c_str());
 	}
-	if (!alertText.empty())
+	if (target->hudService->ShouldSendPanel(PANEL_ALERT, panels.alertText))
 	{
-		target->PrintAlert(false, false, alertText.c_str());
+		target->PrintAlert(false, false, panels.alertText.c_str());
 	}
-	if (!htmlText.empty())
+	if (target->hudService->ShouldSendPanel(PANEL_HTML, panels.htmlText))
 	{
-		target->PrintHTMLCentre(false, false, htmlText.c_str());
+		target->PrintHTMLCentre(false, false, panels.htmlText.c_str());
 	}
 }
 
@@ -174,11 +255,12 @@ void SurfHUDService::TogglePanel()
 {
 	this->showPanel = !this->showPanel;
 	this->player->optionService->SetPreferenceBool("showPanel", this->showPanel);
+	this->ResetSentPanels();
 	if (!this->showPanel)
 	{
 		utils::PrintAlert(this->player->GetController(), "#SFUI_EmptyString");
 		utils::PrintCentre(this->player->GetController(), "#SFUI_EmptyString");
-		this->player->languageService->PrintHTMLCentre(false, false, "HUD - HTML Panel Disabled");
+		this->player->languageService->PrintHTMLCentre(false, false, SURF_PHRASE("HUD - HTML Panel Disabled"));
 	}
 }
 
@@ -209,11 +291,11 @@ SCMD(surf_panel, SCFL_HUD)
 	player->hudService->TogglePanel();
 	if (player->hudService->IsShowingPanel())
 	{
-		player->languageService->PrintChat(true, false, "HUD Option - Info Panel - Enable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("HUD Option - Info Panel - Enable"));
 	}
 	else
 	{
-		player->languageService->PrintChat(true, false, "HUD Option - Info Panel - Disable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("HUD Option - Info Panel - Disable"));
 	}
 	return MRES_SUPERCEDE;
 }
@@ -1,8 +1,15 @@
 #pragma once
 #include "../surf.h"
 #include "../timer/surf_timer.h"
+#include "../language/surf_language.h"
 
 #define SURF_HUD_TIMER_STOPPED_GRACE_TIME 3.0f
+// An unchanged panel is sent again this often so it doesn't fade out, the HTML panel lasts a second.
+#define SURF_HUD_PANEL_REFRESH_INTERVAL 0.5f
+// A changed panel isn't sent more often than this, the client doesn't show updates any faster.
+#define SURF_HUD_PANEL_MIN_INTERVAL 0.03f
+
+struct RenderedPanels;
 
 class SurfHUDService : public SurfBaseService
 {
@@ -13,12 +20,32 @@ private:
 	f64 timerStoppedTime {};
 	f64 currentTimeWhenTimerStopped {};
 
+	enum PanelType : u8
+	{
+		PANEL_CENTRE,
+		PANEL_ALERT,
+		PANEL_HTML,
+		PANELTYPE_COUNT
+	};
+
+	// What this player was last sent, to skip messages that wouldn't change anything.
+	struct
+	{
+		std::string text;
+		f64 time {};
+	} lastSentPanels[PANELTYPE_COUNT];
+
+	bool ShouldSendPanel(PanelType type, const std::string &text);
+	void ResetSentPanels();
+
 public:
 	virtual void Reset() override;
 	static void Init();
 
 	// Draw the panel from a player to a specific target.
 	static void DrawPanels(SurfPlayer *player, SurfPlayer *target);
+	// Panels of a player in a language, rendered at most once per tick.
+	static const RenderedPanels &RenderPanels(SurfPlayer *player, SurfLanguageService::LanguageID language);
 
 	void ResetShowPanel();
 	void TogglePanel();
@@ -37,8 +64,8 @@ public:
 	}
 
 private:
-	std::string GetSpeedText(const char *language = SURF_DEFAULT_LANGUAGE);
-	std::string GetKeyText(const char *language = SURF_DEFAULT_LANGUAGE);
-	std::string GetTimerText(const char *language = SURF_DEFAULT_LANGUAGE);
-	std::string GetStageText(const char *language = SURF_DEFAULT_LANGUAGE);
+	std::string GetSpeedText(SurfLanguageService::LanguageID language);
+	std::string GetKeyText(SurfLanguageService::LanguageID language);
+	std::string GetTimerText(SurfLanguageService::LanguageID language);
+	std::string GetStageText(SurfLanguageService::LanguageID language);
 };
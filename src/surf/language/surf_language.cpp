@@ -9,6 +9,10 @@
 #include "surf/checkpoint/surf_checkpoint.h"
 #include "surf/timer/surf_timer.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include <vendor/ClientCvarValue/public/iclientcvarvalue.h>
 #include <vendor/MultiAddonManager/public/imultiaddonmanager.h>
 
@@ -28,6 +32,278 @@ static_global KeyValues *translationKV;
 static_global KeyValues *languagesKV;
 static_global KeyValues *addonsKV;
 
+/*
+	Phrase table. Phrase names are interned into IDs that never change, so hot paths can look them up once. Every translation
+	is compiled into tokens, each either literal text or one argument of the phrase with its format. The token lists live in one
+	flat table indexed by (phrase ID, language ID), filled with the default language where a translation is missing, and all of
+	their text is kept in a single buffer. Main thread only.
+*/
+
+struct CompiledTranslation
+{
+	u32 firstToken;
+	u32 tokenCount;
+};
+
+// Marks a translation that wasn't compiled yet.
+#define TRANSLATION_MISSING 0xFFFFFFFF
+
+// Hashes always have bit 0 set, a hash of 0 marks an empty slot.
+struct PhraseSlot
+{
+	u32 hash;
+	SurfLanguageService::PhraseID id;
+};
+
+static_global struct
+{
+	std::vector<std::string> names;
+	// Open addressing on the case insensitive hash of the name, never more than half full.
+	std::vector<PhraseSlot> slots;
+
+	std::vector<std::string> languages;
+	u32 defaultLanguage;
+	// Number of phrases the translations were compiled for, phrases interned later have none.
+	u32 compiledCount;
+	// Per phrase.
+	std::vector<bool> exists;
+	// Tokens of every translation, per phrase and language.
+	std::vector<CompiledTranslation> translations;
+	std::vector<SurfLanguageService::PhraseToken> tokens;
+	std::string text;
+} g_phrases;
+
+static_function u32 Language_HashPhrase(const char *phrase)
+{
+	// FNV-1a, folded to lower case like KeyValues lookups.
+	u32 hash = 2166136261u;
+	for (const char *c = phrase; *c; c++)
+	{
+		hash ^= (u8)tolower((u8)*c);
+		hash *= 16777619u;
+	}
+	return hash | 1;
+}
+
+static_function bool Language_FindPhrase(const char *phrase, u32 hash, u32 &slot)
+{
+	if (g_phrases.slots.empty())
+	{
+		return false;
+	}
+	u32 mask = g_phrases.slots.size() - 1;
+	for (slot = (hash >> 1) & mask; g_phrases.slots[slot].hash != 0; slot = (slot + 1) & mask)
+	{
+		if (g_phrases.slots[slot].hash == hash && SURF_STREQI(g_phrases.names[g_phrases.slots[slot].id].c_str(), phrase))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static_function void Language_InsertSlot(u32 hash, SurfLanguageService::PhraseID id)
+{
+	u32 mask = g_phrases.slots.size() - 1;
+	u32 slot = (hash >> 1) & mask;
+	while (g_phrases.slots[slot].hash != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+	g_phrases.slots[slot] = {hash, id};
+}
+
+static_function SurfLanguageService::PhraseID Language_InternPhrase(const char *phrase)
+{
+	u32 hash = Language_HashPhrase(phrase);
+	u32 slot;
+	if (Language_FindPhrase(phrase, hash, slot))
+	{
+		return g_phrases.slots[slot].id;
+	}
+	if ((g_phrases.names.size() + 1) * 2 > g_phrases.slots.size())
+	{
+		std::vector<PhraseSlot> old = std::move(g_phrases.slots);
+		g_phrases.slots.assign(MAX(old.size() * 2, (size_t)256), {0, 0});
+		for (const PhraseSlot &oldSlot : old)
+		{
+			if (oldSlot.hash != 0)
+			{
+				Language_InsertSlot(oldSlot.hash, oldSlot.id);
+			}
+		}
+	}
+	SurfLanguageService::PhraseID id = g_phrases.names.size();
+	g_phrases.names.emplace_back(phrase);
+	Language_InsertSlot(hash, id);
+	return id;
+}
+
+static_function u32 Language_FindLanguage(const char *language)
+{
+	for (u32 i = 0; i < g_phrases.languages.size(); i++)
+	{
+		if (SURF_STREQI(g_phrases.languages[i].c_str(), language))
+		{
+			return i;
+		}
+	}
+	return g_phrases.defaultLanguage;
+}
+
+static_function u32 Language_InternLanguage(const char *language)
+{
+	for (u32 i = 0; i < g_phrases.languages.size(); i++)
+	{
+		if (SURF_STREQI(g_phrases.languages[i].c_str(), language))
+		{
+			return i;
+		}
+	}
+	g_phrases.languages.emplace_back(language);
+	return g_phrases.languages.size() - 1;
+}
+
+static_function void Language_AddLiteral(std::string &literal)
+{
+	if (literal.empty())
+	{
+		return;
+	}
+	g_phrases.tokens.push_back({(u32)g_phrases.text.size(), (u32)literal.size(), -1});
+	g_phrases.text += literal;
+	literal.clear();
+}
+
+// Splits a message into literal text and the {name} arguments of the "#format" parameter list ("name:fmt,name:fmt").
+static_function CompiledTranslation Language_CompileTranslation(const char *message, const char *paramFormat)
+{
+	CompiledTranslation translation = {(u32)g_phrases.tokens.size(), 0};
+	std::string literal;
+	if (!paramFormat[0])
+	{
+		// Phrases without a #format are printed as is.
+		literal = message;
+		Language_AddLiteral(literal);
+		translation.tokenCount = g_phrases.tokens.size() - translation.firstToken;
+		return translation;
+	}
+
+	std::vector<std::pair<std::string, u32>> params;
+	for (const char *tokenStart = paramFormat; *tokenStart;)
+	{
+		const char *tokenEnd = strchr(tokenStart, ':');
+		if (!tokenEnd)
+		{
+			break;
+		}
+		const char *formatEnd = strchr(tokenEnd + 1, ',');
+		formatEnd = formatEnd ? formatEnd : tokenEnd + strlen(tokenEnd);
+		// Each argument keeps its own format, "%" followed by whatever comes after the colon.
+		params.emplace_back(std::string(tokenStart, tokenEnd - tokenStart), (u32)g_phrases.text.size());
+		g_phrases.text += '%';
+		g_phrases.text.append(tokenEnd + 1, formatEnd - tokenEnd - 1);
+		g_phrases.text += '\0';
+		tokenStart = *formatEnd ? formatEnd + 1 : formatEnd;
+	}
+
+	for (const char *c = message; *c; c++)
+	{
+		if (*c == '{')
+		{
+			const char *end = strchr(c, '}');
+			auto param = params.end();
+			if (end)
+			{
+				std::string_view name(c + 1, end - c - 1);
+				param = std::find_if(params.begin(), params.end(), [&](const auto &entry) { return entry.first == name; });
+			}
+			if (param != params.end())
+			{
+				Language_AddLiteral(literal);
+				g_phrases.tokens.push_back({param->second, 0, (i32)(param - params.begin())});
+				c = end;
+				continue;
+			}
+		}
+		// Formatted phrases used to go through printf style formatting.
+		else if (c[0] == '%' && c[1] == '%')
+		{
+			c++;
+		}
+		literal += *c;
+	}
+	Language_AddLiteral(literal);
+	translation.tokenCount = g_phrases.tokens.size() - translation.firstToken;
+	return translation;
+}
+
+// Done once per load instead of every time a message is printed.
+static_function void Language_CompilePhrases()
+{
+	g_phrases.languages.clear();
+	g_phrases.defaultLanguage = Language_InternLanguage(SURF_DEFAULT_LANGUAGE);
+	for (KeyValues *phraseKV = translationKV->GetFirstSubKey(); phraseKV; phraseKV = phraseKV->GetNextKey())
+	{
+		Language_InternPhrase(phraseKV->GetName());
+		for (KeyValues *languageKV = phraseKV->GetFirstValue(); languageKV; languageKV = languageKV->GetNextValue())
+		{
+			if (!SURF_STREQI(languageKV->GetName(), "#format"))
+			{
+				Language_InternLanguage(languageKV->GetName());
+			}
+		}
+	}
+
+	u32 languageCount = g_phrases.languages.size();
+	g_phrases.compiledCount = g_phrases.names.size();
+	g_phrases.exists.assign(g_phrases.compiledCount, false);
+	g_phrases.translations.assign(g_phrases.compiledCount * languageCount, {0, TRANSLATION_MISSING});
+	g_phrases.tokens.clear();
+	g_phrases.text.clear();
+	for (KeyValues *phraseKV = translationKV->GetFirstSubKey(); phraseKV; phraseKV = phraseKV->GetNextKey())
+	{
+		SurfLanguageService::PhraseID id = Language_InternPhrase(phraseKV->GetName());
+		// The first definition of a phrase wins, like with FindKey.
+		if (g_phrases.exists[id])
+		{
+			continue;
+		}
+		g_phrases.exists[id] = true;
+		const char *paramFormat = phraseKV->GetString("#format");
+		for (KeyValues *languageKV = phraseKV->GetFirstValue(); languageKV; languageKV = languageKV->GetNextValue())
+		{
+			const char *message = languageKV->GetString();
+			if (SURF_STREQI(languageKV->GetName(), "#format") || message[0] == '\0')
+			{
+				continue;
+			}
+			CompiledTranslation &translation = g_phrases.translations[id * languageCount + Language_FindLanguage(languageKV->GetName())];
+			if (translation.tokenCount == TRANSLATION_MISSING)
+			{
+				translation = Language_CompileTranslation(message, paramFormat);
+			}
+		}
+		// Missing translations use the default language, or an empty message if that one is missing too.
+		CompiledTranslation fallback = g_phrases.translations[id * languageCount + g_phrases.defaultLanguage];
+		if (fallback.tokenCount == TRANSLATION_MISSING)
+		{
+			fallback = {0, 0};
+		}
+		for (u32 language = 0; language < languageCount; language++)
+		{
+			CompiledTranslation &translation = g_phrases.translations[id * languageCount + language];
+			translation = translation.tokenCount == TRANSLATION_MISSING ? fallback : translation;
+		}
+	}
+
+	// Language IDs may have moved.
+	for (auto &[xuid, langInfo] : SurfLanguageService::clientLanguageInfos)
+	{
+		langInfo.languageID = Language_FindLanguage(langInfo.language);
+	}
+}
+
 void SurfLanguageService::Init()
 {
 	SurfLanguageService::LoadConfigFiles();
@@ -109,6 +385,7 @@ void SurfLanguageService::LoadTranslations()
 		} while (fileName);
 		g_pFullFileSystem->FindClose(findHandle);
 	}
+	Language_CompilePhrases();
 }
 
 void SurfLanguageService::OnPlayerPreferencesLoaded()
@@ -120,7 +397,7 @@ void SurfLanguageService::OnPlayerPreferencesLoaded()
 		SurfLanguageService::UpdateLanguage(this->player->GetSteamId64(false), language, LanguageInfo::CacheLevel::CACHE_PREF, shouldReconnect);
 		if (!shouldReconnect)
 		{
-			this->player->languageService->PrintChat(false, false, "Language Change - Manual Menu Change Required");
+			this->player->languageService->PrintChat(false, false, SURF_PHRASE("Language Change - Manual Menu Change Required"));
 		}
 	}
 }
@@ -130,6 +407,16 @@ const char *SurfLanguageService::GetLanguage()
 	return SurfLanguageService::clientLanguageInfos[this->player->GetSteamId64(false)].language;
 }
 
+SurfLanguageService::LanguageID SurfLanguageService::GetLanguageID()
+{
+	return SurfLanguageService::clientLanguageInfos[this->player->GetSteamId64(false)].languageID;
+}
+
+SurfLanguageService::LanguageID SurfLanguageService::FindLanguageID(const char *language)
+{
+	return Language_FindLanguage(language);
+}
+
 const char *SurfLanguageService::GetTranslatedFormat(const char *language, const char *phrase)
 {
 	if (!translationKV->FindKey(phrase))
@@ -151,6 +438,78 @@ const char *SurfLanguageService::GetTranslatedFormat(const char *language, const
 	return outFormat;
 }
 
+SurfLanguageService::PhraseID SurfLanguageService::GetPhraseID(const char *phrase)
+{
+	return Language_InternPhrase(phrase);
+}
+
+bool SurfLanguageService::FindPhraseID(const char *phrase, PhraseID &id)
+{
+	u32 slot;
+	if (!Language_FindPhrase(phrase, Language_HashPhrase(phrase), slot))
+	{
+		return false;
+	}
+	id = g_phrases.slots[slot].id;
+	return true;
+}
+
+const char *SurfLanguageService::GetPhraseName(PhraseID phrase)
+{
+	return g_phrases.names[phrase].c_str();
+}
+
+bool SurfLanguageService::GetCompiledPhrase(LanguageID language, PhraseID phrase, const PhraseToken *&tokens, u32 &tokenCount,
+										   const char *&text)
+{
+	if (phrase >= g_phrases.compiledCount || !g_phrases.exists[phrase])
+	{
+		return false;
+	}
+	if (language >= g_phrases.languages.size())
+	{
+		language = g_phrases.defaultLanguage;
+	}
+	const CompiledTranslation &translation = g_phrases.translations[phrase * g_phrases.languages.size() + language];
+	tokens = g_phrases.tokens.data() + translation.firstToken;
+	tokenCount = translation.tokenCount;
+	text = g_phrases.text.c_str();
+	return true;
+}
+
+// Appends whatever is written to the stream to a string, which keeps its memory between messages.
+class MessageStreamBuf : public std::streambuf
+{
+public:
+	std::string buffer;
+
+protected:
+	virtual int_type overflow(int_type c) override
+	{
+		if (c != traits_type::eof())
+		{
+			this->buffer += (char)c;
+		}
+		return c;
+	}
+
+	virtual std::streamsize xsputn(const char *s, std::streamsize count) override
+	{
+		this->buffer.append(s, count);
+		return count;
+	}
+};
+
+static_global thread_local MessageStreamBuf g_messageStreamBuf;
+static_global thread_local std::ostream g_messageStream(&g_messageStreamBuf);
+
+std::string &SurfLanguageService::BeginMessage(std::ostream *&stream)
+{
+	g_messageStreamBuf.buffer.clear();
+	stream = &g_messageStream;
+	return g_messageStreamBuf.buffer;
+}
+
 void SurfLanguageService::UpdateLanguage(u64 xuid, const char *langKey, LanguageInfo::CacheLevel cacheLevel, bool shouldReconnect)
 {
 	// Manual override > Loaded preference > Queried ConVar
@@ -179,6 +538,7 @@ void SurfLanguageService::UpdateLanguage(u64 xuid, const char *langKey, Language
 		V_strncpy(langInfo.lastAddon, addon, sizeof(langInfo.lastAddon));
 	}
 	V_strncpy(langInfo.language, langKey, sizeof(langInfo.language));
+	langInfo.languageID = Language_FindLanguage(langInfo.language);
 }
 
 void SurfLanguageService::OnPlayerConnect(u64 steamID64)
@@ -209,6 +569,7 @@ void SurfLanguageService::OnPlayerConnect(u64 steamID64)
 SurfLanguageService::LanguageInfo::LanguageInfo()
 {
 	V_strncpy(this->language, SurfOptionService::GetOptionStr("defaultLanguage", SURF_DEFAULT_LANGUAGE), sizeof(this->language));
+	this->languageID = Language_FindLanguage(this->language);
 }
 
 SCMD(surf_language, SCFL_PREFERENCE)
@@ -222,8 +583,8 @@ SCMD(surf_language, SCFL_PREFERENCE)
 	player->optionService->SetPreferenceStr("preferredLanguage", language);
 	if (!shouldReconnect)
 	{
-		player->languageService->PrintChat(true, false, "Switch Language", language);
-		player->languageService->PrintChat(false, false, "Language Change - Manual Menu Change Required");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Switch Language"), language);
+		player->languageService->PrintChat(false, false, SURF_PHRASE("Language Change - Manual Menu Change Required"));
 	}
 	return MRES_SUPERCEDE;
 }
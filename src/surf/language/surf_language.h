@@ -5,6 +5,14 @@
 #include "../spec/surf_spec.h"
 #include "utils/eventlisteners.h"
 
+// Phrases printed often are looked up once, every other phrase is found by name each time it is printed.
+#define SURF_PHRASE(name) \
+	[]() \
+	{ \
+		static_persist const SurfLanguageService::PhraseID id = SurfLanguageService::GetPhraseID(name); \
+		return id; \
+	}()
+
 class SurfLanguageService : public SurfBaseService
 {
 	using SurfBaseService::SurfBaseService;
@@ -16,6 +24,9 @@ public:
 	static void LoadTranslations();
 	static void Cleanup();
 
+	// Index of a language in the phrase table, only valid until the translations are reloaded.
+	typedef u32 LanguageID;
+
 	struct LanguageInfo
 	{
 		LanguageInfo();
@@ -28,6 +39,8 @@ public:
 		} cacheLevel = CacheLevel::CACHE_NONE;
 		char lastAddon[16] {};
 		char language[16] {};
+		// Resolved whenever `language` changes or the translations are reloaded.
+		LanguageID languageID {};
 	};
 
 	static inline std::unordered_map<uint64, LanguageInfo> clientLanguageInfos;
@@ -38,74 +51,108 @@ public:
 	void OnPlayerPreferencesLoaded();
 
 	const char *GetLanguage();
+	LanguageID GetLanguageID();
+
+	// Unknown languages use the default language.
+	static LanguageID FindLanguageID(const char *language);
 
 	static const char *GetTranslatedFormat(const char *language, const char *phrase);
 
-private:
-	static inline void ReplaceStringInPlace(std::string &subject, std::string_view search, std::string_view replace)
+	// Interned phrase name, the ID of a phrase never changes, even when the translations are reloaded.
+	typedef u32 PhraseID;
+
+	// Interns the phrase if needed. Meant to be looked up once by code that prints the same phrase often.
+	static PhraseID GetPhraseID(const char *phrase);
+	// Doesn't intern anything, so it's safe to call with messages that aren't phrases.
+	static bool FindPhraseID(const char *phrase, PhraseID &id);
+	static const char *GetPhraseName(PhraseID phrase);
+
+	// Piece of a compiled translation: `length` bytes of literal text at `offset` in the phrase text, or argument `arg` of the
+	// phrase formatted with the format string at `offset`.
+	struct PhraseToken
 	{
-		size_t pos = 0;
-		while ((pos = subject.find(search, pos)) != std::string::npos)
-		{
-			subject.replace(pos, search.length(), replace);
-			pos += replace.length();
-		}
-	}
+		u32 offset;
+		u32 length;
+		// Negative for literal text.
+		i32 arg;
+	};
+
+	// Returns false if the phrase doesn't exist. Missing translations are already replaced with the default language.
+	static bool GetCompiledPhrase(LanguageID language, PhraseID phrase, const PhraseToken *&tokens, u32 &tokenCount, const char *&text);
 
+	// Renders a message into a buffer kept per thread, valid until the next message is rendered.
+	// Never pass what it returns as an argument of another message, copy it or use PrepareMessageWithLang instead.
 	template<typename... Args>
-	static std::string GetFormattedMessage(const char *input, const char *format, Args &&...args)
+	static const std::string &RenderMessageWithLang(LanguageID language, PhraseID phrase, const Args &...args)
 	{
-		std::string inputStr = std::string(input);
-		const char *tokenStart = format;
-		int argNumber = 0;
-		while (true)
+		std::ostream *stream;
+		std::string &buffer = BeginMessage(stream);
+		const PhraseToken *tokens;
+		u32 tokenCount;
+		const char *text;
+		if (!GetCompiledPhrase(language, phrase, tokens, tokenCount, text))
 		{
-			const char *tokenEnd = strstr(tokenStart, ":");
-			if (!tokenEnd)
-			{
-				break;
-			}
-			const char *replaceStart = tokenEnd + 1;
-			const char *replaceEnd = strstr(replaceStart, ",");
-			if (!replaceEnd)
+			// Messages that aren't phrases are format strings themselves.
+			tfm::format(*stream, GetPhraseName(phrase), args...);
+			return buffer;
+		}
+		for (u32 i = 0; i < tokenCount; i++)
+		{
+			if (tokens[i].arg < 0)
 			{
-				replaceEnd = format + strlen(format);
-				ReplaceStringInPlace(inputStr, '{' + std::string(tokenStart, tokenEnd - tokenStart) + '}',
-									 '%' + std::to_string(++argNumber) + '$' + std::string(replaceStart, replaceEnd - replaceStart));
-				break;
+				buffer.append(text + tokens[i].offset, tokens[i].length);
 			}
 			else
 			{
-				ReplaceStringInPlace(inputStr, '{' + std::string(tokenStart, tokenEnd - tokenStart) + '}',
-									 '%' + std::to_string(++argNumber) + '$' + std::string(replaceStart, replaceEnd - replaceStart));
-				tokenStart = replaceEnd + 1;
+				FormatArgument(*stream, text + tokens[i].offset, tokens[i].arg, args...);
 			}
 		}
-		return tfm::format(inputStr.c_str(), std::forward<Args>(args)...);
+		return buffer;
 	}
 
-public:
 	template<typename... Args>
-	static std::string PrepareMessageWithLang(const char *language, const char *message, Args &&...args)
+	static const std::string &RenderMessageWithLang(LanguageID language, const char *message, const Args &...args)
 	{
-		const char *paramFormat = GetTranslatedFormat("#format", message);
-		const char *msgFormat = GetTranslatedFormat(language, message);
-		if (!paramFormat)
+		PhraseID phrase;
+		if (!FindPhraseID(message, phrase))
 		{
-			// Just return the raw unformatted message if format can't be found.
-			return std::string(msgFormat);
+			std::ostream *stream;
+			std::string &buffer = BeginMessage(stream);
+			tfm::format(*stream, message, args...);
+			return buffer;
 		}
-		return GetFormattedMessage(msgFormat, paramFormat, args...);
+		return RenderMessageWithLang(language, phrase, args...);
 	}
 
-	template<typename... Args>
-	std::string PrepareMessage(const char *message, Args &&...args)
+	template<typename Message, typename... Args>
+	static const std::string &RenderMessageWithLang(const char *language, Message message, const Args &...args)
+	{
+		return RenderMessageWithLang(FindLanguageID(language), message, args...);
+	}
+
+	template<typename Language, typename Message, typename... Args>
+	static std::string PrepareMessageWithLang(Language language, Message message, Args &&...args)
+	{
+		return RenderMessageWithLang(language, message, args...);
+	}
+
+	template<typename Message, typename... Args>
+	std::string PrepareMessage(Message message, Args &&...args)
 	{
-		const char *language = GetLanguage();
-		return SurfLanguageService::PrepareMessageWithLang(language, message, args...);
+		return SurfLanguageService::PrepareMessageWithLang(this->GetLanguageID(), message, args...);
 	}
 
 private:
+	// Clears the render buffer and returns it, `stream` appends to it.
+	static std::string &BeginMessage(std::ostream *&stream);
+
+	template<typename... Args>
+	static void FormatArgument(std::ostream &stream, const char *format, i32 index, const Args &...args)
+	{
+		i32 i = 0;
+		((i++ == index ? tfm::format(stream, format, args) : void()), ...);
+	}
+
 	enum MessageType : u8
 	{
 		MESSAGE_CHAT,
@@ -115,11 +162,10 @@ private:
 		MESSAGE_HTML
 	};
 
-	template<typename... Args>
-	static void PrintType(SurfPlayer *player, bool addPrefix, MessageType type, const char *message, Args &&...args)
+	template<typename Message, typename... Args>
+	static void PrintType(SurfPlayer *player, bool addPrefix, MessageType type, Message message, Args &&...args)
 	{
-		const char *language = player->languageService->GetLanguage();
-		std::string msg = PrepareMessageWithLang(language, message, args...);
+		const std::string &msg = RenderMessageWithLang(player->languageService->GetLanguageID(), message, args...);
 		switch (type)
 		{
 			case MESSAGE_CHAT:
@@ -150,8 +196,8 @@ private:
 		}
 	}
 
-	template<typename... Args>
-	static void PrintSingle(SurfPlayer *player, bool addPrefix, bool includeSpectators, MessageType type, const char *message, Args &&...args)
+	template<typename Message, typename... Args>
+	static void PrintSingle(SurfPlayer *player, bool addPrefix, bool includeSpectators, MessageType type, Message message, Args &&...args)
 	{
 		PrintType(player, addPrefix, type, message, args...);
 		if (includeSpectators)
@@ -165,8 +211,8 @@ private:
 
 public:
 #define REGISTER_PRINT_SINGLE_FUNCTION(name, type) \
-	template<typename... Args> \
-	void name(bool addPrefix, bool includeSpectators, const char *message, Args &&...args) \
+	template<typename Message, typename... Args> \
+	void name(bool addPrefix, bool includeSpectators, Message message, Args &&...args) \
 	{ \
 		PrintSingle(this->player, addPrefix, includeSpectators, type, message, args...); \
 	}
@@ -180,8 +226,8 @@ public:
 #undef REGISTER_PRINT_SINGLE_FUNCTION
 
 #define REGISTER_PRINT_ALL_FUNCTION(name, type) \
-	template<typename... Args> \
-	static void name(bool addPrefix, const char *message, Args &&...args) \
+	template<typename Message, typename... Args> \
+	static void name(bool addPrefix, Message message, Args &&...args) \
 	{ \
 		for (u32 i = 0; i < MAXPLAYERS + 1; i++) \
 		{ \
@@ -45,7 +45,7 @@ static_global struct
 	bool apiVersionLoaded;
 	bool fatalFailure;
 
-	CUtlVectorFixed<SurfTrigger, 2048> triggers;
+	CUtlVectorFixed<SurfTrigger, SURF_MAX_TRIGGER_COUNT> triggers;
 	bool roundIsStarting;
 	i32 errorFlags;
 	i32 errorCount;
@@ -56,6 +56,25 @@ static_global struct
 	QAngle jumpstatAreaAngles;
 } g_mappingApi;
 
+// Direct lookup from entity entry index to the index of its trigger in g_mappingApi.triggers.
+// Kept outside of g_mappingApi because empty slots are -1 rather than zero.
+static_global struct
+{
+	i16 triggerIndex[MAX_TOTAL_ENTITIES];
+	// Resolved course for each timer trigger, filled once the courses are validated at round start.
+	SurfCourseDescriptor *triggerCourses[SURF_MAX_TRIGGER_COUNT];
+	bool coursesResolved;
+
+	struct
+	{
+		u64 lookups;
+		u64 misses;
+		// Only sampled lookups are timed, see MAPI_LOOKUP_TIMING_SAMPLE_RATE.
+		u64 timedLookups;
+		f64 timedTime;
+	} stats;
+} g_triggerLookup;
+
 static_global CTimer<> *g_errorTimer;
 static_global const char *g_errorPrefix = "{darkred} ERROR: ";
 static_global const char *g_triggerNames[] = {"Disabled",       "Modifier",        "Start zone", "End zone", "Bonus start zone",
@@ -140,6 +159,66 @@ static_function bool Mapi_CreateCourse(i32 courseNumber = 1, const char *courseN
 	return true;
 }
 
+static_function void Mapi_ClearTriggerLookup()
+{
+	// -1 in every slot.
+	memset(g_triggerLookup.triggerIndex, 0xFF, sizeof(g_triggerLookup.triggerIndex));
+	g_triggerLookup.coursesResolved = false;
+}
+
+static_function void Mapi_AddTrigger(const SurfTrigger &trigger)
+{
+	if (g_mappingApi.triggers.Count() >= SURF_MAX_TRIGGER_COUNT)
+	{
+		g_mappingApi.errorFlags |= MAPI_ERR_TOO_MANY_TRIGGERS;
+		return;
+	}
+
+	i32 index = g_mappingApi.triggers.AddToTail(trigger);
+	g_triggerLookup.triggerCourses[index] = nullptr;
+
+	i32 entIndex = trigger.entity.GetEntryIndex();
+	if (entIndex >= 0 && entIndex < MAX_TOTAL_ENTITIES)
+	{
+		g_triggerLookup.triggerIndex[entIndex] = (i16)index;
+	}
+}
+
+// Returns the index of the trigger in g_mappingApi.triggers, or -1 if the entity isn't a mapping API entity.
+static_function i32 Mapi_LookupTriggerIndex(CEntityHandle handle)
+{
+	i32 entIndex = handle.GetEntryIndex();
+	if (entIndex < 0 || entIndex >= MAX_TOTAL_ENTITIES)
+	{
+		return -1;
+	}
+
+	i32 index = g_triggerLookup.triggerIndex[entIndex];
+	// The entity index can be reused by another entity, so the serial number has to match as well.
+	if (index < 0 || index >= g_mappingApi.triggers.Count() || g_mappingApi.triggers[index].entity != handle)
+	{
+		return -1;
+	}
+	return index;
+}
+
+// Reading the clock costs more than the lookup itself, so only one lookup in this many is timed.
+#define MAPI_LOOKUP_TIMING_SAMPLE_RATE 64
+
+static_function i32 Mapi_LookupTriggerIndexWithStats(CEntityHandle handle)
+{
+	auto &stats = g_triggerLookup.stats;
+	if (stats.lookups++ % MAPI_LOOKUP_TIMING_SAMPLE_RATE != 0)
+	{
+		return Mapi_LookupTriggerIndex(handle);
+	}
+	f64 startTime = Plat_FloatTime();
+	i32 index = Mapi_LookupTriggerIndex(handle);
+	stats.timedTime += Plat_FloatTime() - startTime;
+	stats.timedLookups++;
+	return index;
+}
+
 // Example keyvalues:
 /*
 	timer_anti_bhop_time: 0.2
@@ -381,7 +460,7 @@ static_function void Mapi_OnTriggerMultipleSpawn(const EntitySpawnInfo_t *info)
 		break;
 	}
 
-	g_mappingApi.triggers.AddToTail(trigger);
+	Mapi_AddTrigger(trigger);
 }
 
 static_function void Mapi_OnInfoTargetSpawn(const CEntityKeyValues *ekv)
@@ -429,26 +508,25 @@ static_function void Mapi_OnInfoTargetSpawn(const CEntityKeyValues *ekv)
 
 static_function SurfTrigger *Mapi_FindSurfTrigger(CBaseTrigger *trigger)
 {
-	if (!trigger->m_pEntity)
+	if (!trigger || !trigger->m_pEntity)
 	{
 		return nullptr;
 	}
 
 	CEntityHandle triggerHandle = trigger->GetRefEHandle();
-	if (!trigger || !triggerHandle.IsValid() || trigger->m_pEntity->m_flags & EF_IS_INVALID_EHANDLE)
+	if (!triggerHandle.IsValid() || trigger->m_pEntity->m_flags & EF_IS_INVALID_EHANDLE)
 	{
 		return nullptr;
 	}
 
-	FOR_EACH_VEC(g_mappingApi.triggers, i)
+	i32 index = Mapi_LookupTriggerIndexWithStats(triggerHandle);
+	if (index == -1)
 	{
-		if (triggerHandle == g_mappingApi.triggers[i].entity)
-		{
-			return &g_mappingApi.triggers[i];
-		}
+		g_triggerLookup.stats.misses++;
+		return nullptr;
 	}
 
-	return nullptr;
+	return &g_mappingApi.triggers[index];
 }
 
 static_function SurfTrigger *Mapi_FindSurfDestination(CBaseEntity *entity)
@@ -462,15 +540,15 @@ static_function SurfTrigger *Mapi_FindSurfDestination(CBaseEntity *entity)
 	{
 		return nullptr;
 	}
-	int entityHammerId = atoi(entity->m_sUniqueHammerID.Get());
-	FOR_EACH_VEC(g_mappingApi.triggers, i)
+
+	i32 index = Mapi_LookupTriggerIndexWithStats(entityHandle);
+	if (index == -1 || g_mappingApi.triggers[index].type != SURFTRIGGER_DESTINATION)
 	{
-		if (g_mappingApi.triggers[i].type == SURFTRIGGER_DESTINATION && entityHandle == g_mappingApi.triggers[i].entity)
-		{
-			return &g_mappingApi.triggers[i];
-		}
+		g_triggerLookup.stats.misses++;
+		return nullptr;
 	}
-	return nullptr;
+
+	return &g_mappingApi.triggers[index];
 }
 
 static_function SurfCourseDescriptor *Mapi_FindCourse(const char *targetname)
@@ -516,7 +594,7 @@ static_function void Mapi_OnInfoTeleportDestinationSpawn(const EntitySpawnInfo_t
 	trigger.entity = info->m_pEntity->GetRefEHandle();
 	snprintf(trigger.zone.courseDescriptor, sizeof(trigger.zone.courseDescriptor), SURF_NO_MAPAPI_COURSE_DESCRIPTOR);
 
-	g_mappingApi.triggers.AddToTail(trigger);
+	Mapi_AddTrigger(trigger);
 };
 
 static_function void Mapi_OnTriggerPushSpawn(const EntitySpawnInfo_t *info)
@@ -559,12 +637,13 @@ static_function void Mapi_OnTriggerPushSpawn(const EntitySpawnInfo_t *info)
 
 	snprintf(trigger.zone.courseDescriptor, sizeof(trigger.zone.courseDescriptor), SURF_NO_MAPAPI_COURSE_DESCRIPTOR);
 
-	g_mappingApi.triggers.AddToTail(trigger);
+	Mapi_AddTrigger(trigger);
 };
 
 void Surf::mapapi::Init()
 {
 	g_mappingApi = {};
+	Mapi_ClearTriggerLookup();
 
 	g_errorTimer = g_errorTimer ? g_errorTimer : StartTimer(Mapi_PrintErrors, true);
 }
@@ -709,12 +788,14 @@ void Surf::mapapi::OnSpawn(int count, const EntitySpawnInfo_t *info)
 	{
 		g_mappingApi.triggers.RemoveAll();
 		g_mappingApi.courseDescriptors.RemoveAll();
+		Mapi_ClearTriggerLookup();
 	}
 }
 
 void Surf::mapapi::OnRoundPreStart()
 {
 	g_mappingApi.triggers.RemoveAll();
+	Mapi_ClearTriggerLookup();
 	g_mappingApi.roundIsStarting = true;
 }
 
@@ -828,6 +909,29 @@ void Surf::mapapi::OnRoundStart()
 		courseDescriptor->checkpointCount = cpCount;
 		courseDescriptor->stageCount = stageCount;
 	}
+
+	// Courses are final now, cache them so touching a timer trigger doesn't have to search for its course by name.
+	FOR_EACH_VEC(g_mappingApi.triggers, i)
+	{
+		const SurfTrigger &trigger = g_mappingApi.triggers[i];
+		g_triggerLookup.triggerCourses[i] = Surf::mapapi::IsTimerTrigger(trigger.type) ? Mapi_FindCourse(trigger.zone.courseDescriptor) : nullptr;
+	}
+	g_triggerLookup.coursesResolved = true;
+}
+
+void Surf::mapapi::OnEntityDeleted(CEntityInstance *entity)
+{
+	if (!entity || !entity->m_pEntity)
+	{
+		return;
+	}
+
+	CEntityHandle handle = entity->m_pEntity->m_EHandle;
+	i32 entIndex = handle.GetEntryIndex();
+	if (Mapi_LookupTriggerIndex(handle) != -1)
+	{
+		g_triggerLookup.triggerIndex[entIndex] = -1;
+	}
 }
 
 void Surf::mapapi::CheckEndTimerTrigger(CBaseTrigger *trigger)
@@ -866,6 +970,15 @@ const SurfCourseDescriptor *Surf::mapapi::GetCourseDescriptorFromTrigger(CBaseTr
 
 const SurfCourseDescriptor *Surf::mapapi::GetCourseDescriptorFromTrigger(const SurfTrigger *trigger)
 {
+	if (g_triggerLookup.coursesResolved)
+	{
+		i64 index = trigger - g_mappingApi.triggers.Base();
+		if (index >= 0 && index < g_mappingApi.triggers.Count() && g_triggerLookup.triggerCourses[index])
+		{
+			return g_triggerLookup.triggerCourses[index];
+		}
+	}
+
 	const SurfCourseDescriptor *course = nullptr;
 	switch (trigger->type)
 	{
@@ -1029,16 +1142,32 @@ SCMD(surf_course, SCFL_MAP)
 	SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(controller);
 	if (player->timerService->GetCourse())
 	{
-		player->languageService->PrintChat(true, false, "Current Course", player->timerService->GetCourse()->name);
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Current Course"), player->timerService->GetCourse()->name);
 	}
 	else
 	{
-		player->languageService->PrintChat(true, false, "No Current Course");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("No Current Course"));
 	}
-	player->languageService->PrintConsole(false, false, "Course List Header");
+	player->languageService->PrintConsole(false, false, SURF_PHRASE("Course List Header"));
 	for (u32 i = 0; i < Surf::course::GetCourseCount(); i++)
 	{
 		player->PrintConsole(false, false, "%s", g_sortedCourses[i]->name);
 	}
 	return MRES_SUPERCEDE;
 }
+
+CON_COMMAND_F(surf_mapapi_stats, "Print mapping API trigger lookup statistics. Pass \"reset\" to clear them.", FCVAR_NONE)
+{
+	auto &stats = g_triggerLookup.stats;
+	u64 hits = stats.lookups - stats.misses;
+	f64 average = stats.timedLookups ? stats.timedTime / stats.timedLookups : 0.0;
+	META_CONPRINTF("[Surf::MappingAPI] %i triggers registered.\n", g_mappingApi.triggers.Count());
+	META_CONPRINTF("[Surf::MappingAPI] %llu lookups (%llu hits, %llu misses), ~%.3f ms total, %.1f ns average over %llu timed lookups.\n",
+				   stats.lookups, hits, stats.misses, average * stats.lookups * 1000.0, average * 1e9, stats.timedLookups);
+
+	if (args.ArgC() > 1 && SURF_STREQI(args.Arg(1), "reset"))
+	{
+		stats = {};
+		META_CONPRINTF("[Surf::MappingAPI] Lookup statistics reset.\n");
+	}
+}
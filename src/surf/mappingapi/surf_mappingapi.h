@@ -13,6 +13,7 @@
 #define SURF_MAX_STAGE_ZONES        100
 #define SURF_MAX_COURSE_COUNT       128
 #define SURF_MAX_COURSE_NAME_LENGTH 65
+#define SURF_MAX_TRIGGER_COUNT      2048
 
 #define INVALID_CHECKPOINT_NUMBER 0
 #define INVALID_STAGE_NUMBER      0
@@ -178,6 +179,8 @@ namespace Surf::mapapi
 	void OnSpawn(int count, const EntitySpawnInfo_t *info);
 	void OnRoundPreStart();
 	void OnRoundStart();
+	// Drop the entity from the trigger lookup table so its entity index can be reused.
+	void OnEntityDeleted(CEntityInstance *entity);
 
 	void CheckEndTimerTrigger(CBaseTrigger *trigger);
 	// This is const, unlike the trigger returned from Mapi_FindSurfTrigger.
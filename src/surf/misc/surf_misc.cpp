@@ -47,11 +47,11 @@ SCMD(surf_hidelegs, SCFL_PLAYER | SCFL_PREFERENCE)
 	player->ToggleHideLegs();
 	if (player->HidingLegs())
 	{
-		player->languageService->PrintChat(true, false, "Quiet Option - Show Player Legs - Disable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Quiet Option - Show Player Legs - Disable"));
 	}
 	else
 	{
-		player->languageService->PrintChat(true, false, "Quiet Option - Show Player Legs - Enable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Quiet Option - Show Player Legs - Enable"));
 	}
 	return MRES_SUPERCEDE;
 }
@@ -64,11 +64,11 @@ SCMD(surf_hide, SCFL_PLAYER | SCFL_PREFERENCE)
 	player->quietService->ToggleHide();
 	if (player->quietService->hideOtherPlayers)
 	{
-		player->languageService->PrintChat(true, false, "Quiet Option - Show Players - Disable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Quiet Option - Show Players - Disable"));
 	}
 	else
 	{
-		player->languageService->PrintChat(true, false, "Quiet Option - Show Players - Enable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Quiet Option - Show Players - Enable"));
 	}
 	return MRES_SUPERCEDE;
 }
@@ -84,7 +84,7 @@ SCMD(surf_end, SCFL_MAP)
 
 		if (!course || !course || !course->hasEndPosition)
 		{
-			player->languageService->PrintChat(true, false, "No End Position For Course", args->ArgS());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("No End Position For Course"), args->ArgS());
 			return MRES_SUPERCEDE;
 		}
 	}
@@ -103,7 +103,7 @@ SCMD(surf_end, SCFL_MAP)
 		else
 		{
 			CUtlString courseName = player->timerService->GetCourse()->GetName();
-			player->languageService->PrintChat(true, false, "No End Position For Course", courseName.Get());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("No End Position For Course"), courseName.Get());
 			return MRES_SUPERCEDE;
 		}
 	}
@@ -121,7 +121,7 @@ SCMD(surf_end, SCFL_MAP)
 		else
 		{
 			CUtlString courseName = Surf::course::GetFirstCourse()->GetName();
-			player->languageService->PrintChat(true, false, "No End Position For Course", courseName.Get());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("No End Position For Course"), courseName.Get());
 		}
 	}
 
@@ -371,7 +371,7 @@ SCMD(surf_restart, SCFL_TIMER | SCFL_MAP)
 
 		if (!startPosCourse || !startPosCourse || !startPosCourse->hasStartPosition)
 		{
-			player->languageService->PrintChat(true, false, "No Start Position For Course", args->ArgS());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("No Start Position For Course"), args->ArgS());
 			return MRES_SUPERCEDE;
 		}
 	}
@@ -513,7 +513,7 @@ SCMD(surf_playercheck, SCFL_PLAYER)
 	}
 	if (!targetPlayer)
 	{
-		player->languageService->PrintChat(true, false, "Error Message (Player Not Found)", args->ArgS());
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Error Message (Player Not Found)"), args->ArgS());
 		return MRES_SUPERCEDE;
 	}
 	player->languageService->PrintChat(
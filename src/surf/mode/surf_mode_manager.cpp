@@ -238,8 +238,8 @@ bool SurfModeManager::SwitchToMode(SurfPlayer *player, const char *modeName, boo
 	// Don't change mode if it doesn't exist. Instead, print a list of modes to the client.
 	if (!modeName || !V_stricmp("", modeName))
 	{
-		player->languageService->PrintChat(true, false, "Mode Command Usage");
-		player->languageService->PrintConsole(false, false, "Possible & Current Modes", player->modeService->GetModeName());
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Mode Command Usage"));
+		player->languageService->PrintConsole(false, false, SURF_PHRASE("Possible & Current Modes"), player->modeService->GetModeName());
 		FOR_EACH_VEC(modeInfos, i)
 		{
 			if (modeInfos[i].id < 0)
@@ -278,7 +278,7 @@ bool SurfModeManager::SwitchToMode(SurfPlayer *player, const char *modeName, boo
 	{
 		if (!silent)
 		{
-			player->languageService->PrintChat(true, false, "Mode Not Available", modeName);
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Mode Not Available"), modeName);
 		}
 		return false;
 	}
@@ -290,7 +290,7 @@ bool SurfModeManager::SwitchToMode(SurfPlayer *player, const char *modeName, boo
 
 	if (!silent)
 	{
-		player->languageService->PrintChat(true, false, "Switched Mode", player->modeService->GetModeName());
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Switched Mode"), player->modeService->GetModeName());
 	}
 
 	utils::SendMultipleConVarValues(player->GetPlayerSlot(), Surf::mode::modeCvarRefs, player->modeService->GetModeConVarValues(), MODECVAR_COUNT);
@@ -63,11 +63,11 @@ SCMD(surf_noclip, SCFL_PLAYER)
 	player->noclipService->ToggleNoclip();
 	if (player->noclipService->IsNoclipping())
 	{
-		player->languageService->PrintChat(true, false, "Noclip - Enable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Noclip - Enable"));
 	}
 	else
 	{
-		player->languageService->PrintChat(true, false, "Noclip - Disable");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Noclip - Disable"));
 	}
 	return MRES_SUPERCEDE;
 }
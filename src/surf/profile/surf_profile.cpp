@@ -45,15 +45,37 @@ static_global const char *rankColors[NUM_RANKS] = {"{default}", "{grey}", "{grey
 
 #define RATING_REFRESH_PERIOD 120.0f // seconds
 
-CConVar<bool> surf_profile_rating_badge_enabled("surf_profile_rating_badge_enabled", FCVAR_NONE, "Whether to show competitive rank in scoreboard.",
-												true);
+// Set when a badge changed, the scoreboard only shows the new badges once ranks are revealed again.
+static_global bool g_rankRevealPending;
+
+// clang-format off
+CConVar<bool> surf_profile_rating_badge_enabled("surf_profile_rating_badge_enabled", FCVAR_NONE, "Whether to show competitive rank in scoreboard.", true,
+	// Badges are only set when something changes, catch up with whatever changed while they were off.
+	[](CConVar<bool> *ref, CSplitScreenSlot nSlot, const bool *bNewValue, const bool *bOldValue)
+	{
+		if (!g_pSurfPlayerManager)
+		{
+			return;
+		}
+		for (i32 i = 0; i < MAXPLAYERS + 1; i++)
+		{
+			SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(i);
+			if (player && player->profileService)
+			{
+				player->profileService->UpdateCompetitiveRank();
+			}
+		}
+	}
+);
+// clang-format on
 
 void SurfProfileService::OnGameFrame()
 {
-	if (g_pSurfUtils->GetServerGlobals()->tickcount % 64 != 0)
+	if (!g_rankRevealPending)
 	{
 		return;
 	}
+	g_rankRevealPending = false;
 	CBroadcastRecipientFilter filter;
 	INetworkMessageInternal *netmsg = g_pNetworkMessages->FindNetworkMessagePartial("CCSUsrMsg_ServerRankRevealAll");
 	CNetMessage *msg = netmsg->AllocateMessage();
@@ -61,18 +83,28 @@ void SurfProfileService::OnGameFrame()
 	delete msg;
 }
 
-void SurfProfileService::OnCheckTransmit()
+void SurfProfileService::OnPlayerFullyConnect()
 {
-	for (i32 i = 0; i < MAXPLAYERS + 1; i++)
+	this->UpdateCompetitiveRank();
+	// The new client hasn't seen anyone's badge yet.
+	if (surf_profile_rating_badge_enabled.GetBool())
 	{
-		SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(i);
-		if (player && player->profileService)
-		{
-			player->profileService->UpdateCompetitiveRank();
-		}
+		g_rankRevealPending = true;
 	}
 }
 
+// The engine resets the badge and the clan tag in some cases, like changing team or respawning. Both are compared against the
+// controller before being set, so this only does something if they were actually reset.
+void SurfProfileService::OnPlayerSpawn()
+{
+	this->UpdateClantag();
+}
+
+void SurfProfileService::OnPlayerJoinTeam()
+{
+	this->UpdateClantag();
+}
+
 void SurfProfileService::RequestRating()
 {
 	if (!SurfGlobalService::IsAvailable() || !this->player->IsAuthenticated() || !this->player->IsConnected())
@@ -120,7 +152,6 @@ void SurfProfileService::RequestRating()
 		{
 			return;
 		}
-		player->profileService->UpdateCompetitiveRank();
 		player->profileService->UpdateClantag();
 	};
 	request.Send(callback);
@@ -153,6 +184,10 @@ void SurfProfileService::UpdateClantag()
 		}
 		return;
 	}
+	// The badge depends on the same rating, mode and styles as the tag.
+	this->UpdateCompetitiveRank();
+
+	char newClanTag[sizeof(this->clanTag)];
 	if (this->CanDisplayRank())
 	{
 		i32 rank = Ranks::Unknown;
@@ -164,19 +199,25 @@ void SurfProfileService::UpdateClantag()
 				break;
 			}
 		}
-		V_snprintf(this->clanTag, sizeof(this->clanTag), "[%s %s]", this->player->modeService->GetModeShortName(), rankNames[rank]);
+		V_snprintf(newClanTag, sizeof(newClanTag), "[%s %s]", this->player->modeService->GetModeShortName(), rankNames[rank]);
 	}
 	else
 	{
-		V_snprintf(this->clanTag, sizeof(this->clanTag), "[%s%s]", this->player->modeService->GetModeShortName(),
+		V_snprintf(newClanTag, sizeof(newClanTag), "[%s%s]", this->player->modeService->GetModeShortName(),
 				   this->player->styleServices.Count() > 0 ? "*" : "");
 	}
 
-	if (this->clanTag[0] == '\0')
+	if (newClanTag[0] == '\0')
 	{
 		return;
 	}
-	this->SetClantag(this->clanTag);
+	// Setting the tag renames the player to refresh the scoreboard, don't do it for nothing.
+	CCSPlayerController *controller = this->player->GetController();
+	if (SURF_STREQ(newClanTag, this->clanTag) && controller && SURF_STREQ(controller->m_szClan().String(), newClanTag))
+	{
+		return;
+	}
+	this->SetClantag(newClanTag);
 }
 
 void SurfProfileService::OnPhysicsSimulatePost()
@@ -189,13 +230,19 @@ void SurfProfileService::OnPhysicsSimulatePost()
 
 void SurfProfileService::UpdateCompetitiveRank()
 {
-	if (!this->player->GetController() || !surf_profile_rating_badge_enabled.GetBool())
+	CCSPlayerController *controller = this->player->GetController();
+	if (!controller || !surf_profile_rating_badge_enabled.GetBool())
 	{
 		return;
 	}
 	i32 rating = this->CanDisplayRank() ? static_cast<i32>(floor(this->currentRating * 0.1f)) : 0;
-	this->player->GetController()->m_iCompetitiveRankType(11);
-	this->player->GetController()->m_iCompetitiveRanking(rating);
+	if (controller->m_iCompetitiveRankType() == 11 && controller->m_iCompetitiveRanking() == rating)
+	{
+		return;
+	}
+	controller->m_iCompetitiveRankType(11);
+	controller->m_iCompetitiveRanking(rating);
+	g_rankRevealPending = true;
 }
 
 std::string SurfProfileService::GetPrefix(bool colors)
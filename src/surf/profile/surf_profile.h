@@ -8,7 +8,6 @@ public:
 	using SurfBaseService::SurfBaseService;
 
 	static void OnGameFrame();
-	static void OnCheckTransmit();
 
 	virtual void Reset() override
 	{
@@ -34,6 +33,10 @@ public:
 
 	void UpdateClantag();
 	void OnPhysicsSimulatePost();
+	void OnPlayerFullyConnect();
+	void OnPlayerSpawn();
+	void OnPlayerJoinTeam();
+	// Only touches the controller and reveals ranks again if the badge changed.
 	void UpdateCompetitiveRank();
 	std::string GetPrefix(bool colors = true);
 };
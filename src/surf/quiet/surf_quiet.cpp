@@ -14,6 +14,8 @@
 #include "utils/utils.h"
 #include "utils/simplecmds.h"
 
+#include <algorithm>
+
 static_global class SurfOptionServiceEventListener_Quiet : public SurfOptionServiceEventListener
 {
 	virtual void OnPlayerPreferencesLoaded(SurfPlayer *player)
@@ -22,99 +24,199 @@ static_global class SurfOptionServiceEventListener_Quiet : public SurfOptionServ
 	}
 } optionEventListener;
 
-void Surf::quiet::OnCheckTransmit(CCheckTransmitInfo **pInfo, int infoCount)
+/*
+	Everything a player shouldn't see is gathered once per tick: the entity indices that can be hidden, then what each player
+	hides as a mask over the words of the transmit bitset holding those indices. Each recipient then only clears a few words.
+*/
+static_global struct
 {
-	for (int i = 0; i < infoCount; i++)
+	i32 tick = -1;
+	// Words of the transmit bitset that hold any entity below, sorted.
+	std::vector<u32> words;
+	// Custom particle systems created by the plugin.
+	std::vector<std::pair<i32, CEntityHandle>> particleSystems;
+	// Pawns without a controller, never transmitted.
+	std::vector<i32> orphanPawns;
+	// Pawn entity index and the index of the player owning it.
+	std::vector<std::pair<i32, u32>> pawns;
+	// Weapons of every player hiding their own, by player index.
+	std::vector<i32> weapons[MAXPLAYERS + 1];
+	// One mask per entry of `words` by player index, empty if the player doesn't receive anything.
+	std::vector<u32> hide[MAXPLAYERS + 1];
+} g_hideTable;
+
+static_function void Quiet_AddWord(i32 entIndex)
+{
+	g_hideTable.words.push_back((u32)entIndex >> 5);
+}
+
+static_function void Quiet_Hide(std::vector<u32> &mask, i32 entIndex)
+{
+	auto word = std::lower_bound(g_hideTable.words.begin(), g_hideTable.words.end(), (u32)entIndex >> 5);
+	if (word == g_hideTable.words.end() || *word != (u32)entIndex >> 5)
 	{
-		// Cast it to our own TransmitInfo struct because CCheckTransmitInfo isn't correct.
-		TransmitInfo *pTransmitInfo = reinterpret_cast<TransmitInfo *>(pInfo[i]);
+		return;
+	}
+	mask[word - g_hideTable.words.begin()] |= 1u << (entIndex & 31);
+}
 
-		// Find out who this info will be sent to.
-		uintptr_t targetAddr = reinterpret_cast<uintptr_t>(pTransmitInfo) + g_pGameConfig->GetOffset("QuietPlayerSlot");
-		CPlayerSlot targetSlot = CPlayerSlot(*reinterpret_cast<int *>(targetAddr));
-		SurfPlayer *targetPlayer = g_pSurfPlayerManager->ToPlayer(targetSlot);
-		// Make sure the target isn't CSTV.
-		CCSPlayerController *targetController = targetPlayer->GetController();
-		if (!targetController || targetController->m_bIsHLTV)
+static_function void Quiet_BuildHideTable()
+{
+	g_hideTable.words.clear();
+	g_hideTable.particleSystems.clear();
+	g_hideTable.orphanPawns.clear();
+	g_hideTable.pawns.clear();
+
+	EntityInstanceByClassIter_t iterParticleSystem(NULL, "info_particle_system");
+	for (CParticleSystem *particleSystem = static_cast<CParticleSystem *>(iterParticleSystem.First()); particleSystem;
+		 particleSystem = static_cast<CParticleSystem *>(iterParticleSystem.Next()))
+	{
+		// Only hide custom particle systems created by the plugin.
+		if (particleSystem->m_iTeamNum() == CUSTOM_PARTICLE_SYSTEM_TEAM)
 		{
-			continue;
+			g_hideTable.particleSystems.emplace_back(particleSystem->GetEntityIndex().Get(), particleSystem->GetRefEHandle());
 		}
-		targetPlayer->quietService->UpdateHideState();
-		CCSPlayerPawn *targetPlayerPawn = targetPlayer->GetPlayerPawn();
-
-		EntityInstanceByClassIter_t iterParticleSystem(NULL, "info_particle_system");
+	}
 
-		for (CParticleSystem *particleSystem = static_cast<CParticleSystem *>(iterParticleSystem.First()); particleSystem;
-			 particleSystem = static_cast<CParticleSystem *>(iterParticleSystem.Next()))
+	EntityInstanceByClassIter_t iter(NULL, "player");
+	// clang-format off
+	for (CCSPlayerPawn *pawn = static_cast<CCSPlayerPawn *>(iter.First());
+		 pawn != NULL;
+		 pawn = pawn->m_pEntity->m_pNextByClass ? static_cast<CCSPlayerPawn *>(pawn->m_pEntity->m_pNextByClass->m_pInstance) : nullptr)
+	// clang-format on
+	{
+		// Do not transmit a pawn without any controller to prevent crashes.
+		if (!pawn->m_hController().IsValid())
 		{
-			if (particleSystem->m_iTeamNum() != CUSTOM_PARTICLE_SYSTEM_TEAM)
-			{
-				continue; // Only hide custom particle systems created by the plugin.
-			}
-			if (targetPlayer->beamService->playerBeam == particleSystem->GetRefEHandle()
-				|| targetPlayer->beamService->playerBeamNew == particleSystem->GetRefEHandle())
-			{
-				// Don't hide the beam for the owner.
-				continue;
-			}
-			pTransmitInfo->m_pTransmitEdict->Clear(particleSystem->GetEntityIndex().Get());
+			g_hideTable.orphanPawns.push_back(pawn->entindex());
+			continue;
+		}
+		// Respawn must be enabled or !hide will cause client crash.
+#if 0
+		// Never send dead players to prevent crashes.
+		if (pawn->m_lifeState() != LIFE_ALIVE)
+		{
+			g_hideTable.orphanPawns.push_back(pawn->entindex());
+			continue;
 		}
+#endif
+		SurfPlayer *owner = g_pSurfPlayerManager->ToPlayer(pawn);
+		g_hideTable.pawns.emplace_back(pawn->entindex(), owner ? owner->index : 0);
+	}
 
-		EntityInstanceByClassIter_t iter(NULL, "player");
-		// clang-format off
-		for (CCSPlayerPawn *pawn = static_cast<CCSPlayerPawn *>(iter.First());
-			 pawn != NULL;
-			 pawn = pawn->m_pEntity->m_pNextByClass ? static_cast<CCSPlayerPawn *>(pawn->m_pEntity->m_pNextByClass->m_pInstance) : nullptr)
-		// clang-format on
+	for (u32 i = 0; i <= MAXPLAYERS; i++)
+	{
+		std::vector<i32> &weapons = g_hideTable.weapons[i];
+		weapons.clear();
+		SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(i);
+		CCSPlayerController *controller = player->GetController();
+		if (!controller || controller->m_bIsHLTV)
 		{
-			if (targetPlayerPawn == pawn && targetPlayer->quietService->ShouldHideWeapon())
+			continue;
+		}
+		player->quietService->UpdateHideState();
+		CCSPlayerPawn *pawn = player->GetPlayerPawn();
+		if (!player->quietService->ShouldHideWeapon() || !pawn || !pawn->m_pWeaponServices)
+		{
+			continue;
+		}
+		auto pVecWeapons = pawn->m_pWeaponServices->m_hMyWeapons();
+		FOR_EACH_VEC(*pVecWeapons, j)
+		{
+			auto pWeapon = (*pVecWeapons)[j].Get();
+			if (pWeapon)
 			{
-				auto pVecWeapons = pawn->m_pWeaponServices->m_hMyWeapons();
+				weapons.push_back(pWeapon->entindex());
+				Quiet_AddWord(pWeapon->entindex());
+			}
+		}
+	}
 
-				FOR_EACH_VEC(*pVecWeapons, i)
-				{
-					auto pWeapon = (*pVecWeapons)[i].Get();
+	for (auto &[entIndex, handle] : g_hideTable.particleSystems)
+	{
+		Quiet_AddWord(entIndex);
+	}
+	for (i32 entIndex : g_hideTable.orphanPawns)
+	{
+		Quiet_AddWord(entIndex);
+	}
+	for (auto &[entIndex, owner] : g_hideTable.pawns)
+	{
+		Quiet_AddWord(entIndex);
+	}
+	std::sort(g_hideTable.words.begin(), g_hideTable.words.end());
+	g_hideTable.words.erase(std::unique(g_hideTable.words.begin(), g_hideTable.words.end()), g_hideTable.words.end());
 
-					if (pWeapon)
-					{
-						pTransmitInfo->m_pTransmitEdict->Clear(pWeapon->entindex());
-					}
-				}
-			}
-			// Bit is not even set, don't bother.
-			if (!pTransmitInfo->m_pTransmitEdict->IsBitSet(pawn->entindex()))
-			{
-				continue;
-			}
-			// Do not transmit a pawn without any controller to prevent crashes.
-			if (!pawn->m_hController().IsValid())
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
-				continue;
-			}
-			// Respawn must be enabled or !hide will cause client crash.
-#if 0
-			// Never send dead players to prevent crashes.
-			if (pawn->m_lifeState() != LIFE_ALIVE)
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
-				continue;
-			}
-#endif
-			// Finally check if player is using !hide.
-			if (!targetPlayer->quietService->ShouldHide())
+	for (u32 i = 0; i <= MAXPLAYERS; i++)
+	{
+		std::vector<u32> &mask = g_hideTable.hide[i];
+		mask.clear();
+		SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(i);
+		CCSPlayerController *controller = player->GetController();
+		if (!controller || controller->m_bIsHLTV)
+		{
+			continue;
+		}
+		mask.resize(g_hideTable.words.size());
+		for (auto &[entIndex, handle] : g_hideTable.particleSystems)
+		{
+			// Don't hide the beam for the owner.
+			if (player->beamService->playerBeam != handle && player->beamService->playerBeamNew != handle)
 			{
-				continue;
+				Quiet_Hide(mask, entIndex);
 			}
-			u32 index = g_pSurfPlayerManager->ToPlayer(pawn)->index;
-			if (targetPlayer->quietService->ShouldHideIndex(index))
+		}
+		for (i32 entIndex : g_hideTable.orphanPawns)
+		{
+			Quiet_Hide(mask, entIndex);
+		}
+		for (i32 entIndex : g_hideTable.weapons[i])
+		{
+			Quiet_Hide(mask, entIndex);
+		}
+		// Finally check if player is using !hide.
+		if (!player->quietService->ShouldHide())
+		{
+			continue;
+		}
+		for (auto &[entIndex, owner] : g_hideTable.pawns)
+		{
+			if (player->quietService->ShouldHideIndex(owner))
 			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
+				Quiet_Hide(mask, entIndex);
 			}
 		}
 	}
 }
 
+void Surf::quiet::OnCheckTransmit(CCheckTransmitInfo **pInfo, int infoCount)
+{
+	i32 tick = g_pSurfUtils->GetServerGlobals()->tickcount;
+	if (g_hideTable.tick != tick)
+	{
+		g_hideTable.tick = tick;
+		Quiet_BuildHideTable();
+	}
+
+	for (int i = 0; i < infoCount; i++)
+	{
+		// Cast it to our own TransmitInfo struct because CCheckTransmitInfo isn't correct.
+		TransmitInfo *pTransmitInfo = reinterpret_cast<TransmitInfo *>(pInfo[i]);
+
+		// Find out who this info will be sent to.
+		uintptr_t targetAddr = reinterpret_cast<uintptr_t>(pTransmitInfo) + g_pGameConfig->GetOffset("QuietPlayerSlot");
+		CPlayerSlot targetSlot = CPlayerSlot(*reinterpret_cast<int *>(targetAddr));
+		SurfPlayer *targetPlayer = g_pSurfPlayerManager->ToPlayer(targetSlot);
+		// Empty for CSTV.
+		const std::vector<u32> &mask = g_hideTable.hide[targetPlayer->index];
+		uint32 *transmitWords = pTransmitInfo->m_pTransmitEdict->Base();
+		for (u32 j = 0; j < mask.size(); j++)
+		{
+			transmitWords[g_hideTable.words[j]] &= ~mask[j];
+		}
+	}
+}
+
 void Surf::quiet::OnPostEvent(INetworkMessageInternal *pEvent, const CNetMessage *pData, const uint64 *clients)
 {
 	NetMessageInfo_t *info = pEvent->GetNetMessageInfo();
@@ -301,7 +403,8 @@ void SurfQuietService::ToggleHide()
 
 void SurfQuietService::UpdateHideState()
 {
-	CPlayer_ObserverServices *obsServices = this->player->GetController()->m_hPawn()->m_pObserverServices;
+	CBasePlayerPawn *pawn = this->player->GetCurrentPawn();
+	CPlayer_ObserverServices *obsServices = pawn ? pawn->m_pObserverServices : nullptr;
 	if (!obsServices)
 	{
 		this->lastObserverMode = OBS_MODE_NONE;
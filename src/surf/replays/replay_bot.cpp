@@ -0,0 +1,280 @@
+/*
+	Replay bots.
+
+	Each bot is a fake client playing back a replay file through the regular player pipeline, so the HUD, spectating and the timer
+	work on them the same way they work on players. The replay file is memory mapped and decoded one tick at a time as the bot
+	advances, a bot never holds more than one decoded frame.
+*/
+
+#include "replay_file.h"
+#include "cs2surf.h"
+#include "surf/language/surf_language.h"
+#include "surf/mode/surf_mode.h"
+#include "surf/option/surf_option.h"
+#include "surf/spec/surf_spec.h"
+#include "surf/timer/surf_timer.h"
+#include "utils/ctimer.h"
+#include "utils/simplecmds.h"
+#include "sdk/cinbuttonstate.h"
+#include "sdk/services.h"
+#include "vprof.h"
+
+#include "tier0/memdbgon.h"
+
+// How long bots stand still at the start and at the end of a run.
+#define REPLAY_BOT_START_HOLD_TICKS 64
+#define REPLAY_BOT_END_HOLD_TICKS   128
+// Fake clients need a moment before they can join a team.
+#define REPLAY_BOT_SETUP_DELAY 0.1f
+
+bool SurfReplayService::StartPlayback(const char *path, u32 courseGUID, u32 expectedCRC)
+{
+	this->StopPlayback();
+
+	ReplayPlayback *playback = new ReplayPlayback();
+	if (!playback->file.Open(path) || playback->file.GetSize() < sizeof(ReplayFileHeader))
+	{
+		delete playback;
+		return false;
+	}
+	V_memcpy(&playback->header, playback->file.GetData(), sizeof(ReplayFileHeader));
+	ReplayFileHeader &header = playback->header;
+	char md5[33];
+	g_pSurfUtils->GetCurrentMapMD5(md5, sizeof(md5));
+	// A different checksum means the file changed since it was indexed.
+	if (!Surf::replay::IsHeaderValid(header, playback->file.GetSize()) || header.frameCount == 0 || !SURF_STREQ(header.mapMD5, md5)
+		|| header.dataCRC != expectedCRC)
+	{
+		delete playback;
+		return false;
+	}
+
+	const u8 *keyframeOffsets = playback->file.GetData() + header.headerSize;
+	const u8 *frameData = keyframeOffsets + header.keyframeCount * sizeof(u32);
+	playback->decoder.Init(frameData, header.dataSize, (const u32 *)keyframeOffsets, header.keyframeCount, header.keyframeInterval,
+						   header.frameCount);
+	if (!playback->decoder.Next(playback->lastFrame))
+	{
+		delete playback;
+		return false;
+	}
+	playback->courseGUID = courseGUID;
+	playback->holdTicks = REPLAY_BOT_START_HOLD_TICKS;
+	playback->lastRequestTime = g_pSurfUtils->GetServerGlobals()->curtime;
+	this->playback = playback;
+
+	this->player->timerService->SetCourse(courseGUID);
+	this->player->timerService->SetTime(0.0);
+	return true;
+}
+
+void SurfReplayService::StopPlayback()
+{
+	delete this->playback;
+	this->playback = nullptr;
+}
+
+const ReplayFileHeader *SurfReplayService::GetPlaybackHeader()
+{
+	return this->playback ? &this->playback->header : nullptr;
+}
+
+void SurfReplayService::UpdatePlayback()
+{
+	VPROF_BUDGET(__func__, "CS2Surf");
+	CCSPlayerPawn *pawn = this->player->GetPlayerPawn();
+	if (!pawn || !this->player->IsAlive())
+	{
+		return;
+	}
+
+	ReplayPlayback *playback = this->playback;
+	if (playback->holdTicks > 0)
+	{
+		playback->holdTicks--;
+	}
+	else if (playback->restartPending)
+	{
+		playback->restartPending = false;
+		playback->holdTicks = REPLAY_BOT_START_HOLD_TICKS;
+		if (!playback->decoder.Seek(0) || !playback->decoder.Next(playback->lastFrame))
+		{
+			META_CONPRINTF("[Surf::Replay] Failed to restart replay of %s, stopping playback.\n", playback->header.playerName);
+			this->StopPlayback();
+			return;
+		}
+	}
+	else if (!playback->decoder.Next(playback->lastFrame))
+	{
+		if (playback->decoder.GetFrameIndex() < playback->decoder.GetFrameCount())
+		{
+			META_CONPRINTF("[Surf::Replay] Replay of %s is corrupted at frame %u, stopping playback.\n", playback->header.playerName,
+						   playback->decoder.GetFrameIndex());
+			this->StopPlayback();
+			return;
+		}
+		playback->holdTicks = REPLAY_BOT_END_HOLD_TICKS;
+		playback->restartPending = true;
+	}
+
+	const ReplayFrame &frame = playback->lastFrame;
+	bool holding = playback->holdTicks > 0;
+	Vector velocity = holding ? vec3_origin : frame.velocity;
+	// Don't change the pitch of the absolute angles because it messes with the player model.
+	QAngle absAngles(0.0f, frame.yaw, 0.0f);
+	if (this->player->GetMoveType() != MOVETYPE_NOCLIP)
+	{
+		this->player->SetMoveType(MOVETYPE_NOCLIP, false);
+	}
+	pawn->Teleport(&frame.origin, &absAngles, &velocity);
+	pawn->m_angEyeAngles(QAngle(frame.pitch, frame.yaw, 0.0f));
+	CCSPlayer_MovementServices *ms = this->player->GetMoveServices();
+	if (ms)
+	{
+		ms->m_nButtons()->m_pButtonStates[0] = frame.buttons;
+	}
+
+	// The first decoded frame is the one the timer started on.
+	f64 time = playback->restartPending ? playback->header.time : (playback->decoder.GetFrameIndex() - 1) * playback->header.tickInterval;
+	this->player->timerService->SetCourse(playback->courseGUID);
+	this->player->timerService->SetTime(time);
+}
+
+void SurfReplayService::OnActivateServer()
+{
+	// Replays are tied to the map they were recorded on.
+	for (i32 i = 0; i <= MAXPLAYERS; i++)
+	{
+		SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(i);
+		if (player && player->replayService->IsPlayingBack())
+		{
+			player->replayService->StopPlayback();
+			player->Kick("Replay bot removed");
+		}
+	}
+
+	char md5[33];
+	g_pSurfUtils->GetCurrentMapMD5(md5, sizeof(md5));
+	Surf::replay::LoadIndex(g_pSurfUtils->GetCurrentMapName().Get(), md5);
+}
+
+static_function f64 Replay_SetupBot(CPlayerSlot botSlot, CPlayerSlot requesterSlot)
+{
+	SurfPlayer *bot = g_pSurfPlayerManager->ToPlayer(botSlot);
+	if (!bot || !bot->GetController() || !bot->replayService->IsPlayingBack())
+	{
+		return 0.0f;
+	}
+	if (!bot->IsAlive())
+	{
+		Surf::misc::JoinTeam(bot, CS_TEAM_CT, false);
+	}
+
+	SurfPlayer *requester = g_pSurfPlayerManager->ToPlayer(requesterSlot);
+	if (!requester || requester == bot || !requester->GetController())
+	{
+		return 0.0f;
+	}
+	if (requester->specService->CanSpectate())
+	{
+		requester->specService->SpectatePlayer(bot->GetName());
+	}
+	else
+	{
+		requester->languageService->PrintChat(true, false, SURF_PHRASE("Replay Bot Ready"), bot->GetName());
+	}
+	return 0.0f;
+}
+
+bool SurfReplayService::RequestBot(SurfPlayer *requester, const SurfCourseDescriptor *course, const char *modeName)
+{
+	SurfPlayer *bot = nullptr;
+	SurfPlayer *oldestBot = nullptr;
+	i32 botCount = 0;
+	for (i32 i = 0; i <= MAXPLAYERS; i++)
+	{
+		SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(i);
+		if (!player || !player->replayService->IsPlayingBack())
+		{
+			continue;
+		}
+		botCount++;
+		ReplayPlayback *playback = player->replayService->playback;
+		if (playback->courseGUID == course->guid && SURF_STREQ(playback->header.modeName, modeName))
+		{
+			bot = player;
+		}
+		if (!oldestBot || playback->lastRequestTime < oldestBot->replayService->playback->lastRequestTime)
+		{
+			oldestBot = player;
+		}
+	}
+
+	// Already playing, just watch it.
+	if (bot)
+	{
+		bot->replayService->playback->lastRequestTime = g_pSurfUtils->GetServerGlobals()->curtime;
+		Replay_SetupBot(bot->GetPlayerSlot(), requester->GetPlayerSlot());
+		return true;
+	}
+
+	ReplayIndexEntry entry;
+	char md5[33];
+	g_pSurfUtils->GetCurrentMapMD5(md5, sizeof(md5));
+	if (!Surf::replay::FindBestReplay(g_pSurfUtils->GetCurrentMapName().Get(), md5, course->GetName().Get(), modeName, "", entry))
+	{
+		requester->languageService->PrintChat(true, false, SURF_PHRASE("Replay Not Found"), course->GetName().Get(), modeName);
+		return false;
+	}
+	char path[MAX_PATH];
+	Surf::replay::GetReplayFilePath(g_pSurfUtils->GetCurrentMapName().Get(), entry.courseName, entry.modeName, entry.styles, entry.steamID64, path,
+									sizeof(path), true);
+
+	char name[128];
+	i64 maxBots = SurfOptionService::GetOptionInt("replayMaxBots", SURF_REPLAY_DEFAULT_MAX_BOTS);
+	if (botCount >= maxBots && oldestBot)
+	{
+		// Out of bots, take over the one that was asked for the longest time ago.
+		bot = oldestBot;
+	}
+	else
+	{
+		V_snprintf(name, sizeof(name), "[%s] %s", modeName, course->GetName().Get());
+		CPlayerSlot slot = interfaces::pEngine->CreateFakeClient(name);
+		bot = slot.Get() >= 0 ? g_pSurfPlayerManager->ToPlayer(slot) : nullptr;
+	}
+
+	if (!bot || !bot->replayService->StartPlayback(path, course->guid, entry.dataCRC))
+	{
+		requester->languageService->PrintChat(true, false, SURF_PHRASE("Replay Bot Failure"));
+		return false;
+	}
+	const ReplayFileHeader *header = bot->replayService->GetPlaybackHeader();
+	V_snprintf(name, sizeof(name), "[%s] %s - %s (%s)", modeName, course->GetName().Get(), SurfTimerService::FormatTime(header->time).Get(),
+			   header->playerName);
+	bot->SetName(name);
+	StartTimer<CPlayerSlot, CPlayerSlot>(Replay_SetupBot, bot->GetPlayerSlot(), requester->GetPlayerSlot(), REPLAY_BOT_SETUP_DELAY, false);
+	return true;
+}
+
+SCMD(surf_replay, SCFL_REPLAY)
+{
+	SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(controller);
+	const SurfCourseDescriptor *course = nullptr;
+	if (args->ArgC() >= 2)
+	{
+		course = Surf::course::GetCourse(args->Arg(1), false);
+	}
+	else
+	{
+		course = player->timerService->GetCourse() ? player->timerService->GetCourse() : Surf::course::GetFirstCourse();
+	}
+	CUtlString modeName = Surf::mode::GetModeInfo(player->modeService).shortModeName;
+	if (!course)
+	{
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Replay Not Found"), args->ArgC() >= 2 ? args->Arg(1) : "", modeName.Get());
+		return MRES_SUPERCEDE;
+	}
+	SurfReplayService::RequestBot(player, course, modeName.Get());
+	return MRES_SUPERCEDE;
+}
@@ -0,0 +1,412 @@
+#include "replay_file.h"
+#include "cs2surf.h"
+#include "checksum_crc.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "tier0/memdbgon.h"
+
+static_function inline u32 ZigZagEncode(i32 value)
+{
+	return ((u32)value << 1) ^ (u32)(value >> 31);
+}
+
+static_function inline i32 ZigZagDecode(u32 value)
+{
+	return (i32)(value >> 1) ^ -(i32)(value & 1);
+}
+
+static_function inline void WriteVarInt(std::vector<u8> &data, u64 value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back((u8)(value | 0x80));
+		value >>= 7;
+	}
+	data.push_back((u8)value);
+}
+
+static_function inline bool ReadVarInt(const u8 *data, u32 size, u32 &offset, u64 &value)
+{
+	value = 0;
+	for (u32 shift = 0; shift < 64; shift += 7)
+	{
+		if (offset >= size)
+		{
+			return false;
+		}
+		u8 byte = data[offset++];
+		value |= (u64)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static_function inline i32 QuantizeFloat(f32 value, f32 scale)
+{
+	return (i32)roundf(value * scale);
+}
+
+static_function inline u16 QuantizeAngle(f32 angle)
+{
+	// Wrapping is intended, the angle is a fraction of a full turn.
+	return (u16)(i32)roundf(angle * REPLAY_ANGLE_SCALE);
+}
+
+static_function inline f32 DequantizeAngle(u16 angle)
+{
+	// Back to [-180, 180).
+	return (f32)(i16)angle / REPLAY_ANGLE_SCALE;
+}
+
+static_function void QuantizeFrame(const ReplayFrame &frame, ReplayQuantizedFrame &out)
+{
+	for (u32 i = 0; i < 3; i++)
+	{
+		out.origin[i] = QuantizeFloat(frame.origin[i], REPLAY_POSITION_SCALE);
+		out.velocity[i] = QuantizeFloat(frame.velocity[i], REPLAY_VELOCITY_SCALE);
+	}
+	out.pitch = QuantizeAngle(frame.pitch);
+	out.yaw = QuantizeAngle(frame.yaw);
+	out.buttons = frame.buttons;
+	out.flags = frame.flags;
+	out.moveType = frame.moveType;
+}
+
+void Surf::replay::EncodeFrames(const ReplayFrame *frames, u32 count, ReplayFileHeader &header, std::vector<u32> &keyframeOffsets,
+								std::vector<u8> &data)
+{
+	keyframeOffsets.clear();
+	data.clear();
+	// Most frames end up well below a quarter of the upper bound.
+	data.reserve((size_t)count * REPLAY_MAX_ENCODED_FRAME_SIZE / 4);
+
+	ReplayQuantizedFrame previous {};
+	ReplayQuantizedFrame current;
+	for (u32 i = 0; i < count; i++)
+	{
+		if (i % REPLAY_KEYFRAME_INTERVAL == 0)
+		{
+			keyframeOffsets.push_back((u32)data.size());
+			previous = {};
+		}
+		QuantizeFrame(frames[i], current);
+
+		u8 changes = 0;
+		if (current.buttons != previous.buttons)
+		{
+			changes |= REPLAY_CHANGED_BUTTONS;
+		}
+		if (current.flags != previous.flags)
+		{
+			changes |= REPLAY_CHANGED_FLAGS;
+		}
+		if (current.moveType != previous.moveType)
+		{
+			changes |= REPLAY_CHANGED_MOVETYPE;
+		}
+		data.push_back(changes);
+
+		for (u32 j = 0; j < 3; j++)
+		{
+			WriteVarInt(data, ZigZagEncode(current.origin[j] - previous.origin[j]));
+		}
+		for (u32 j = 0; j < 3; j++)
+		{
+			WriteVarInt(data, ZigZagEncode(current.velocity[j] - previous.velocity[j]));
+		}
+		WriteVarInt(data, ZigZagEncode((i16)(u16)(current.pitch - previous.pitch)));
+		WriteVarInt(data, ZigZagEncode((i16)(u16)(current.yaw - previous.yaw)));
+		if (changes & REPLAY_CHANGED_BUTTONS)
+		{
+			WriteVarInt(data, current.buttons ^ previous.buttons);
+		}
+		if (changes & REPLAY_CHANGED_FLAGS)
+		{
+			WriteVarInt(data, current.flags ^ previous.flags);
+		}
+		if (changes & REPLAY_CHANGED_MOVETYPE)
+		{
+			data.push_back(current.moveType);
+		}
+		previous = current;
+	}
+
+	header.frameCount = count;
+	header.keyframeInterval = REPLAY_KEYFRAME_INTERVAL;
+	header.keyframeCount = (u32)keyframeOffsets.size();
+	header.dataSize = (u32)data.size();
+	CRC32_t crc;
+	CRC32_Init(&crc);
+	CRC32_ProcessBuffer(&crc, keyframeOffsets.data(), (i32)(keyframeOffsets.size() * sizeof(u32)));
+	CRC32_ProcessBuffer(&crc, data.data(), (i32)data.size());
+	CRC32_Final(&crc);
+	header.dataCRC = crc;
+}
+
+bool Surf::replay::IsHeaderValid(const ReplayFileHeader &header, u64 fileSize)
+{
+	if (fileSize < sizeof(ReplayFileHeader) || header.magic != REPLAY_FILE_MAGIC || header.version != REPLAY_FILE_VERSION
+		|| header.headerSize != sizeof(ReplayFileHeader) || header.keyframeInterval == 0)
+	{
+		return false;
+	}
+	if (header.keyframeCount != (header.frameCount + header.keyframeInterval - 1) / header.keyframeInterval)
+	{
+		return false;
+	}
+	return (u64)header.headerSize + (u64)header.keyframeCount * sizeof(u32) + header.dataSize == fileSize;
+}
+
+void Surf::replay::SanitizePathComponent(const char *input, char *output, u32 size)
+{
+	u32 i = 0;
+	for (; input[i] && i < size - 1; i++)
+	{
+		char c = input[i];
+		bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+		output[i] = allowed ? c : '_';
+	}
+	output[i] = '\0';
+}
+
+void Surf::replay::GetReplayDirectory(const char *mapName, const char *courseName, const char *modeName, char *buffer, u32 size, bool absolute)
+{
+	char map[64], course[SURF_MAX_COURSE_NAME_LENGTH], mode[64];
+	Surf::replay::SanitizePathComponent(mapName, map, sizeof(map));
+	Surf::replay::SanitizePathComponent(courseName, course, sizeof(course));
+	Surf::replay::SanitizePathComponent(modeName, mode, sizeof(mode));
+	if (absolute)
+	{
+		g_SMAPI->PathFormat(buffer, size, "%s/addons/cs2surf/replays/%s/%s/%s", g_SMAPI->GetBaseDir(), map, course, mode);
+	}
+	else
+	{
+		g_SMAPI->PathFormat(buffer, size, "addons/cs2surf/replays/%s/%s/%s", map, course, mode);
+	}
+}
+
+void Surf::replay::GetReplayFilePath(const char *mapName, const char *courseName, const char *modeName, const char *styles, u64 steamID64,
+									 char *buffer, u32 size, bool absolute)
+{
+	char directory[MAX_PATH];
+	Surf::replay::GetReplayDirectory(mapName, courseName, modeName, directory, sizeof(directory), absolute);
+	char sanitizedStyles[128];
+	Surf::replay::SanitizePathComponent(styles, sanitizedStyles, sizeof(sanitizedStyles));
+	if (sanitizedStyles[0])
+	{
+		V_snprintf(buffer, size, "%s/%llu_%s%s", directory, steamID64, sanitizedStyles, REPLAY_FILE_EXT);
+	}
+	else
+	{
+		V_snprintf(buffer, size, "%s/%llu%s", directory, steamID64, REPLAY_FILE_EXT);
+	}
+}
+
+bool ReplayFileView::Open(const char *path)
+{
+	this->Close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	this->fileHandle = file;
+	this->mappingHandle = mapping;
+	this->data = (const u8 *)view;
+	this->size = (u64)fileSize.QuadPart;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	void *view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+	madvise(view, (size_t)info.st_size, MADV_SEQUENTIAL);
+	this->data = (const u8 *)view;
+	this->size = (u64)info.st_size;
+#endif
+	return true;
+}
+
+void ReplayFileView::Close()
+{
+	if (!this->data)
+	{
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(this->data);
+	CloseHandle(this->mappingHandle);
+	CloseHandle(this->fileHandle);
+	this->fileHandle = nullptr;
+	this->mappingHandle = nullptr;
+#else
+	munmap((void *)this->data, (size_t)this->size);
+#endif
+	this->data = nullptr;
+	this->size = 0;
+}
+
+void ReplayFrameDecoder::Init(const u8 *data, u32 dataSize, const u32 *keyframeOffsets, u32 keyframeCount, u32 keyframeInterval, u32 frameCount)
+{
+	this->data = data;
+	this->dataSize = dataSize;
+	this->keyframeOffsets = keyframeOffsets;
+	this->keyframeCount = keyframeCount;
+	this->keyframeInterval = keyframeInterval;
+	this->frameCount = frameCount;
+	this->offset = 0;
+	this->frameIndex = 0;
+	this->previous = {};
+}
+
+bool ReplayFrameDecoder::Next(ReplayFrame &frame)
+{
+	if (this->frameIndex >= this->frameCount || this->offset >= this->dataSize)
+	{
+		return false;
+	}
+	if (this->frameIndex % this->keyframeInterval == 0)
+	{
+		this->previous = {};
+	}
+
+	ReplayQuantizedFrame &current = this->previous;
+	u8 changes = this->data[this->offset++];
+	u64 value;
+	for (u32 i = 0; i < 3; i++)
+	{
+		if (!ReadVarInt(this->data, this->dataSize, this->offset, value))
+		{
+			return false;
+		}
+		current.origin[i] += ZigZagDecode((u32)value);
+	}
+	for (u32 i = 0; i < 3; i++)
+	{
+		if (!ReadVarInt(this->data, this->dataSize, this->offset, value))
+		{
+			return false;
+		}
+		current.velocity[i] += ZigZagDecode((u32)value);
+	}
+	if (!ReadVarInt(this->data, this->dataSize, this->offset, value))
+	{
+		return false;
+	}
+	current.pitch += (u16)ZigZagDecode((u32)value);
+	if (!ReadVarInt(this->data, this->dataSize, this->offset, value))
+	{
+		return false;
+	}
+	current.yaw += (u16)ZigZagDecode((u32)value);
+	if (changes & REPLAY_CHANGED_BUTTONS)
+	{
+		if (!ReadVarInt(this->data, this->dataSize, this->offset, value))
+		{
+			return false;
+		}
+		current.buttons ^= value;
+	}
+	if (changes & REPLAY_CHANGED_FLAGS)
+	{
+		if (!ReadVarInt(this->data, this->dataSize, this->offset, value))
+		{
+			return false;
+		}
+		current.flags ^= (u32)value;
+	}
+	if (changes & REPLAY_CHANGED_MOVETYPE)
+	{
+		if (this->offset >= this->dataSize)
+		{
+			return false;
+		}
+		current.moveType = this->data[this->offset++];
+	}
+
+	for (u32 i = 0; i < 3; i++)
+	{
+		frame.origin[i] = current.origin[i] / REPLAY_POSITION_SCALE;
+		frame.velocity[i] = current.velocity[i] / REPLAY_VELOCITY_SCALE;
+	}
+	frame.pitch = DequantizeAngle(current.pitch);
+	frame.yaw = DequantizeAngle(current.yaw);
+	frame.buttons = current.buttons;
+	frame.flags = current.flags;
+	frame.moveType = current.moveType;
+	this->frameIndex++;
+	return true;
+}
+
+bool ReplayFrameDecoder::Seek(u32 frameIndex)
+{
+	if (frameIndex >= this->frameCount)
+	{
+		return false;
+	}
+	// Going forward within the current keyframe block doesn't need a restart.
+	if (frameIndex < this->frameIndex || frameIndex / this->keyframeInterval != this->frameIndex / this->keyframeInterval)
+	{
+		u32 keyframe = frameIndex / this->keyframeInterval;
+		if (keyframe >= this->keyframeCount || this->keyframeOffsets[keyframe] >= this->dataSize)
+		{
+			return false;
+		}
+		this->offset = this->keyframeOffsets[keyframe];
+		this->frameIndex = keyframe * this->keyframeInterval;
+		this->previous = {};
+	}
+	ReplayFrame frame;
+	while (this->frameIndex < frameIndex)
+	{
+		if (!this->Next(frame))
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "common.h"
+#include "surf_replays.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+	Replay file layout, everything little endian:
+
+	ReplayFileHeader
+	u32 keyframeOffsets[keyframeCount]  Byte offsets into the frame data, one every keyframeInterval frames.
+	u8 frameData[dataSize]
+
+	Every frame is encoded against the previous one:
+	u8 changes                          REPLAY_CHANGED_* bits.
+	varint origin[3], velocity[3]       Zigzag deltas of the quantized values.
+	varint pitch, yaw                   Zigzag deltas of the angles as 16-bit fractions of a full turn.
+	varint buttons                      XOR with the previous buttons, only if REPLAY_CHANGED_BUTTONS is set.
+	varint flags                        XOR with the previous flags, only if REPLAY_CHANGED_FLAGS is set.
+	u8 moveType                         Only if REPLAY_CHANGED_MOVETYPE is set.
+
+	Keyframes are encoded against an all-zero frame so decoding can start at any of them.
+*/
+
+#define REPLAY_FILE_MAGIC   0x4C505253 // "SRPL"
+// 1 had no reserved space at the end of the header, those files are rejected like any other unknown version.
+#define REPLAY_FILE_VERSION 2
+#define REPLAY_FILE_EXT     ".replay"
+
+#define REPLAY_KEYFRAME_INTERVAL 512
+#define REPLAY_POSITION_SCALE    32.0f
+#define REPLAY_VELOCITY_SCALE    8.0f
+#define REPLAY_ANGLE_SCALE       (65536.0f / 360.0f)
+
+// Upper bound of a single encoded frame: change bits, 8 deltas, buttons, flags and move type.
+#define REPLAY_MAX_ENCODED_FRAME_SIZE (1 + 8 * 5 + 10 + 5 + 1)
+
+#define REPLAY_CHANGED_BUTTONS  (1 << 0)
+#define REPLAY_CHANGED_FLAGS    (1 << 1)
+#define REPLAY_CHANGED_MOVETYPE (1 << 2)
+
+#pragma pack(push, 1)
+
+struct ReplayFileHeader
+{
+	u32 magic;
+	u16 version;
+	u16 headerSize;
+	u64 steamID64;
+	u64 styleIDFlags;
+	// Unix timestamp of the run.
+	u64 timestamp;
+	f64 time;
+	f32 tickInterval;
+	u32 frameCount;
+	u32 keyframeInterval;
+	u32 keyframeCount;
+	u32 dataSize;
+	// CRC32 of the keyframe table and the frame data.
+	u32 dataCRC;
+	char mapMD5[33];
+	char mapName[64];
+	char courseName[SURF_MAX_COURSE_NAME_LENGTH];
+	char modeName[64];
+	// Short names of the styles, comma separated.
+	char styles[128];
+	char playerName[128];
+	// Keeps the keyframe table that follows 4-byte aligned, and leaves room for future fields.
+	char reserved[30];
+};
+
+// What the replay index knows about a replay file.
+struct ReplayIndexEntry
+{
+	u64 steamID64;
+	u64 styleIDFlags;
+	f64 time;
+	// Where the frame data starts in the replay file, and the checksum from its header.
+	u32 dataOffset;
+	u32 dataCRC;
+	char mapMD5[33];
+	char courseName[SURF_MAX_COURSE_NAME_LENGTH];
+	char modeName[64];
+	char styles[128];
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(ReplayFileHeader) == 576, "Replay file header size changed, bump REPLAY_FILE_VERSION");
+
+// Frame values as they are stored, after quantization.
+struct ReplayQuantizedFrame
+{
+	i32 origin[3];
+	i32 velocity[3];
+	u16 pitch;
+	u16 yaw;
+	u64 buttons;
+	u32 flags;
+	u8 moveType;
+};
+
+// A finished run waiting for the writer thread. Everything it needs is copied so the game thread can move on.
+struct ReplayWriteJob
+{
+	ReplayFileHeader header;
+	std::vector<ReplayFrame> frames;
+	// Absolute paths.
+	std::string directory;
+	std::string path;
+};
+
+namespace Surf::replay
+{
+	void StartWriter();
+	// Finish the pending writes and stop the writer thread.
+	void StopWriter();
+	// Takes ownership of the job.
+	void QueueWrite(ReplayWriteJob *job);
+	// Run something on the writer thread, after everything queued before it.
+	void QueueTask(std::function<void()> task);
+
+	// Load the replay index of a map in the background, building it from the replay files if there is none yet.
+	void LoadIndex(const char *mapName, const char *mapMD5);
+	// Record a replay that was just written. Called from the writer thread.
+	void CommitToIndex(const ReplayFileHeader &header);
+	// Fastest replay of a course, mode and style combination recorded on this version of the map.
+	// Returns false while the index of another map is still loaded, as it is right after a map change.
+	bool FindBestReplay(const char *mapName, const char *mapMD5, const char *courseName, const char *modeName, const char *styles,
+						ReplayIndexEntry &entry);
+
+	// Encode frames and fill in the frame related fields of the header (frame count, keyframes, data size and CRC).
+	void EncodeFrames(const ReplayFrame *frames, u32 count, ReplayFileHeader &header, std::vector<u32> &keyframeOffsets, std::vector<u8> &data);
+
+	// Check that a header describes a replay this version can read.
+	bool IsHeaderValid(const ReplayFileHeader &header, u64 fileSize);
+
+	// Strip characters that have no business being in a file name.
+	void SanitizePathComponent(const char *input, char *output, u32 size);
+
+	// Directory holding the replays of a course, either absolute or relative to the game directory.
+	void GetReplayDirectory(const char *mapName, const char *courseName, const char *modeName, char *buffer, u32 size, bool absolute);
+	// Each player has one replay per course, mode and style combination.
+	void GetReplayFilePath(const char *mapName, const char *courseName, const char *modeName, const char *styles, u64 steamID64, char *buffer,
+						   u32 size, bool absolute);
+} // namespace Surf::replay
+
+// Decodes the frames of a replay one at a time, straight from the encoded data.
+class ReplayFrameDecoder
+{
+public:
+	void Init(const u8 *data, u32 dataSize, const u32 *keyframeOffsets, u32 keyframeCount, u32 keyframeInterval, u32 frameCount);
+
+	// Decode the next frame, returns false at the end of the data or if the data is malformed.
+	bool Next(ReplayFrame &frame);
+
+	// Jump to a frame. Decodes forward from the closest keyframe before it.
+	bool Seek(u32 frameIndex);
+
+	u32 GetFrameIndex()
+	{
+		return this->frameIndex;
+	}
+
+	u32 GetFrameCount()
+	{
+		return this->frameCount;
+	}
+
+private:
+	const u8 *data {};
+	u32 dataSize {};
+	const u32 *keyframeOffsets {};
+	u32 keyframeCount {};
+	u32 keyframeInterval {};
+	u32 frameCount {};
+
+	u32 offset {};
+	u32 frameIndex {};
+	ReplayQuantizedFrame previous {};
+};
+
+// Read-only memory mapping of a replay file. Pages are only read from disk once they are touched.
+class ReplayFileView
+{
+public:
+	~ReplayFileView()
+	{
+		this->Close();
+	}
+
+	bool Open(const char *path);
+	void Close();
+
+	const u8 *GetData()
+	{
+		return this->data;
+	}
+
+	u64 GetSize()
+	{
+		return this->size;
+	}
+
+private:
+	const u8 *data {};
+	u64 size {};
+#ifdef _WIN32
+	void *fileHandle {};
+	void *mappingHandle {};
+#endif
+};
+
+// State of a replay bot playing back a file.
+struct ReplayPlayback
+{
+	ReplayFileHeader header;
+	ReplayFileView file;
+	ReplayFrameDecoder decoder;
+	ReplayFrame lastFrame;
+	u32 courseGUID;
+	// Ticks left to stand still at the start or the end of the run.
+	u32 holdTicks;
+	bool restartPending;
+	// Used to pick which bot to reuse once the limit is reached.
+	f64 lastRequestTime;
+};
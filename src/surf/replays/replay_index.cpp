@@ -0,0 +1,362 @@
+/*
+	Per-map index of the replays on disk.
+
+	Finding the best replay of a course used to mean opening every replay file in its directory. The index keeps the header
+	fields needed to pick a replay in memory, and is saved next to the replays so it only has to be read once per map.
+	Loading and saving happen on the replay writer thread; the game thread only ever does lookups.
+*/
+
+#include "replay_file.h"
+#include "cs2surf.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "tier0/memdbgon.h"
+
+#define REPLAY_INDEX_MAGIC   0x49505253 // "SRPI"
+// Bumped with REPLAY_FILE_VERSION so indexes listing older replay files are rebuilt.
+#define REPLAY_INDEX_VERSION 2
+#define REPLAY_INDEX_FILE    "index.bin"
+
+#pragma pack(push, 1)
+
+struct ReplayIndexHeader
+{
+	u32 magic;
+	u16 version;
+	u16 entrySize;
+	u32 entryCount;
+	char mapName[64];
+};
+
+#pragma pack(pop)
+
+static_global struct
+{
+	std::mutex mutex;
+	// Map and map version the index belongs to.
+	std::string mapName;
+	std::string mapMD5;
+	// Every replay of the map, keyed by course, mode, styles and player.
+	std::unordered_map<std::string, ReplayIndexEntry> entries;
+	// Key of the fastest replay for each course, mode and style combination on the current map version.
+	std::unordered_map<std::string, std::string> best;
+} g_replayIndex;
+
+static_function std::string Index_GetCourseKey(const char *courseName, const char *modeName, const char *styles)
+{
+	std::string key = courseName;
+	key += '\n';
+	key += modeName;
+	key += '\n';
+	key += styles;
+	return key;
+}
+
+static_function std::string Index_GetEntryKey(const ReplayIndexEntry &entry)
+{
+	return Index_GetCourseKey(entry.courseName, entry.modeName, entry.styles) + '\n' + std::to_string(entry.steamID64);
+}
+
+static_function void Index_GetPath(const char *mapName, char *buffer, u32 size)
+{
+	char map[64];
+	Surf::replay::SanitizePathComponent(mapName, map, sizeof(map));
+	g_SMAPI->PathFormat(buffer, size, "%s/addons/cs2surf/replays/%s/%s", g_SMAPI->GetBaseDir(), map, REPLAY_INDEX_FILE);
+}
+
+static_function void Index_EntryFromHeader(const ReplayFileHeader &header, ReplayIndexEntry &entry)
+{
+	entry = {};
+	entry.steamID64 = header.steamID64;
+	entry.styleIDFlags = header.styleIDFlags;
+	entry.time = header.time;
+	entry.dataOffset = header.headerSize + header.keyframeCount * sizeof(u32);
+	entry.dataCRC = header.dataCRC;
+	V_strncpy(entry.mapMD5, header.mapMD5, sizeof(entry.mapMD5));
+	V_strncpy(entry.courseName, header.courseName, sizeof(entry.courseName));
+	V_strncpy(entry.modeName, header.modeName, sizeof(entry.modeName));
+	V_strncpy(entry.styles, header.styles, sizeof(entry.styles));
+}
+
+static_function bool Index_Read(const char *mapName, std::vector<ReplayIndexEntry> &entries)
+{
+	char path[MAX_PATH];
+	Index_GetPath(mapName, path, sizeof(path));
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	ReplayIndexHeader header;
+	bool success = fread(&header, sizeof(header), 1, file) == 1 && header.magic == REPLAY_INDEX_MAGIC && header.version == REPLAY_INDEX_VERSION
+				   && header.entrySize == sizeof(ReplayIndexEntry);
+	if (success)
+	{
+		entries.resize(header.entryCount);
+		success = header.entryCount == 0 || fread(entries.data(), sizeof(ReplayIndexEntry), header.entryCount, file) == header.entryCount;
+	}
+	fclose(file);
+	if (!success)
+	{
+		entries.clear();
+	}
+	return success;
+}
+
+static_function void Index_Write(const char *mapName, const std::vector<ReplayIndexEntry> &entries)
+{
+	char path[MAX_PATH];
+	Index_GetPath(mapName, path, sizeof(path));
+	std::string tempPath = std::string(path) + ".tmp";
+	FILE *file = fopen(tempPath.c_str(), "wb");
+	if (!file)
+	{
+		META_CONPRINTF("[Surf::Replay] Failed to open '%s' for writing.\n", tempPath.c_str());
+		return;
+	}
+	ReplayIndexHeader header {};
+	header.magic = REPLAY_INDEX_MAGIC;
+	header.version = REPLAY_INDEX_VERSION;
+	header.entrySize = sizeof(ReplayIndexEntry);
+	header.entryCount = (u32)entries.size();
+	V_strncpy(header.mapName, mapName, sizeof(header.mapName));
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (success && !entries.empty())
+	{
+		success = fwrite(entries.data(), sizeof(ReplayIndexEntry), entries.size(), file) == entries.size();
+	}
+	success &= fclose(file) == 0;
+	remove(path);
+	if (!success || rename(tempPath.c_str(), path) != 0)
+	{
+		META_CONPRINTF("[Surf::Replay] Failed to write '%s'.\n", path);
+		remove(tempPath.c_str());
+	}
+}
+
+static_function void Index_ListDirectory(const std::string &directory, bool wantDirectories, std::vector<std::string> &names)
+{
+#ifdef _WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	do
+	{
+		bool isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+		if (isDirectory == wantDirectories && data.cFileName[0] != '.')
+		{
+			names.push_back(data.cFileName);
+		}
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+#else
+	DIR *dir = opendir(directory.c_str());
+	if (!dir)
+	{
+		return;
+	}
+	while (dirent *entry = readdir(dir))
+	{
+		if (entry->d_name[0] == '.')
+		{
+			continue;
+		}
+		struct stat info;
+		if (stat((directory + "/" + entry->d_name).c_str(), &info) != 0)
+		{
+			continue;
+		}
+		if (S_ISDIR(info.st_mode) == wantDirectories)
+		{
+			names.push_back(entry->d_name);
+		}
+	}
+	closedir(dir);
+#endif
+}
+
+// Only needed when there is no index yet, for example for replays recorded before the index existed.
+static_function void Index_Rebuild(const char *mapName, std::vector<ReplayIndexEntry> &entries)
+{
+	char map[64];
+	Surf::replay::SanitizePathComponent(mapName, map, sizeof(map));
+	char mapDirectory[MAX_PATH];
+	g_SMAPI->PathFormat(mapDirectory, sizeof(mapDirectory), "%s/addons/cs2surf/replays/%s", g_SMAPI->GetBaseDir(), map);
+
+	std::vector<std::string> courses;
+	Index_ListDirectory(mapDirectory, true, courses);
+	for (const std::string &course : courses)
+	{
+		std::string courseDirectory = std::string(mapDirectory) + "/" + course;
+		std::vector<std::string> modes;
+		Index_ListDirectory(courseDirectory, true, modes);
+		for (const std::string &mode : modes)
+		{
+			std::string modeDirectory = courseDirectory + "/" + mode;
+			std::vector<std::string> files;
+			Index_ListDirectory(modeDirectory, false, files);
+			for (const std::string &fileName : files)
+			{
+				if (!V_strstr(fileName.c_str(), REPLAY_FILE_EXT) || V_strstr(fileName.c_str(), ".tmp"))
+				{
+					continue;
+				}
+				FILE *file = fopen((modeDirectory + "/" + fileName).c_str(), "rb");
+				if (!file)
+				{
+					continue;
+				}
+				ReplayFileHeader header;
+				bool valid = fread(&header, sizeof(header), 1, file) == 1 && header.magic == REPLAY_FILE_MAGIC && header.version == REPLAY_FILE_VERSION;
+				fclose(file);
+				if (valid)
+				{
+					ReplayIndexEntry entry;
+					Index_EntryFromHeader(header, entry);
+					entries.push_back(entry);
+				}
+			}
+		}
+	}
+}
+
+// Must be called with the index locked.
+static_function void Index_UpdateBest(const std::string &entryKey, const ReplayIndexEntry &entry)
+{
+	if (g_replayIndex.mapMD5 != entry.mapMD5)
+	{
+		return;
+	}
+	std::string courseKey = Index_GetCourseKey(entry.courseName, entry.modeName, entry.styles);
+	auto best = g_replayIndex.best.find(courseKey);
+	if (best == g_replayIndex.best.end())
+	{
+		g_replayIndex.best.emplace(courseKey, entryKey);
+		return;
+	}
+	if (best->second != entryKey)
+	{
+		if (entry.time < g_replayIndex.entries[best->second].time)
+		{
+			best->second = entryKey;
+		}
+		return;
+	}
+
+	// The best replay itself changed, it might not be the fastest anymore.
+	for (const auto &[key, other] : g_replayIndex.entries)
+	{
+		if (g_replayIndex.mapMD5 == other.mapMD5 && other.time < g_replayIndex.entries[best->second].time
+			&& Index_GetCourseKey(other.courseName, other.modeName, other.styles) == courseKey)
+		{
+			best->second = key;
+		}
+	}
+}
+
+static_function void Index_Load(std::string mapName, std::string mapMD5)
+{
+	std::vector<ReplayIndexEntry> entries;
+	if (!Index_Read(mapName.c_str(), entries))
+	{
+		Index_Rebuild(mapName.c_str(), entries);
+		if (!entries.empty())
+		{
+			Index_Write(mapName.c_str(), entries);
+		}
+	}
+
+	std::unique_lock lock(g_replayIndex.mutex);
+	g_replayIndex.mapName = mapName;
+	g_replayIndex.mapMD5 = mapMD5;
+	g_replayIndex.entries.clear();
+	g_replayIndex.best.clear();
+	for (const ReplayIndexEntry &entry : entries)
+	{
+		std::string key = Index_GetEntryKey(entry);
+		g_replayIndex.entries[key] = entry;
+		Index_UpdateBest(key, entry);
+	}
+	META_CONPRINTF("[Surf::Replay] Loaded replay index for %s (%i replays).\n", mapName.c_str(), (i32)entries.size());
+}
+
+void Surf::replay::LoadIndex(const char *mapName, const char *mapMD5)
+{
+	Surf::replay::QueueTask([mapName = std::string(mapName), mapMD5 = std::string(mapMD5)]() { Index_Load(mapName, mapMD5); });
+}
+
+void Surf::replay::CommitToIndex(const ReplayFileHeader &header)
+{
+	ReplayIndexEntry entry;
+	Index_EntryFromHeader(header, entry);
+	std::string key = Index_GetEntryKey(entry);
+
+	std::vector<ReplayIndexEntry> entries;
+	{
+		std::unique_lock lock(g_replayIndex.mutex);
+		if (g_replayIndex.mapName == header.mapName)
+		{
+			g_replayIndex.entries[key] = entry;
+			Index_UpdateBest(key, entry);
+			entries.reserve(g_replayIndex.entries.size());
+			for (const auto &[_, indexEntry] : g_replayIndex.entries)
+			{
+				entries.push_back(indexEntry);
+			}
+		}
+	}
+
+	// The run was finished on a map that isn't loaded anymore, update its index on disk directly.
+	if (entries.empty())
+	{
+		if (!Index_Read(header.mapName, entries))
+		{
+			Index_Rebuild(header.mapName, entries);
+		}
+		bool found = false;
+		for (ReplayIndexEntry &indexEntry : entries)
+		{
+			if (Index_GetEntryKey(indexEntry) == key)
+			{
+				indexEntry = entry;
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			entries.push_back(entry);
+		}
+	}
+	Index_Write(header.mapName, entries);
+}
+
+bool Surf::replay::FindBestReplay(const char *mapName, const char *mapMD5, const char *courseName, const char *modeName, const char *styles,
+								  ReplayIndexEntry &entry)
+{
+	std::unique_lock lock(g_replayIndex.mutex);
+	// The index is loaded on the writer thread, it can still belong to the previous map.
+	if (g_replayIndex.mapName != mapName || g_replayIndex.mapMD5 != mapMD5)
+	{
+		return false;
+	}
+	auto best = g_replayIndex.best.find(Index_GetCourseKey(courseName, modeName, styles));
+	if (best == g_replayIndex.best.end())
+	{
+		return false;
+	}
+	entry = g_replayIndex.entries[best->second];
+	return true;
+}
@@ -0,0 +1,195 @@
+/*
+	Background writer for finished runs.
+
+	The game thread only copies the frames of a run out of the recording buffer, encoding and all file system access happen here.
+	The replay index is loaded and saved on the same thread, which keeps it in order with the replays it describes.
+	Each player keeps a single replay per map, course, mode and style combination, a new run only replaces it if it's faster
+	or if the old one was recorded on a different version of the map.
+*/
+
+#include "replay_file.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "tier0/memdbgon.h"
+
+static_global struct
+{
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::function<void()>> tasks;
+	bool running;
+} g_replayWriter;
+
+static_function void Writer_CreateDirectory(const std::string &directory)
+{
+	std::string path;
+	path.reserve(directory.size());
+	for (size_t i = 0; i < directory.size(); i++)
+	{
+		char c = directory[i];
+		if ((c == '/' || c == '\\') && !path.empty())
+		{
+#ifdef _WIN32
+			_mkdir(path.c_str());
+#else
+			mkdir(path.c_str(), 0775);
+#endif
+		}
+		path.push_back(c);
+	}
+#ifdef _WIN32
+	_mkdir(path.c_str());
+#else
+	mkdir(path.c_str(), 0775);
+#endif
+}
+
+// Whether the replay already on disk should be kept over the new one.
+static_function bool Writer_ShouldKeepExisting(const ReplayWriteJob *job)
+{
+	FILE *file = fopen(job->path.c_str(), "rb");
+	if (!file)
+	{
+		return false;
+	}
+	ReplayFileHeader existing;
+	bool readHeader = fread(&existing, sizeof(existing), 1, file) == 1;
+	fclose(file);
+	if (!readHeader || existing.magic != REPLAY_FILE_MAGIC || existing.version != REPLAY_FILE_VERSION)
+	{
+		return false;
+	}
+	return SURF_STREQ(existing.mapMD5, job->header.mapMD5) && existing.time <= job->header.time;
+}
+
+static_function void Writer_ProcessJob(ReplayWriteJob *job)
+{
+	if (Writer_ShouldKeepExisting(job))
+	{
+		return;
+	}
+
+	std::vector<u32> keyframeOffsets;
+	std::vector<u8> data;
+	Surf::replay::EncodeFrames(job->frames.data(), (u32)job->frames.size(), job->header, keyframeOffsets, data);
+
+	Writer_CreateDirectory(job->directory);
+	// Write to a temporary file first so a crash never leaves a half written replay behind.
+	std::string tempPath = job->path + ".tmp";
+	FILE *file = fopen(tempPath.c_str(), "wb");
+	if (!file)
+	{
+		META_CONPRINTF("[Surf::Replay] Failed to open '%s' for writing.\n", tempPath.c_str());
+		return;
+	}
+	bool success = fwrite(&job->header, sizeof(job->header), 1, file) == 1;
+	if (success && !keyframeOffsets.empty())
+	{
+		success = fwrite(keyframeOffsets.data(), sizeof(u32), keyframeOffsets.size(), file) == keyframeOffsets.size();
+	}
+	if (success && !data.empty())
+	{
+		success = fwrite(data.data(), 1, data.size(), file) == data.size();
+	}
+	success &= fclose(file) == 0;
+	if (!success)
+	{
+		META_CONPRINTF("[Surf::Replay] Failed to write '%s'.\n", tempPath.c_str());
+		remove(tempPath.c_str());
+		return;
+	}
+
+	// rename() doesn't replace existing files on Windows.
+	remove(job->path.c_str());
+	if (rename(tempPath.c_str(), job->path.c_str()) != 0)
+	{
+		META_CONPRINTF("[Surf::Replay] Failed to move '%s' into place.\n", tempPath.c_str());
+		remove(tempPath.c_str());
+		return;
+	}
+
+	Surf::replay::CommitToIndex(job->header);
+	META_CONPRINTF("[Surf::Replay] Saved '%s' (%u frames, %llu bytes, %.1f%% of raw size).\n", job->path.c_str(), job->header.frameCount,
+				   (u64)(sizeof(job->header) + keyframeOffsets.size() * sizeof(u32) + data.size()),
+				   job->frames.empty() ? 0.0 : 100.0 * data.size() / (job->frames.size() * sizeof(ReplayFrame)));
+}
+
+static_function void Writer_Thread()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock(g_replayWriter.mutex);
+			g_replayWriter.condition.wait(lock, []() { return !g_replayWriter.tasks.empty() || !g_replayWriter.running; });
+			if (g_replayWriter.tasks.empty())
+			{
+				return;
+			}
+			task = std::move(g_replayWriter.tasks.front());
+			g_replayWriter.tasks.pop_front();
+		}
+		task();
+	}
+}
+
+void Surf::replay::StartWriter()
+{
+	std::unique_lock lock(g_replayWriter.mutex);
+	if (g_replayWriter.running)
+	{
+		return;
+	}
+	g_replayWriter.running = true;
+	g_replayWriter.thread = std::thread(Writer_Thread);
+}
+
+void Surf::replay::StopWriter()
+{
+	{
+		std::unique_lock lock(g_replayWriter.mutex);
+		if (!g_replayWriter.running)
+		{
+			return;
+		}
+		g_replayWriter.running = false;
+	}
+	g_replayWriter.condition.notify_one();
+	if (g_replayWriter.thread.joinable())
+	{
+		g_replayWriter.thread.join();
+	}
+}
+
+void Surf::replay::QueueTask(std::function<void()> task)
+{
+	{
+		std::unique_lock lock(g_replayWriter.mutex);
+		if (!g_replayWriter.running)
+		{
+			return;
+		}
+		g_replayWriter.tasks.push_back(std::move(task));
+	}
+	g_replayWriter.condition.notify_one();
+}
+
+void Surf::replay::QueueWrite(ReplayWriteJob *job)
+{
+	// std::function needs a copyable callable, so the job travels as a shared pointer.
+	std::shared_ptr<ReplayWriteJob> sharedJob(job);
+	Surf::replay::QueueTask([sharedJob]() { Writer_ProcessJob(sharedJob.get()); });
+}
@@ -1 +1,246 @@
 #include "surf_replays.h"
+#include "cs2surf.h"
+#include "replay_file.h"
+#include "surf/mode/surf_mode.h"
+#include "surf/option/surf_option.h"
+#include "surf/style/surf_style.h"
+#include "surf/timer/surf_timer.h"
+#include "utils/utils.h"
+#include "sdk/cinbuttonstate.h"
+#include "sdk/services.h"
+#include "vprof.h"
+
+#include <ctime>
+
+#include "tier0/memdbgon.h"
+
+static_global class SurfTimerServiceEventListener_Replay : public SurfTimerServiceEventListener
+{
+	// The timer of replay bots follows the replay, not the zones they fly through.
+	virtual bool OnTimerStart(SurfPlayer *player, u32 courseGUID) override
+	{
+		return !player->replayService->IsPlayingBack();
+	}
+
+	virtual bool OnTimerEnd(SurfPlayer *player, u32 courseGUID, f32 time) override
+	{
+		return !player->replayService->IsPlayingBack();
+	}
+
+	virtual void OnTimerStartPost(SurfPlayer *player, u32 courseGUID) override;
+	virtual void OnTimerEndPost(SurfPlayer *player, u32 courseGUID, f32 time) override;
+	virtual void OnTimerStopped(SurfPlayer *player, u32 courseGUID) override;
+} timerEventListener;
+
+void SurfReplayService::Init()
+{
+	SurfTimerService::RegisterEventListener(&timerEventListener);
+	Surf::replay::StartWriter();
+}
+
+void SurfReplayService::Cleanup()
+{
+	Surf::replay::StopWriter();
+}
+
+SurfReplayService::~SurfReplayService()
+{
+	this->StopPlayback();
+	delete[] this->frames;
+}
+
+void SurfReplayService::Reset()
+{
+	// The buffer itself is kept around, the next player in this slot will need it too.
+	this->frameCount = 0;
+	this->recordingRun = false;
+	this->runStartFrame = 0;
+	this->hasFinishedRun = false;
+	this->finishedRun = {};
+	this->StopPlayback();
+}
+
+u32 SurfReplayService::GetMaxFrames()
+{
+	f64 minutes = SurfOptionService::GetOptionFloat("replayMaxMinutes", SURF_REPLAY_DEFAULT_MAX_MINUTES);
+	minutes = Clamp(minutes, 0.0, SURF_REPLAY_MAX_MINUTES_LIMIT);
+	return (u32)(minutes * 60.0 / ENGINE_FIXED_TICK_INTERVAL);
+}
+
+bool SurfReplayService::EnsureBuffer()
+{
+	if (this->frames)
+	{
+		return true;
+	}
+	this->capacity = SurfReplayService::GetMaxFrames();
+	if (this->capacity == 0)
+	{
+		return false;
+	}
+	this->frames = new ReplayFrame[this->capacity];
+	this->frameCount = 0;
+	return true;
+}
+
+void SurfReplayService::OnPhysicsSimulatePost()
+{
+	VPROF_BUDGET(__func__, "CS2Surf");
+	if (this->playback)
+	{
+		this->UpdatePlayback();
+		return;
+	}
+	// Only the ticks of a run are worth keeping, and paused ticks are not part of the run time.
+	if (!this->recordingRun || this->player->timerService->GetPaused() || !this->player->IsAlive() || this->player->IsFakeClient())
+	{
+		return;
+	}
+	if (!this->EnsureBuffer())
+	{
+		this->recordingRun = false;
+		return;
+	}
+
+	ReplayFrame &frame = this->frames[this->frameCount % this->capacity];
+	this->player->GetOrigin(&frame.origin);
+	this->player->GetVelocity(&frame.velocity);
+	QAngle angles;
+	this->player->GetAngles(&angles);
+	frame.pitch = angles.x;
+	frame.yaw = angles.y;
+	CCSPlayer_MovementServices *ms = this->player->GetMoveServices();
+	frame.buttons = ms ? ms->m_nButtons()->m_pButtonStates[0] : 0;
+	frame.flags = this->player->GetPlayerPawn()->m_fFlags();
+	frame.moveType = (u8)this->player->GetMoveType();
+	this->frameCount++;
+
+	// Stop recording once the start of the run gets overwritten, it can't be saved anymore.
+	if (this->frameCount - this->runStartFrame > this->capacity)
+	{
+		this->recordingRun = false;
+	}
+}
+
+void SurfReplayService::OnTimerStartPost(u32 courseGUID)
+{
+	this->recordingRun = !this->player->IsFakeClient();
+	this->runStartFrame = this->frameCount;
+}
+
+void SurfReplayService::OnTimerEndPost(u32 courseGUID, f64 time)
+{
+	if (!this->recordingRun)
+	{
+		return;
+	}
+	this->recordingRun = false;
+
+	ReplayRun run {};
+	run.courseGUID = courseGUID;
+	run.time = time;
+	run.startFrame = this->runStartFrame;
+	run.endFrame = this->frameCount;
+	if (run.GetFrameCount() == 0 || !this->IsRunAvailable(run))
+	{
+		return;
+	}
+	this->finishedRun = run;
+	this->hasFinishedRun = true;
+	this->SaveRun(run);
+}
+
+void SurfReplayService::SaveRun(const ReplayRun &run)
+{
+	const SurfCourseDescriptor *course = Surf::course::GetCourse(run.courseGUID);
+	u64 steamID64 = this->player->GetSteamId64();
+	if (!course || !steamID64)
+	{
+		return;
+	}
+
+	ReplayWriteJob *job = new ReplayWriteJob();
+	ReplayFileHeader &header = job->header;
+	header.magic = REPLAY_FILE_MAGIC;
+	header.version = REPLAY_FILE_VERSION;
+	header.headerSize = sizeof(ReplayFileHeader);
+	header.steamID64 = steamID64;
+	header.timestamp = (u64)time(nullptr);
+	header.time = run.time;
+	header.tickInterval = ENGINE_FIXED_TICK_INTERVAL;
+	g_pSurfUtils->GetCurrentMapMD5(header.mapMD5, sizeof(header.mapMD5));
+	V_strncpy(header.mapName, g_pSurfUtils->GetCurrentMapName().Get(), sizeof(header.mapName));
+	V_strncpy(header.courseName, course->GetName().Get(), sizeof(header.courseName));
+	V_strncpy(header.modeName, Surf::mode::GetModeInfo(this->player->modeService).shortModeName.Get(), sizeof(header.modeName));
+	V_strncpy(header.playerName, this->player->GetName(), sizeof(header.playerName));
+	FOR_EACH_VEC(this->player->styleServices, i)
+	{
+		auto style = Surf::style::GetStyleInfo(this->player->styleServices[i]);
+		if (style.databaseID >= 0)
+		{
+			header.styleIDFlags |= (1ull << style.databaseID);
+		}
+		if (i > 0)
+		{
+			V_strncat(header.styles, ",", sizeof(header.styles));
+		}
+		V_strncat(header.styles, this->player->styleServices[i]->GetStyleShortName(), sizeof(header.styles));
+	}
+
+	// Copying the frames is the only part of the job done on the game thread.
+	job->frames.resize(run.GetFrameCount());
+	this->CopyRunFrames(run, job->frames.data());
+
+	char buffer[MAX_PATH];
+	Surf::replay::GetReplayDirectory(header.mapName, header.courseName, header.modeName, buffer, sizeof(buffer), true);
+	job->directory = buffer;
+	Surf::replay::GetReplayFilePath(header.mapName, header.courseName, header.modeName, header.styles, steamID64, buffer, sizeof(buffer), true);
+	job->path = buffer;
+
+	Surf::replay::QueueWrite(job);
+}
+
+void SurfReplayService::OnTimerStopped()
+{
+	this->recordingRun = false;
+}
+
+bool SurfReplayService::IsRunAvailable(const ReplayRun &run)
+{
+	return this->frames && run.startFrame <= run.endFrame && run.endFrame <= this->frameCount
+		   && this->frameCount - run.startFrame <= this->capacity;
+}
+
+bool SurfReplayService::CopyRunFrames(const ReplayRun &run, ReplayFrame *dest)
+{
+	if (!this->IsRunAvailable(run))
+	{
+		return false;
+	}
+
+	// At most two contiguous pieces, before and after the buffer wraps around.
+	u32 first = (u32)(run.startFrame % this->capacity);
+	u32 count = run.GetFrameCount();
+	u32 firstPart = MIN(count, this->capacity - first);
+	V_memcpy(dest, this->frames + first, firstPart * sizeof(ReplayFrame));
+	if (count > firstPart)
+	{
+		V_memcpy(dest + firstPart, this->frames, (count - firstPart) * sizeof(ReplayFrame));
+	}
+	return true;
+}
+
+void SurfTimerServiceEventListener_Replay::OnTimerStartPost(SurfPlayer *player, u32 courseGUID)
+{
+	player->replayService->OnTimerStartPost(courseGUID);
+}
+
+void SurfTimerServiceEventListener_Replay::OnTimerEndPost(SurfPlayer *player, u32 courseGUID, f32 time)
+{
+	player->replayService->OnTimerEndPost(courseGUID, time);
+}
+
+void SurfTimerServiceEventListener_Replay::OnTimerStopped(SurfPlayer *player, u32 courseGUID)
+{
+	player->replayService->OnTimerStopped();
+}
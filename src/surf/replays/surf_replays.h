@@ -1,7 +1,110 @@
 #pragma once
+
 #include "../surf.h"
 
+// How many minutes of movement each player can keep in memory. Runs longer than this cannot be saved.
+#define SURF_REPLAY_DEFAULT_MAX_MINUTES 15.0
+#define SURF_REPLAY_MAX_MINUTES_LIMIT   120.0
+
+// Default number of replay bots that can exist at the same time.
+#define SURF_REPLAY_DEFAULT_MAX_BOTS 4
+
+struct ReplayFileHeader;
+struct ReplayPlayback;
+
+// One tick of recorded movement. Roll is never used by players so only pitch and yaw are kept.
+struct ReplayFrame
+{
+	u64 buttons;
+	Vector origin;
+	Vector velocity;
+	f32 pitch;
+	f32 yaw;
+	u32 flags;
+	u8 moveType;
+};
+
+// A finished run, as a range of absolute frame numbers in the owner's recording buffer.
+struct ReplayRun
+{
+	u32 courseGUID;
+	f64 time;
+	// Inclusive.
+	u64 startFrame;
+	// Exclusive.
+	u64 endFrame;
+
+	u32 GetFrameCount() const
+	{
+		return (u32)(endFrame - startFrame);
+	}
+};
+
 class SurfReplayService : public SurfBaseService
 {
 	using SurfBaseService::SurfBaseService;
+
+public:
+	~SurfReplayService();
+
+	static void Init();
+	static void Cleanup();
+	static void OnActivateServer();
+
+	virtual void Reset() override;
+
+	void OnPhysicsSimulatePost();
+	void OnTimerStartPost(u32 courseGUID);
+	void OnTimerEndPost(u32 courseGUID, f64 time);
+	void OnTimerStopped();
+
+	bool HasFinishedRun()
+	{
+		return this->hasFinishedRun;
+	}
+
+	const ReplayRun &GetFinishedRun()
+	{
+		return this->finishedRun;
+	}
+
+	// Whether the frames of a run are still in the buffer and haven't been overwritten by newer ticks.
+	bool IsRunAvailable(const ReplayRun &run);
+
+	// Copy the frames of a run into the destination, which must have room for run.GetFrameCount() frames.
+	bool CopyRunFrames(const ReplayRun &run, ReplayFrame *dest);
+
+	// Playback, only used by replay bots.
+	bool IsPlayingBack()
+	{
+		return this->playback != nullptr;
+	}
+
+	// Spawn or reuse a bot playing the best replay of a course and mode, and make the requester watch it.
+	static bool RequestBot(SurfPlayer *requester, const SurfCourseDescriptor *course, const char *modeName);
+
+	bool StartPlayback(const char *path, u32 courseGUID, u32 expectedCRC);
+	void StopPlayback();
+	const ReplayFileHeader *GetPlaybackHeader();
+
+private:
+	// Lazily allocated on the first recorded tick and kept for the lifetime of the player slot.
+	ReplayFrame *frames {};
+	u32 capacity {};
+	// Total number of frames recorded, the next frame is written at frameCount % capacity.
+	u64 frameCount {};
+
+	bool recordingRun {};
+	u64 runStartFrame {};
+
+	bool hasFinishedRun {};
+	ReplayRun finishedRun {};
+
+	ReplayPlayback *playback {};
+	void UpdatePlayback();
+
+	static u32 GetMaxFrames();
+	bool EnsureBuffer();
+	// Hand the frames of a finished run to the replay writer thread.
+	void SaveRun(const ReplayRun &run);
 };
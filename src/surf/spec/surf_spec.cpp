@@ -65,7 +65,7 @@ bool SurfSpecService::SpectatePlayer(const char *playerName)
 	{
 		if (!this->player->IsAlive())
 		{
-			this->player->languageService->PrintChat(true, false, "Spectate Failure (Dead)");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Spectate Failure (Dead)"));
 			return false;
 		}
 		targetPlayer = this->player;
@@ -110,7 +110,7 @@ bool SurfSpecService::SpectatePlayer(const char *playerName)
 				{
 					if (otherPlayer->GetController()->GetTeam() == CS_TEAM_SPECTATOR)
 					{
-						player->languageService->PrintChat(true, false, "Spectate Failure (Dead)");
+						player->languageService->PrintChat(true, false, SURF_PHRASE("Spectate Failure (Dead)"));
 						return MRES_SUPERCEDE;
 					}
 					targetPlayer = otherPlayer;
@@ -122,7 +122,7 @@ bool SurfSpecService::SpectatePlayer(const char *playerName)
 
 	if (!targetPlayer)
 	{
-		player->languageService->PrintChat(true, false, "Spectate Failure (Player Not Found)", playerName);
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Spectate Failure (Player Not Found)"), playerName);
 		return MRES_SUPERCEDE;
 	}
 
@@ -135,7 +135,7 @@ bool SurfSpecService::SpectatePlayer(const char *playerName)
 	CPlayer_ObserverServices *obsService = player->GetController()->m_hObserverPawn()->m_pObserverServices;
 	if (!obsService)
 	{
-		player->languageService->PrintChat(true, false, "Spectate Failure (Generic)");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Spectate Failure (Generic)"));
 		return false;
 	}
 	// This needs to be set if the player spectates themself, so that the camera position is correct.
@@ -211,7 +211,7 @@ SCMD(surf_spec, SCFL_SPEC)
 	SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(controller);
 	if (!player->specService->CanSpectate())
 	{
-		player->languageService->PrintChat(true, false, "Spectate Failure (Generic)");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Spectate Failure (Generic)"));
 		return MRES_SUPERCEDE;
 	}
 	u32 numAlivePlayers = 0;
@@ -230,7 +230,7 @@ SCMD(surf_spec, SCFL_SPEC)
 	}
 	if (args->ArgC() < 2)
 	{
-		player->languageService->PrintChat(true, false, "Spec Command Usage", args->ArgS());
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Spec Command Usage"), args->ArgS());
 		return MRES_SUPERCEDE;
 	}
 
@@ -246,7 +246,7 @@ SCMD(surf_specs, SCFL_SPEC)
 
 	if (!targetPlayer)
 	{
-		player->languageService->PrintChat(true, false, "Spectator List (None)");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Spectator List (None)"));
 		return MRES_SUPERCEDE;
 	}
 	CUtlVector<CUtlString> spectatorList;
@@ -255,11 +255,11 @@ SCMD(surf_specs, SCFL_SPEC)
 	{
 		if (targetPlayer == player)
 		{
-			player->languageService->PrintChat(true, false, "Spectator List (None)");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Spectator List (None)"));
 		}
 		else
 		{
-			player->languageService->PrintChat(true, false, "Target Spectator List (None)", targetPlayer->GetName());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Target Spectator List (None)"), targetPlayer->GetName());
 		}
 	}
 	else
@@ -275,11 +275,11 @@ SCMD(surf_specs, SCFL_SPEC)
 		}
 		if (targetPlayer == player)
 		{
-			player->languageService->PrintChat(true, false, "Spectator List", spectatorList.Count(), spectatorListString.Get());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Spectator List"), spectatorList.Count(), spectatorListString.Get());
 		}
 		else
 		{
-			player->languageService->PrintChat(true, false, "Target Spectator List", targetPlayer->GetName(), spectatorList.Count(),
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Target Spectator List"), targetPlayer->GetName(), spectatorList.Count(),
 											   spectatorListString.Get());
 		}
 	}
@@ -214,7 +214,7 @@ void SurfStyleManager::AddStyle(SurfPlayer *player, const char *styleName, bool
 	// Don't add style if it doesn't exist. Instead, print a list of styles to the client.
 	if (!styleName || !V_stricmp("", styleName))
 	{
-		player->languageService->PrintChat(true, false, "Add Style Command Usage");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Add Style Command Usage"));
 		// clang-format off
 		SurfStyleManager::PrintAllStyles(player);
 		return;
@@ -224,7 +224,7 @@ void SurfStyleManager::AddStyle(SurfPlayer *player, const char *styleName, bool
 	{
 		if (!V_stricmp(player->styleServices[i]->GetStyleName(), styleName) || !V_stricmp(player->styleServices[i]->GetStyleShortName(), styleName))
 		{
-			player->languageService->PrintChat(true, false, "Style Already Active", styleName);
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Style Already Active"), styleName);
 			return;
 		}
 	}
@@ -243,7 +243,7 @@ void SurfStyleManager::AddStyle(SurfPlayer *player, const char *styleName, bool
 	{
 		if (!silent)
 		{
-			player->languageService->PrintChat(true, false, "Style Not Available", styleName);
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Style Not Available"), styleName);
 		}
 		return;
 	}
@@ -257,7 +257,7 @@ void SurfStyleManager::AddStyle(SurfPlayer *player, const char *styleName, bool
 			|| !player->styleServices[i]->IsCompatibleWithStyle(info.longName))
 		// clang-format on
 		{
-			player->languageService->PrintChat(true, false, "Style Conflict", styleName, player->styleServices[i]->GetStyleName());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Style Conflict"), styleName, player->styleServices[i]->GetStyleName());
 			return;
 		}
 	}
@@ -270,7 +270,7 @@ void SurfStyleManager::AddStyle(SurfPlayer *player, const char *styleName, bool
 	}
 	if (!silent)
 	{
-		player->languageService->PrintChat(true, false, "Style Added", info.longName);
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Style Added"), info.longName);
 	}
 
 	player->profileService->UpdateClantag();
@@ -280,7 +280,7 @@ void SurfStyleManager::RemoveStyle(SurfPlayer *player, const char *styleName, bo
 {
 	if (!styleName || !V_stricmp("", styleName))
 	{
-		player->languageService->PrintChat(true, false, "Remove Style Command Usage");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Remove Style Command Usage"));
 		return;
 	}
 
@@ -292,7 +292,7 @@ void SurfStyleManager::RemoveStyle(SurfPlayer *player, const char *styleName, bo
 			style->Cleanup();
 			if (!silent)
 			{
-				player->languageService->PrintChat(true, false, "Style Removed", style->GetStyleName());
+				player->languageService->PrintChat(true, false, SURF_PHRASE("Style Removed"), style->GetStyleName());
 			}
 			player->styleServices.Remove(i);
 			delete style;
@@ -305,7 +305,7 @@ void SurfStyleManager::RemoveStyle(SurfPlayer *player, const char *styleName, bo
 	}
 	if (!silent)
 	{
-		player->languageService->PrintChat(true, false, "Style Not Active", styleName);
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Style Not Active"), styleName);
 	}
 
 	player->profileService->UpdateClantag();
@@ -316,7 +316,7 @@ void SurfStyleManager::ToggleStyle(SurfPlayer *player, const char *styleName, bo
 	// Don't change style if it doesn't exist. Instead, print a list of styles to the client.
 	if (!styleName || !V_stricmp("", styleName))
 	{
-		player->languageService->PrintChat(true, false, "Toggle Style Command Usage");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Toggle Style Command Usage"));
 		SurfStyleManager::PrintAllStyles(player);
 		return;
 	}
@@ -330,7 +330,7 @@ void SurfStyleManager::ToggleStyle(SurfPlayer *player, const char *styleName, bo
 			style->Cleanup();
 			if (!silent)
 			{
-				player->languageService->PrintChat(true, false, "Style Removed", style->GetStyleName());
+				player->languageService->PrintChat(true, false, SURF_PHRASE("Style Removed"), style->GetStyleName());
 			}
 			player->styleServices.Remove(i);
 			delete style;
@@ -355,7 +355,7 @@ void SurfStyleManager::ToggleStyle(SurfPlayer *player, const char *styleName, bo
 	{
 		if (!silent)
 		{
-			player->languageService->PrintChat(true, false, "Style Not Available", styleName);
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Style Not Available"), styleName);
 		}
 		return;
 	}
@@ -369,7 +369,7 @@ void SurfStyleManager::ToggleStyle(SurfPlayer *player, const char *styleName, bo
 			|| !player->styleServices[i]->IsCompatibleWithStyle(info.longName))
 		// clang-format on
 		{
-			player->languageService->PrintChat(true, false, "Style Conflict", styleName, player->styleServices[i]->GetStyleName());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Style Conflict"), styleName, player->styleServices[i]->GetStyleName());
 			return;
 		}
 	}
@@ -382,7 +382,7 @@ void SurfStyleManager::ToggleStyle(SurfPlayer *player, const char *styleName, bo
 	}
 	if (!silent)
 	{
-		player->languageService->PrintChat(true, false, "Style Added", info.longName);
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Style Added"), info.longName);
 	}
 
 	player->profileService->UpdateClantag();
@@ -401,7 +401,7 @@ void SurfStyleManager::ClearStyles(SurfPlayer *player, bool silent, bool updateP
 	}
 	if (!silent)
 	{
-		player->languageService->PrintChat(true, false, "Styles Cleared");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Styles Cleared"));
 	}
 
 	player->profileService->UpdateClantag();
@@ -435,7 +435,7 @@ CUtlString SurfStyleManager::GetStylesString(SurfPlayer *player)
 
 void SurfStyleManager::PrintActiveStyles(SurfPlayer *player)
 {
-	player->languageService->PrintConsole(false, false, "Current Styles");
+	player->languageService->PrintConsole(false, false, SURF_PHRASE("Current Styles"));
 	FOR_EACH_VEC(player->styleServices, i)
 	{
 		// clang-format off
@@ -450,7 +450,7 @@ void SurfStyleManager::PrintActiveStyles(SurfPlayer *player)
 
 void SurfStyleManager::PrintAllStyles(SurfPlayer *player)
 {
-	player->languageService->PrintConsole(false, false, "Possible Styles");
+	player->languageService->PrintConsole(false, false, SURF_PHRASE("Possible Styles"));
 	FOR_EACH_VEC(styleInfos, i)
 	{
 		if (styleInfos[i].id < 0)
@@ -40,6 +40,7 @@ class SurfModeService;
 class SurfNoclipService;
 class SurfOptionService;
 class SurfQuietService;
+class SurfReplayService;
 class SurfSpecService;
 class SurfGotoService;
 class SurfProfileService;
@@ -154,6 +155,7 @@ public:
 	SurfSpecService *specService {};
 	SurfGotoService *gotoService {};
 	SurfProfileService *profileService {};
+	SurfReplayService *replayService {};
 	CUtlVector<SurfStyleService *> styleServices {};
 	SurfTelemetryService *telemetryService {};
 	SurfTimerService *timerService {};
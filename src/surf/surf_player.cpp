@@ -12,6 +12,7 @@
 #include "noclip/surf_noclip.h"
 #include "option/surf_option.h"
 #include "quiet/surf_quiet.h"
+#include "replays/surf_replays.h"
 #include "spec/surf_spec.h"
 #include "goto/surf_goto.h"
 #include "style/surf_style.h"
@@ -53,6 +54,7 @@ void SurfPlayer::Init()
 	delete this->triggerService;
 	delete this->globalService;
 	delete this->profileService;
+	delete this->replayService;
 
 	this->anticheatService = new SurfAnticheatService(this);
 	this->beamService = new SurfBeamService(this);
@@ -72,6 +74,7 @@ void SurfPlayer::Init()
 	this->triggerService = new SurfTriggerService(this);
 	this->globalService = new SurfGlobalService(this);
 	this->profileService = new SurfProfileService(this);
+	this->replayService = new SurfReplayService(this);
 
 	Surf::mode::InitModeService(this);
 }
@@ -94,6 +97,7 @@ void SurfPlayer::Reset()
 	this->triggerService->Reset();
 	this->beamService->Reset();
 	this->telemetryService->Reset();
+	this->replayService->Reset();
 
 	g_pSurfModeManager->SwitchToMode(this, SurfOptionService::GetOptionStr("defaultMode", SURF_DEFAULT_MODE), true, true);
 	g_pSurfStyleManager->ClearStyles(this, true);
@@ -122,6 +126,7 @@ void SurfPlayer::OnPlayerActive()
 void SurfPlayer::OnPlayerFullyConnect()
 {
 	this->anticheatService->OnPlayerFullyConnect();
+	this->profileService->OnPlayerFullyConnect();
 }
 
 void SurfPlayer::OnAuthorized()
@@ -160,6 +165,7 @@ void SurfPlayer::OnPhysicsSimulatePost()
 		this->styleServices[i]->OnPhysicsSimulatePost();
 	}
 	this->timerService->OnPhysicsSimulatePost();
+	this->replayService->OnPhysicsSimulatePost();
 	if (this->specService->GetSpectatedPlayer())
 	{
 		SurfHUDService::DrawPanels(this->specService->GetSpectatedPlayer(), this);
@@ -809,6 +815,7 @@ void SurfPlayer::UpdateTriggerTouchList()
 void SurfPlayer::OnChangeTeamPost(i32 team)
 {
 	this->timerService->OnPlayerJoinTeam(team);
+	this->profileService->OnPlayerJoinTeam();
 }
 
 const CVValue_t *SurfPlayer::GetCvarValueFromModeStyles(const char *name)
@@ -1,4 +1,5 @@
 #include "announce.h"
+#include "leaderboard.h"
 #include "surf/db/surf_db.h"
 #include "surf/global/surf_global.h"
 #include "surf/global/events.h"
@@ -127,7 +128,11 @@ RecordAnnounce::RecordAnnounce(SurfPlayer *player)
 	}
 
 	// Metadata
-	this->metadata = player->timerService->GetCurrentRunMetadata().Get();
+	this->splits = player->timerService->GetCurrentRunSplits();
+	if (global)
+	{
+		this->metadata = player->timerService->GetCurrentRunMetadata().Get();
+	}
 
 	// Previous GPBs
 	if (global)
@@ -217,7 +222,7 @@ void RecordAnnounce::UpdateGlobalCache()
 
 			if (this->time < this->oldGPB.overall.time)
 			{
-				player->timerService->InsertPBToCache(this->time, course, mode.id, true, this->metadata.c_str(), this->globalResponse.overall.points);
+				player->timerService->InsertPBToCache(this->time, course, mode.id, true, this->splits.c_str(), this->globalResponse.overall.points);
 			}
 		}
 	}
@@ -225,8 +230,32 @@ void RecordAnnounce::UpdateGlobalCache()
 
 void RecordAnnounce::SubmitLocal()
 {
-	auto onFailure = [uid = this->uid](std::string, int)
+	SurfPlayer *pl = g_pSurfPlayerManager->ToPlayer(this->userID);
+	// Cheaters are left out of the leaderboards, their ranks come from the database.
+	bool ranked = this->styles.empty() && pl && !pl->databaseService->isCheater;
+	LeaderboardPB previous {}, current {};
+	if (ranked)
 	{
+		if (Surf::leaderboard::Submit(this->course.localID, this->mode.localID, this->player.steamid64, this->player.name.c_str(), this->time,
+									  previous, current))
+		{
+			this->localResponse.received = true;
+			this->localResponse.overall.firstTime = !previous.hasPB;
+			this->localResponse.overall.pbDiff = previous.hasPB ? this->time - previous.time : 0.0f;
+			this->localResponse.overall.rank = current.rank;
+			this->localResponse.overall.maxRank = current.maxRank;
+		}
+	}
+	bool queryRanks = !this->localResponse.received;
+
+	auto onFailure = [uid = this->uid, submitted = this->localResponse.received, courseID = this->course.localID, modeID = this->mode.localID,
+					  steamID64 = this->player.steamid64, time = this->time, previous](std::string, int)
+	{
+		// The run is already on the leaderboard, take it off again since the database doesn't have it.
+		if (submitted)
+		{
+			Surf::leaderboard::Revert(courseID, modeID, steamID64, time, previous);
+		}
 		RecordAnnounce *rec = RecordAnnounce::Get(uid);
 		if (!rec)
 		{
@@ -234,54 +263,68 @@ void RecordAnnounce::SubmitLocal()
 		}
 		rec->local = false;
 	};
-	auto onSuccess = [uid = this->uid](std::vector<ISQLQuery *> queries)
+	// The announcement might already be gone if the ranks were known up front, so don't rely on it for the cache updates.
+	auto onSuccess = [uid = this->uid, userID = this->userID, ranked, queryRanks, courseID = this->course.localID, modeID = this->mode.localID,
+					  steamID64 = this->player.steamid64, name = this->player.name, courseName = this->course.name, modeName = this->mode.name,
+					  time = this->time, splits = this->splits](std::vector<ISQLQuery *> queries)
 	{
+		// Queries are: old PB, insert, PB update, new PB, rank, number of ranked players.
+		ISQLResult *result = queries[3]->GetResultSet();
+		if (ranked && result && result->FetchRow())
+		{
+			Surf::leaderboard::UpdatePB(courseID, modeID, steamID64, name.c_str(), result->GetFloat(0), result->GetInt64(1));
+		}
+		RecordAnnounce::UpdateLocalCache(userID, courseName, modeName, time, splits);
+
 		RecordAnnounce *rec = RecordAnnounce::Get(uid);
-		if (!rec)
+		if (!rec || !queryRanks)
 		{
 			return;
 		}
 		rec->localResponse.received = true;
 
-		ISQLResult *result = queries[1]->GetResultSet();
-		rec->localResponse.overall.firstTime = result->GetRowCount() == 1;
+		result = queries[0]->GetResultSet();
+		rec->localResponse.overall.firstTime = !result->FetchRow();
 		if (!rec->localResponse.overall.firstTime)
 		{
-			result->FetchRow();
-			f32 pb = result->GetFloat(0);
-			// Close enough. New time is new PB.
-			if (fabs(pb - rec->time) < EPSILON)
-			{
-				result->FetchRow();
-				f32 oldPB = result->GetFloat(0);
-				rec->localResponse.overall.pbDiff = rec->time - oldPB;
-			}
-			else // Didn't beat PB
-			{
-				rec->localResponse.overall.pbDiff = rec->time - pb;
-			}
+			f32 oldPB = result->GetFloat(0);
+			rec->localResponse.overall.pbDiff = rec->time - oldPB;
 		}
-		result = queries[2]->GetResultSet();
+		result = queries[4]->GetResultSet();
 		result->FetchRow();
 		rec->localResponse.overall.rank = result->GetInt(0);
-		result = queries[3]->GetResultSet();
+		result = queries[5]->GetResultSet();
 		result->FetchRow();
 		rec->localResponse.overall.maxRank = result->GetInt(0);
-
-		rec->UpdateLocalCache();
 	};
-	SurfDatabaseService::SaveTime(this->player.steamid64, this->course.localID, this->mode.localID, this->time, this->styleIDs, this->metadata,
-								  onSuccess, onFailure);
+	SurfDatabaseService::SaveTime(this->player.steamid64, this->course.localID, this->mode.localID, this->time, this->styleIDs, this->splits,
+								  queryRanks, onSuccess, onFailure);
 }
 
-void RecordAnnounce::UpdateLocalCache()
+void RecordAnnounce::UpdateLocalCache(CPlayerUserId userID, const std::string &courseName, const std::string &modeName, f64 time,
+									  const std::string &splits)
 {
-	SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(this->userID);
+	// Nothing but this run changed, so update the caches with it instead of loading them again.
+	const SurfCourseDescriptor *course = Surf::course::GetCourse(courseName.c_str());
+	auto mode = Surf::mode::GetModeInfo(modeName.c_str());
+	if (!course || mode.id <= -2)
+	{
+		return;
+	}
+	SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(userID);
 	if (player)
 	{
-		player->timerService->UpdateLocalPBCache();
+		const PBData *pb = player->timerService->GetLocalCachedPB(course, mode.id);
+		if (!pb || time < pb->overall.pbTime)
+		{
+			player->timerService->InsertPBToCache(time, course, mode.id, false, splits.c_str());
+		}
+	}
+	const PBData *sr = SurfTimerService::GetCachedRecord(course, mode.id, false);
+	if (!sr || time < sr->overall.pbTime)
+	{
+		SurfTimerService::InsertRecordToCache(time, course, mode.id, false, splits.c_str());
 	}
-	SurfTimerService::UpdateLocalRecordCache();
 }
 
 void RecordAnnounce::AnnounceRun()
@@ -307,7 +350,7 @@ void RecordAnnounce::AnnounceRun()
 		{
 			continue;
 		}
-		player->languageService->PrintChat(true, false, "Beat Course Info - Basic", this->player.name.c_str(), this->course.name.c_str(),
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Beat Course Info - Basic"), this->player.name.c_str(), this->course.name.c_str(),
 										   formattedTime, combinedModeStyleText.Get());
 	}
 }
@@ -333,7 +376,7 @@ void RecordAnnounce::AnnounceLocal()
 
 		// clang-format on
 
-		player->languageService->PrintChat(true, false, "Beat Course Info - Local", this->localResponse.overall.rank,
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Beat Course Info - Local"), this->localResponse.overall.rank,
 										   this->localResponse.overall.maxRank, diffText.c_str());
 	}
 }
@@ -363,10 +406,10 @@ void RecordAnnounce::AnnounceGlobal()
             : "";
 		// clang-format on
 
-		player->languageService->PrintChat(true, false, "Beat Course Info - Global", this->globalResponse.overall.rank,
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Beat Course Info - Global"), this->globalResponse.overall.rank,
 										   this->globalResponse.overall.maxRank, diffText.c_str());
 
-		player->languageService->PrintChat(true, false, "Beat Course Info - Global Points", this->globalResponse.overall.points, pointsDiff,
-										   this->globalResponse.playerRating);
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Beat Course Info - Global Points"), this->globalResponse.overall.points,
+										   pointsDiff, this->globalResponse.playerRating);
 	}
 }
@@ -64,7 +64,9 @@ struct RecordAnnounce
 	std::vector<StyleInfo> styles;
 	u64 styleIDs {};
 
+	// JSON metadata, only built for global submissions.
 	std::string metadata;
+	std::string splits;
 
 	bool global {};
 
@@ -163,7 +165,8 @@ public:
 
 	// Submit the run locally, update the cache if needed.
 	void SubmitLocal();
-	void UpdateLocalCache();
+	static void UpdateLocalCache(CPlayerUserId userID, const std::string &courseName, const std::string &modeName, f64 time,
+								 const std::string &splits);
 
 	// GameChaos finished "blocks2006" in 10:06.84 | VNL | PRO
 	// Server: #1/24 Overall (-1:00.00) | #1/10 PRO (-2:00.00)
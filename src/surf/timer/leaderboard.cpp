@@ -0,0 +1,419 @@
+#include "leaderboard.h"
+#include "cs2surf.h"
+#include "surf/surf.h"
+#include "surf/db/surf_db.h"
+
+#include <random>
+#include <unordered_map>
+
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include "tier0/memdbgon.h"
+
+// Times read back from the database went through a float, anything closer than this is the same run.
+#define LEADERBOARD_TIME_TOLERANCE 0.001
+
+/*
+	Treap ordered by (time, SteamID64). Every node knows the size of its subtree so the rank of a time and the n-th fastest
+	entry are found in O(log n). Nodes live in a vector and refer to each other by index.
+*/
+class RankTree
+{
+public:
+	void Clear()
+	{
+		this->nodes.clear();
+		this->freeNodes.clear();
+		this->root = -1;
+	}
+
+	u32 GetSize() const
+	{
+		return this->Size(this->root);
+	}
+
+	void Insert(f64 time, u64 steamID64)
+	{
+		i32 node = this->Allocate(time, steamID64);
+		i32 left, right;
+		this->Split(this->root, time, steamID64, left, right);
+		this->root = this->Merge(this->Merge(left, node), right);
+	}
+
+	void Erase(f64 time, u64 steamID64)
+	{
+		this->root = this->Erase(this->root, time, steamID64);
+	}
+
+	// Number of entries strictly faster than `time`.
+	u32 CountFaster(f64 time) const
+	{
+		u32 count = 0;
+		i32 node = this->root;
+		while (node >= 0)
+		{
+			const Node &n = this->nodes[node];
+			if (n.time < time)
+			{
+				count += this->Size(n.left) + 1;
+				node = n.right;
+			}
+			else
+			{
+				node = n.left;
+			}
+		}
+		return count;
+	}
+
+	// SteamID64 of the entry with the given 0-based rank.
+	u64 Select(u32 rank) const
+	{
+		i32 node = this->root;
+		while (node >= 0)
+		{
+			const Node &n = this->nodes[node];
+			u32 leftSize = this->Size(n.left);
+			if (rank < leftSize)
+			{
+				node = n.left;
+			}
+			else if (rank == leftSize)
+			{
+				return n.steamID64;
+			}
+			else
+			{
+				rank -= leftSize + 1;
+				node = n.right;
+			}
+		}
+		return 0;
+	}
+
+private:
+	struct Node
+	{
+		f64 time;
+		u64 steamID64;
+		u32 priority;
+		u32 size;
+		i32 left;
+		i32 right;
+	};
+
+	std::vector<Node> nodes;
+	std::vector<i32> freeNodes;
+	i32 root = -1;
+	std::minstd_rand random;
+
+	u32 Size(i32 node) const
+	{
+		return node < 0 ? 0 : this->nodes[node].size;
+	}
+
+	void Update(i32 node)
+	{
+		Node &n = this->nodes[node];
+		n.size = this->Size(n.left) + this->Size(n.right) + 1;
+	}
+
+	static bool IsBefore(const Node &n, f64 time, u64 steamID64)
+	{
+		return n.time < time || (n.time == time && n.steamID64 < steamID64);
+	}
+
+	i32 Allocate(f64 time, u64 steamID64)
+	{
+		Node node = {time, steamID64, (u32)this->random(), 1, -1, -1};
+		if (!this->freeNodes.empty())
+		{
+			i32 index = this->freeNodes.back();
+			this->freeNodes.pop_back();
+			this->nodes[index] = node;
+			return index;
+		}
+		this->nodes.push_back(node);
+		return (i32)this->nodes.size() - 1;
+	}
+
+	// Everything ordered before (time, steamID64) goes to `left`, the rest to `right`.
+	void Split(i32 node, f64 time, u64 steamID64, i32 &left, i32 &right)
+	{
+		if (node < 0)
+		{
+			left = right = -1;
+			return;
+		}
+		i32 a, b;
+		if (IsBefore(this->nodes[node], time, steamID64))
+		{
+			this->Split(this->nodes[node].right, time, steamID64, a, b);
+			this->nodes[node].right = a;
+			left = node;
+			right = b;
+		}
+		else
+		{
+			this->Split(this->nodes[node].left, time, steamID64, a, b);
+			this->nodes[node].left = b;
+			left = a;
+			right = node;
+		}
+		this->Update(node);
+	}
+
+	// Everything in `left` must be ordered before everything in `right`.
+	i32 Merge(i32 left, i32 right)
+	{
+		if (left < 0 || right < 0)
+		{
+			return left < 0 ? right : left;
+		}
+		if (this->nodes[left].priority > this->nodes[right].priority)
+		{
+			i32 merged = this->Merge(this->nodes[left].right, right);
+			this->nodes[left].right = merged;
+			this->Update(left);
+			return left;
+		}
+		i32 merged = this->Merge(left, this->nodes[right].left);
+		this->nodes[right].left = merged;
+		this->Update(right);
+		return right;
+	}
+
+	i32 Erase(i32 node, f64 time, u64 steamID64)
+	{
+		if (node < 0)
+		{
+			return node;
+		}
+		Node &n = this->nodes[node];
+		if (n.time == time && n.steamID64 == steamID64)
+		{
+			i32 merged = this->Merge(n.left, n.right);
+			this->freeNodes.push_back(node);
+			return merged;
+		}
+		if (IsBefore(n, time, steamID64))
+		{
+			i32 right = this->Erase(n.right, time, steamID64);
+			this->nodes[node].right = right;
+		}
+		else
+		{
+			i32 left = this->Erase(n.left, time, steamID64);
+			this->nodes[node].left = left;
+		}
+		this->Update(node);
+		return node;
+	}
+};
+
+struct Leaderboard
+{
+	RankTree ranks;
+	std::unordered_map<u64, LeaderboardEntry> players;
+};
+
+static_global struct
+{
+	std::unordered_map<u64, Leaderboard> boards;
+	bool loaded;
+	// Bumped whenever the leaderboards are dropped so results of an older load are ignored.
+	u32 generation;
+} g_leaderboards;
+
+static_function u64 Leaderboard_GetKey(u32 courseID, u32 modeID)
+{
+	return ((u64)courseID << 32) | modeID;
+}
+
+static_function void Leaderboard_Set(Leaderboard &board, u64 steamID64, const char *name, f64 time, u64 timeID)
+{
+	auto it = board.players.find(steamID64);
+	if (it == board.players.end())
+	{
+		board.players[steamID64] = {steamID64, time, timeID, name};
+	}
+	else
+	{
+		board.ranks.Erase(it->second.time, steamID64);
+		it->second.time = time;
+		it->second.timeID = timeID;
+		it->second.name = name;
+	}
+	board.ranks.Insert(time, steamID64);
+}
+
+static_function void Leaderboard_GetPB(const Leaderboard &board, u64 steamID64, LeaderboardPB &pb)
+{
+	pb = {};
+	pb.maxRank = board.ranks.GetSize();
+	auto it = board.players.find(steamID64);
+	if (it == board.players.end())
+	{
+		return;
+	}
+	pb.hasPB = true;
+	pb.time = it->second.time;
+	pb.timeID = it->second.timeID;
+	pb.rank = board.ranks.CountFaster(pb.time) + 1;
+}
+
+// Returns false if the request can't be answered from memory, `board` is null if nobody finished the course yet.
+static_function bool Leaderboard_Find(const char *mapName, const char *courseName, u32 modeID, const Leaderboard *&board)
+{
+	if (!g_leaderboards.loaded || !SURF_STREQ(mapName, g_pSurfUtils->GetCurrentMapName().Get()))
+	{
+		return false;
+	}
+	const SurfCourseDescriptor *course = Surf::course::GetCourse(courseName);
+	if (!course || !course->localDatabaseID)
+	{
+		return false;
+	}
+	auto it = g_leaderboards.boards.find(Leaderboard_GetKey(course->localDatabaseID, modeID));
+	board = it == g_leaderboards.boards.end() ? nullptr : &it->second;
+	return true;
+}
+
+void Surf::leaderboard::Load()
+{
+	Surf::leaderboard::Clear();
+	if (!SurfDatabaseService::IsReady() || !SurfDatabaseService::IsMapSetUp())
+	{
+		return;
+	}
+
+	u32 generation = g_leaderboards.generation;
+	auto onSuccess = [generation](std::vector<ISQLQuery *> queries)
+	{
+		if (generation != g_leaderboards.generation)
+		{
+			return;
+		}
+		u32 count = 0;
+		ISQLResult *result = queries[0]->GetResultSet();
+		while (result && result->FetchRow())
+		{
+			Leaderboard &board = g_leaderboards.boards[Leaderboard_GetKey(result->GetInt(0), result->GetInt(1))];
+			Leaderboard_Set(board, result->GetInt64(2), result->GetString(5), result->GetFloat(3), result->GetInt64(4));
+			count++;
+		}
+		g_leaderboards.loaded = true;
+		META_CONPRINTF("[Surf::Timer] Loaded %u personal bests into %u server leaderboards.\n", count, (u32)g_leaderboards.boards.size());
+	};
+	SurfDatabaseService::QueryMapLeaderboards(SurfDatabaseService::GetMapID(), onSuccess, SurfDatabaseService::OnGenericTxnFailure);
+}
+
+void Surf::leaderboard::Clear()
+{
+	g_leaderboards.boards.clear();
+	g_leaderboards.loaded = false;
+	g_leaderboards.generation++;
+}
+
+bool Surf::leaderboard::IsLoaded()
+{
+	return g_leaderboards.loaded;
+}
+
+bool Surf::leaderboard::Submit(u32 courseID, u32 modeID, u64 steamID64, const char *name, f64 time, LeaderboardPB &previous,
+							   LeaderboardPB &current)
+{
+	if (!g_leaderboards.loaded)
+	{
+		return false;
+	}
+	Leaderboard &board = g_leaderboards.boards[Leaderboard_GetKey(courseID, modeID)];
+	Leaderboard_GetPB(board, steamID64, previous);
+	if (!previous.hasPB || time < previous.time)
+	{
+		// The run gets its ID once the database saved it.
+		Leaderboard_Set(board, steamID64, name, time, 0);
+	}
+	Leaderboard_GetPB(board, steamID64, current);
+	return true;
+}
+
+void Surf::leaderboard::Revert(u32 courseID, u32 modeID, u64 steamID64, f64 time, const LeaderboardPB &previous)
+{
+	if (!g_leaderboards.loaded)
+	{
+		return;
+	}
+	auto boardIt = g_leaderboards.boards.find(Leaderboard_GetKey(courseID, modeID));
+	if (boardIt == g_leaderboards.boards.end())
+	{
+		return;
+	}
+	Leaderboard &board = boardIt->second;
+	auto it = board.players.find(steamID64);
+	// Leave it alone if the entry isn't this unsaved run anymore, e.g. a faster run was submitted since.
+	if (it == board.players.end() || it->second.time != time || it->second.timeID != 0)
+	{
+		return;
+	}
+	if (previous.hasPB)
+	{
+		std::string name = it->second.name;
+		Leaderboard_Set(board, steamID64, name.c_str(), previous.time, previous.timeID);
+		return;
+	}
+	board.ranks.Erase(time, steamID64);
+	board.players.erase(it);
+}
+
+void Surf::leaderboard::UpdatePB(u32 courseID, u32 modeID, u64 steamID64, const char *name, f64 time, u64 timeID)
+{
+	if (!g_leaderboards.loaded)
+	{
+		return;
+	}
+	Leaderboard &board = g_leaderboards.boards[Leaderboard_GetKey(courseID, modeID)];
+	auto it = board.players.find(steamID64);
+	if (it != board.players.end() && fabs(it->second.time - time) < LEADERBOARD_TIME_TOLERANCE)
+	{
+		// Keep the more precise time we already have.
+		it->second.timeID = timeID;
+		return;
+	}
+	Leaderboard_Set(board, steamID64, name, time, timeID);
+}
+
+bool Surf::leaderboard::GetPB(const char *mapName, const char *courseName, u32 modeID, u64 steamID64, LeaderboardPB &pb)
+{
+	const Leaderboard *board;
+	if (!Leaderboard_Find(mapName, courseName, modeID, board))
+	{
+		return false;
+	}
+	pb = {};
+	if (board)
+	{
+		Leaderboard_GetPB(*board, steamID64, pb);
+	}
+	return true;
+}
+
+bool Surf::leaderboard::GetTop(const char *mapName, const char *courseName, u32 modeID, u32 offset, u32 count,
+							   std::vector<LeaderboardEntry> &entries)
+{
+	const Leaderboard *board;
+	if (!Leaderboard_Find(mapName, courseName, modeID, board))
+	{
+		return false;
+	}
+	if (!board)
+	{
+		return true;
+	}
+	u32 end = MIN(offset + count, board->ranks.GetSize());
+	for (u32 rank = offset; rank < end; rank++)
+	{
+		entries.push_back(board->players.at(board->ranks.Select(rank)));
+	}
+	return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common.h"
+
+#include <string>
+#include <vector>
+
+/*
+	In-memory copy of the server leaderboards of the current map.
+
+	Loaded from PersonalBests once the map is set up in the local database, then kept up to date as runs are saved, so ranks
+	and course tops can be answered without a database round trip. Like the rank queries, only runs without styles from players
+	that aren't flagged as cheaters are kept. Everything here is main thread only.
+*/
+
+struct LeaderboardEntry
+{
+	u64 steamID64;
+	f64 time;
+	u64 timeID;
+	std::string name;
+};
+
+struct LeaderboardPB
+{
+	bool hasPB;
+	f64 time;
+	u64 timeID;
+	// 1-based.
+	u32 rank;
+	u32 maxRank;
+};
+
+namespace Surf::leaderboard
+{
+	// Drop everything and load the leaderboards of the current map from the local database.
+	void Load();
+	void Clear();
+
+	// Whether the leaderboards finished loading and can be used instead of the database.
+	bool IsLoaded();
+
+	// Add a finished run. `previous` receives the player's PB from before the run, the rank is the one after the run.
+	// Returns false if the leaderboards aren't loaded.
+	bool Submit(u32 courseID, u32 modeID, u64 steamID64, const char *name, f64 time, LeaderboardPB &previous, LeaderboardPB &current);
+
+	// Undo a run added by Submit that the database failed to save, putting `previous` back.
+	void Revert(u32 courseID, u32 modeID, u64 steamID64, f64 time, const LeaderboardPB &previous);
+
+	// Sync a player's PB with what the database stored, this is where new runs get their ID.
+	void UpdatePB(u32 courseID, u32 modeID, u64 steamID64, const char *name, f64 time, u64 timeID);
+
+	// Returns false if the course isn't on the current map or the leaderboards aren't loaded.
+	bool GetPB(const char *mapName, const char *courseName, u32 modeID, u64 steamID64, LeaderboardPB &pb);
+	bool GetTop(const char *mapName, const char *courseName, u32 modeID, u32 offset, u32 count, std::vector<LeaderboardEntry> &entries);
+} // namespace Surf::leaderboard
@@ -0,0 +1,120 @@
+#include "pb_cache.h"
+
+#include "tier0/memdbgon.h"
+
+// Enough for a few dozen players on a map with a handful of courses and splits.
+#define SPLIT_ARENA_BLOCK_SIZE 4096
+
+#define PB_CACHE_MIN_SLOTS 16
+// Only one key can never be used: mode and course are both u32 max.
+#define PB_CACHE_EMPTY_KEY (~0ull)
+
+f64 *SplitArena::Allocate(u32 count)
+{
+	if (count == 0)
+	{
+		return nullptr;
+	}
+	if (this->blocks.empty() || this->used + count > this->blockSize)
+	{
+		this->blockSize = MAX(count, SPLIT_ARENA_BLOCK_SIZE);
+		this->blocks.emplace_back(new f64[this->blockSize]);
+		this->used = 0;
+	}
+	f64 *result = this->blocks.back().get() + this->used;
+	this->used += count;
+	return result;
+}
+
+void SplitArena::Reset()
+{
+	this->blocks.clear();
+	this->blockSize = 0;
+	this->used = 0;
+}
+
+static_function u32 PBCache_Hash(PBDataKey key, size_t slotCount)
+{
+	// Fibonacci hashing, the mode and course IDs are small and sequential.
+	return (u32)((key * 0x9E3779B97F4A7C15ull) >> 32) & (slotCount - 1);
+}
+
+i32 PBCache::FindSlot(PBDataKey key) const
+{
+	if (this->slots.empty())
+	{
+		return -1;
+	}
+	for (u32 i = PBCache_Hash(key, this->slots.size());; i = (i + 1) & (this->slots.size() - 1))
+	{
+		if (this->slots[i].key == key)
+		{
+			return i;
+		}
+		if (this->slots[i].key == PB_CACHE_EMPTY_KEY)
+		{
+			return -1;
+		}
+	}
+}
+
+PBData *PBCache::Find(PBDataKey key)
+{
+	i32 slot = this->FindSlot(key);
+	return slot < 0 ? nullptr : &this->slots[slot].data;
+}
+
+const PBData *PBCache::Find(PBDataKey key) const
+{
+	i32 slot = this->FindSlot(key);
+	return slot < 0 ? nullptr : &this->slots[slot].data;
+}
+
+PBData &PBCache::FindOrInsert(PBDataKey key)
+{
+	PBData *existing = this->Find(key);
+	if (existing)
+	{
+		return *existing;
+	}
+	// Stay at most half full so probes stay short.
+	if ((this->count + 1) * 2 > this->slots.size())
+	{
+		this->Grow();
+	}
+	u32 i = PBCache_Hash(key, this->slots.size());
+	while (this->slots[i].key != PB_CACHE_EMPTY_KEY)
+	{
+		i = (i + 1) & (this->slots.size() - 1);
+	}
+	this->slots[i].key = key;
+	this->slots[i].data = {};
+	this->count++;
+	return this->slots[i].data;
+}
+
+void PBCache::Clear()
+{
+	this->slots.clear();
+	this->count = 0;
+}
+
+void PBCache::Grow()
+{
+	std::vector<Slot> old = std::move(this->slots);
+	this->slots.clear();
+	this->slots.resize(MAX(old.size() * 2, (size_t)PB_CACHE_MIN_SLOTS), {PB_CACHE_EMPTY_KEY, {}});
+	for (Slot &slot : old)
+	{
+		if (slot.key == PB_CACHE_EMPTY_KEY)
+		{
+			continue;
+		}
+		u32 i = PBCache_Hash(slot.key, this->slots.size());
+		while (this->slots[i].key != PB_CACHE_EMPTY_KEY)
+		{
+			i = (i + 1) & (this->slots.size() - 1);
+		}
+		this->slots[i] = std::move(slot);
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "common.h"
+#include "utlstring.h"
+
+#include <memory>
+#include <vector>
+
+/*
+	Caches of PBs and records for the current map.
+
+	Entries only hold the times, split times live in a per-map arena and are sized to the course they belong to, so a course
+	without checkpoints or stages costs nothing and nothing is reserved for the SURF_MAX_*_ZONES worst case. Everything in the
+	arena is dropped at once when the courses of the map are cleared, caches must be cleared at the same time.
+*/
+
+struct PBData
+{
+	struct
+	{
+		f64 pbTime {};
+		f64 points {};
+		// Null until the splits are decoded, then sized to the course.
+		f64 *pbCpZoneTimes {};
+		f64 *pbStageZoneTimes {};
+		u16 cpCount {};
+		u16 stageCount {};
+
+		// -1 if the split isn't known.
+		f64 GetCpZoneTime(u32 index) const
+		{
+			return pbCpZoneTimes && index < cpCount ? pbCpZoneTimes[index] : -1.0;
+		}
+
+		f64 GetStageZoneTime(u32 index) const
+		{
+			return pbStageZoneTimes && index < stageCount ? pbStageZoneTimes[index] : -1.0;
+		}
+	} overall;
+
+	// Split times of the run that aren't decoded yet, this only happens once the splits are compared against.
+	CUtlString pendingSplits;
+};
+
+// Convert mode and course ID to one single value.
+typedef u64 PBDataKey;
+
+inline PBDataKey ToPBDataKey(u32 modeID, u32 courseID)
+{
+	return modeID | ((u64)courseID << 32);
+}
+
+inline void ConvertFromPBDataKey(PBDataKey key, uint32_t *modeID, uint32_t *courseID)
+{
+	if (modeID)
+	{
+		*modeID = (uint32_t)key;
+	}
+	if (courseID)
+	{
+		*courseID = (uint32_t)(key >> 32);
+	}
+}
+
+// Bump allocator for split times, freed all at once.
+class SplitArena
+{
+public:
+	f64 *Allocate(u32 count);
+	void Reset();
+
+private:
+	std::vector<std::unique_ptr<f64[]>> blocks;
+	// Size of the last block and how much of it is taken.
+	u32 blockSize {};
+	u32 used {};
+};
+
+// Open addressing hash map with linear probing. Pointers to entries are only valid until the next insertion.
+class PBCache
+{
+public:
+	PBData *Find(PBDataKey key);
+	const PBData *Find(PBDataKey key) const;
+	// Returns the existing entry or a new empty one.
+	PBData &FindOrInsert(PBDataKey key);
+	void Clear();
+
+	u32 Count() const
+	{
+		return this->count;
+	}
+
+private:
+	struct Slot
+	{
+		PBDataKey key;
+		PBData data;
+	};
+
+	std::vector<Slot> slots;
+	u32 count {};
+
+	i32 FindSlot(PBDataKey key) const;
+	void Grow();
+};
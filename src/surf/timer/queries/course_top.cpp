@@ -1,5 +1,6 @@
 #include "base_request.h"
 #include "surf/timer/surf_timer.h"
+#include "surf/timer/leaderboard.h"
 #include "surf/db/surf_db.h"
 #include "surf/global/surf_global.h"
 
@@ -87,8 +88,8 @@ struct CourseTopRequest : public BaseRequest
 		{
 			return;
 		}
-		player->languageService->PrintChat(true, false, "Course Top Command Usage");
-		player->languageService->PrintConsole(false, false, "Course Top Command Usage - Console");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Course Top Command Usage"));
+		player->languageService->PrintConsole(false, false, SURF_PHRASE("Course Top Command Usage - Console"));
 	}
 
 	virtual void QueryLocal()
@@ -110,6 +111,17 @@ struct CourseTopRequest : public BaseRequest
 
 			this->localStatus = ResponseStatus::PENDING;
 
+			std::vector<LeaderboardEntry> entries;
+			if (Surf::leaderboard::GetTop(this->mapName, this->courseName, this->localModeID, this->offset, this->limit, entries))
+			{
+				for (const LeaderboardEntry &entry : entries)
+				{
+					this->srData.overallData.AddToTail({entry.timeID, entry.name.c_str(), entry.time, entry.steamID64});
+				}
+				this->localStatus = ResponseStatus::RECEIVED;
+				return;
+			}
+
 			u64 uid = this->uid;
 
 			auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
@@ -198,11 +210,11 @@ struct CourseTopRequest : public BaseRequest
 
 		if (localStatus != ResponseStatus::RECEIVED && globalStatus != ResponseStatus::RECEIVED)
 		{
-			player->languageService->PrintChat(true, false, "Course Top Request - Failed (Generic)");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Course Top Request - Failed (Generic)"));
 			return;
 		}
 
-		player->languageService->PrintChat(true, false, "Course Top - Check Console");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("Course Top - Check Console"));
 		if (this->localStatus == ResponseStatus::RECEIVED)
 		{
 			this->ReplyLocal();
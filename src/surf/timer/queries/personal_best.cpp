@@ -1,5 +1,6 @@
 #include "base_request.h"
 #include "surf/db/surf_db.h"
+#include "surf/timer/leaderboard.h"
 #include "surf/global/surf_global.h"
 #include "surf/global/events.h"
 
@@ -58,8 +59,8 @@ struct PBRequest : public BaseRequest
 		{
 			return;
 		}
-		player->languageService->PrintChat(true, false, "PB Command Usage");
-		player->languageService->PrintConsole(false, false, "PB Command Usage - Console");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("PB Command Usage"));
+		player->languageService->PrintConsole(false, false, SURF_PHRASE("PB Command Usage - Console"));
 	}
 
 	virtual void QueryLocal()
@@ -149,7 +150,7 @@ struct PBRequest : public BaseRequest
 		}
 		if (localStatus != ResponseStatus::RECEIVED && globalStatus != ResponseStatus::RECEIVED)
 		{
-			player->languageService->PrintChat(true, false, "PB Request - Failed (Generic)");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("PB Request - Failed (Generic)"));
 			return;
 		}
 
@@ -163,12 +164,12 @@ struct PBRequest : public BaseRequest
 		}
 
 		// Player on surf_map (Main) [VNL]
-		player->languageService->PrintChat(true, false, "PB Header", targetPlayerName.Get(), mapName.Get(), courseName.Get(),
+		player->languageService->PrintChat(true, false, SURF_PHRASE("PB Header"), targetPlayerName.Get(), mapName.Get(), courseName.Get(),
 										   combinedModeStyleText.Get());
 
 		if (!this->pbData.hasPB && !this->gpbData.hasPB)
 		{
-			player->languageService->PrintChat(true, false, "PB Time - No Times");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("PB Time - No Times"));
 		}
 		else
 		{
@@ -195,8 +196,8 @@ struct PBRequest : public BaseRequest
 			if (this->gpbData.hasPB)
 			{
 				// Surf | Global: 12.34 [Overall / 10000 pts]
-				player->languageService->PrintChat(true, false, "PB Time - Overall (Global)", overallTime, this->gpbData.rank, this->gpbData.maxRank,
-												   this->gpbData.points);
+				player->languageService->PrintChat(true, false, SURF_PHRASE("PB Time - Overall (Global)"), overallTime, this->gpbData.rank,
+												   this->gpbData.maxRank, this->gpbData.points);
 			}
 		}
 		else
@@ -204,7 +205,7 @@ struct PBRequest : public BaseRequest
 			if (this->gpbData.hasPB)
 			{
 				// Surf | Global: 12.34 [Overall]
-				player->languageService->PrintChat(true, false, "PB Time - Overall Rankless (Global)", overallTime);
+				player->languageService->PrintChat(true, false, SURF_PHRASE("PB Time - Overall Rankless (Global)"), overallTime);
 			}
 		}
 	}
@@ -220,30 +221,43 @@ struct PBRequest : public BaseRequest
 		{
 			if (!this->pbData.hasPB)
 			{
-				player->languageService->PrintChat(true, false, "PB Time - No Times");
+				player->languageService->PrintChat(true, false, SURF_PHRASE("PB Time - No Times"));
 			}
 			else
 			{
 				// Surf | Server: 12.34 [Overall]
-				player->languageService->PrintChat(true, false, "PB Time - Overall (Server)", overallTime, this->pbData.rank, this->pbData.maxRank);
+				player->languageService->PrintChat(true, false, SURF_PHRASE("PB Time - Overall (Server)"), overallTime, this->pbData.rank,
+												   this->pbData.maxRank);
 			}
 		}
 		else
 		{
 			if (!this->pbData.hasPB)
 			{
-				player->languageService->PrintChat(true, false, "PB Time - No Times");
+				player->languageService->PrintChat(true, false, SURF_PHRASE("PB Time - No Times"));
 			}
 			else
 			{
 				// Surf | Server: 12.34 [Overall]
-				player->languageService->PrintChat(true, false, "PB Time - Overall Rankless (Server)", overallTime);
+				player->languageService->PrintChat(true, false, SURF_PHRASE("PB Time - Overall Rankless (Server)"), overallTime);
 			}
 		}
 	}
 
 	void ExecuteStandardLocalQuery()
 	{
+		LeaderboardPB pb;
+		// The leaderboards leave out cheaters, anyone without a time there still gets whatever the database has for them.
+		if (Surf::leaderboard::GetPB(this->mapName, this->courseName, this->localModeID, targetSteamID64, pb) && pb.hasPB)
+		{
+			this->pbData.hasPB = true;
+			this->pbData.runTime = pb.time;
+			this->pbData.rank = pb.rank;
+			this->pbData.maxRank = pb.maxRank;
+			this->localStatus = ResponseStatus::RECEIVED;
+			return;
+		}
+
 		u64 uid = this->uid;
 
 		auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
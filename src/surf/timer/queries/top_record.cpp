@@ -1,5 +1,6 @@
 #include "base_request.h"
 #include "surf/timer/surf_timer.h"
+#include "surf/timer/leaderboard.h"
 #include "surf/db/surf_db.h"
 #include "surf/global/surf_global.h"
 #include "surf/global/events.h"
@@ -28,8 +29,8 @@ struct TopRecordRequest : public BaseRequest
 		{
 			return;
 		}
-		player->languageService->PrintChat(true, false, "WR/SR Command Usage");
-		player->languageService->PrintConsole(false, false, "WR/SR Command Usage - Console");
+		player->languageService->PrintChat(true, false, SURF_PHRASE("WR/SR Command Usage"));
+		player->languageService->PrintConsole(false, false, SURF_PHRASE("WR/SR Command Usage - Console"));
 	}
 
 	virtual void QueryGlobal()
@@ -90,6 +91,19 @@ struct TopRecordRequest : public BaseRequest
 				return;
 			}
 
+			std::vector<LeaderboardEntry> entries;
+			if (Surf::leaderboard::GetTop(this->mapName, this->courseName, this->localModeID, 0, 1, entries))
+			{
+				this->srData.hasRecord = !entries.empty();
+				if (this->srData.hasRecord)
+				{
+					this->srData.holder = entries[0].name.c_str();
+					this->srData.runTime = entries[0].time;
+				}
+				this->localStatus = ResponseStatus::RECEIVED;
+				return;
+			}
+
 			u64 uid = this->uid;
 
 			auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
@@ -134,7 +148,7 @@ struct TopRecordRequest : public BaseRequest
 		}
 		if (localStatus != ResponseStatus::RECEIVED && globalStatus != ResponseStatus::RECEIVED)
 		{
-			player->languageService->PrintChat(true, false, "Top Record Request - Failed (Generic)");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Top Record Request - Failed (Generic)"));
 			return;
 		}
 		if (this->localStatus == ResponseStatus::RECEIVED)
@@ -156,15 +170,15 @@ struct TopRecordRequest : public BaseRequest
 		SurfTimerService::FormatTime(wrData.runTime, standardTime, sizeof(standardTime));
 
 		// Global Records on surf_map (Main) [VNL]
-		player->languageService->PrintChat(true, false, "WR Header", mapName.Get(), courseName.Get(), modeName.Get());
+		player->languageService->PrintChat(true, false, SURF_PHRASE("WR Header"), mapName.Get(), courseName.Get(), modeName.Get());
 		if (!wrData.hasRecord)
 		{
-			player->languageService->PrintChat(true, false, "No Times");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("No Times"));
 		}
 		else
 		{
 			// Surf | Overall Record: 01:23.45 by Bill
-			player->languageService->PrintChat(true, false, "Top Record - Overall", standardTime, wrData.holder.Get());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Top Record - Overall"), standardTime, wrData.holder.Get());
 		}
 	}
 
@@ -177,15 +191,15 @@ struct TopRecordRequest : public BaseRequest
 		SurfTimerService::FormatTime(srData.runTime, standardTime, sizeof(standardTime));
 
 		// Server Records on surf_map (Main) [VNL]
-		player->languageService->PrintChat(true, false, "SR Header", mapName.Get(), courseName.Get(), modeName.Get());
+		player->languageService->PrintChat(true, false, SURF_PHRASE("SR Header"), mapName.Get(), courseName.Get(), modeName.Get());
 		if (!srData.hasRecord)
 		{
-			player->languageService->PrintChat(true, false, "No Times");
+			player->languageService->PrintChat(true, false, SURF_PHRASE("No Times"));
 		}
 		else
 		{
 			// Surf | Overall Record: 01:23.45 by Bill
-			player->languageService->PrintChat(true, false, "Top Record - Overall", standardTime, srData.holder.Get());
+			player->languageService->PrintChat(true, false, SURF_PHRASE("Top Record - Overall"), standardTime, srData.holder.Get());
 		}
 	}
 };
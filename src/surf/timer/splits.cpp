@@ -0,0 +1,234 @@
+#include "splits.h"
+#include "cs2surf.h"
+#include "utlstring.h"
+#include "keyvalues3.h"
+
+#include <cmath>
+#include <vector>
+
+#include "tier0/memdbgon.h"
+
+#define SPLITS_VERSION 1
+
+static_global const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static_function i32 Splits_FromBase64(char c)
+{
+	if (c >= 'A' && c <= 'Z')
+	{
+		return c - 'A';
+	}
+	if (c >= 'a' && c <= 'z')
+	{
+		return c - 'a' + 26;
+	}
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0' + 52;
+	}
+	if (c == '-')
+	{
+		return 62;
+	}
+	if (c == '_')
+	{
+		return 63;
+	}
+	return -1;
+}
+
+static_function void Splits_WriteVarint(std::vector<u8> &bytes, u64 value)
+{
+	while (value >= 0x80)
+	{
+		bytes.push_back((u8)(value | 0x80));
+		value >>= 7;
+	}
+	bytes.push_back((u8)value);
+}
+
+static_function bool Splits_ReadVarint(const std::vector<u8> &bytes, size_t &offset, u64 &value)
+{
+	value = 0;
+	for (u32 shift = 0; shift < 64; shift += 7)
+	{
+		if (offset >= bytes.size())
+		{
+			return false;
+		}
+		u8 byte = bytes[offset++];
+		value |= (u64)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Missed splits become 0, everything else is shifted by one microsecond.
+static_function u64 Splits_ToMicroseconds(f64 time)
+{
+	return time < 0.0 ? 0 : (u64)llround(time * 1000000.0) + 1;
+}
+
+static_function f64 Splits_FromMicroseconds(u64 microseconds)
+{
+	return microseconds == 0 ? -1.0 : (microseconds - 1) / 1000000.0;
+}
+
+static_function void Splits_WriteTimes(std::vector<u8> &bytes, const f64 *times, u32 count, u64 &previous)
+{
+	for (u32 i = 0; i < count; i++)
+	{
+		u64 current = Splits_ToMicroseconds(times[i]);
+		i64 delta = (i64)(current - previous);
+		Splits_WriteVarint(bytes, ((u64)delta << 1) ^ (u64)(delta >> 63));
+		previous = current;
+	}
+}
+
+static_function bool Splits_ReadTimes(const std::vector<u8> &bytes, size_t &offset, f64 *times, u32 count, u32 maxCount, u64 &previous)
+{
+	for (u32 i = 0; i < count; i++)
+	{
+		u64 zigzag;
+		if (!Splits_ReadVarint(bytes, offset, zigzag))
+		{
+			return false;
+		}
+		previous += (u64)((i64)(zigzag >> 1) ^ -(i64)(zigzag & 1));
+		if (i < maxCount)
+		{
+			times[i] = Splits_FromMicroseconds(previous);
+		}
+	}
+	return true;
+}
+
+static_function void Splits_ReadJSONTimes(KeyValues3 *data, f64 *times, u32 maxCount)
+{
+	if (!data || data->GetType() != KV3_TYPE_ARRAY)
+	{
+		return;
+	}
+	for (u32 i = 0; i < maxCount; i++)
+	{
+		KeyValues3 *element = data->GetArrayElement(i);
+		if (element)
+		{
+			times[i] = element->GetDouble(-1.0);
+		}
+	}
+}
+
+static_function bool Splits_DecodeJSON(std::string_view data, f64 *cpZoneTimes, u32 maxCpCount, f64 *stageZoneTimes, u32 maxStageCount)
+{
+	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
+	CUtlString error = "";
+	std::string json(data);
+	LoadKV3FromJSON(&kv, &error, json.c_str(), "");
+	if (!error.IsEmpty())
+	{
+		META_CONPRINTF("[Surf::Timer] Failed to read split times due to metadata error: %s\n", error.Get());
+		return false;
+	}
+	Splits_ReadJSONTimes(kv.FindMember("cpZoneTimes"), cpZoneTimes, maxCpCount);
+	Splits_ReadJSONTimes(kv.FindMember("stageZoneTimes"), stageZoneTimes, maxStageCount);
+	return true;
+}
+
+std::string Surf::splits::Encode(const f64 *cpZoneTimes, u32 cpCount, const f64 *stageZoneTimes, u32 stageCount)
+{
+	std::vector<u8> bytes;
+	bytes.reserve(8 + (cpCount + stageCount) * 4);
+	bytes.push_back(SPLITS_VERSION);
+	Splits_WriteVarint(bytes, cpCount);
+	Splits_WriteVarint(bytes, stageCount);
+	u64 previous = 0;
+	Splits_WriteTimes(bytes, cpZoneTimes, cpCount, previous);
+	Splits_WriteTimes(bytes, stageZoneTimes, stageCount, previous);
+
+	std::string result;
+	result.reserve((bytes.size() * 4 + 2) / 3);
+	for (size_t i = 0; i < bytes.size(); i += 3)
+	{
+		u32 chunk = bytes[i] << 16;
+		size_t left = bytes.size() - i;
+		if (left > 1)
+		{
+			chunk |= bytes[i + 1] << 8;
+		}
+		if (left > 2)
+		{
+			chunk |= bytes[i + 2];
+		}
+		result += base64Alphabet[(chunk >> 18) & 63];
+		result += base64Alphabet[(chunk >> 12) & 63];
+		if (left > 1)
+		{
+			result += base64Alphabet[(chunk >> 6) & 63];
+		}
+		if (left > 2)
+		{
+			result += base64Alphabet[chunk & 63];
+		}
+	}
+	return result;
+}
+
+bool Surf::splits::Decode(std::string_view data, f64 *cpZoneTimes, u32 maxCpCount, f64 *stageZoneTimes, u32 maxStageCount)
+{
+	for (u32 i = 0; i < maxCpCount; i++)
+	{
+		cpZoneTimes[i] = -1.0;
+	}
+	for (u32 i = 0; i < maxStageCount; i++)
+	{
+		stageZoneTimes[i] = -1.0;
+	}
+	if (data.empty())
+	{
+		return true;
+	}
+	if (data[0] == '{')
+	{
+		return Splits_DecodeJSON(data, cpZoneTimes, maxCpCount, stageZoneTimes, maxStageCount);
+	}
+
+	std::vector<u8> bytes;
+	bytes.reserve(data.size() * 3 / 4);
+	u32 chunk = 0;
+	u32 bits = 0;
+	for (char c : data)
+	{
+		i32 value = Splits_FromBase64(c);
+		if (value < 0)
+		{
+			return false;
+		}
+		chunk = (chunk << 6) | value;
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			bytes.push_back((u8)(chunk >> bits));
+		}
+	}
+
+	size_t offset = 0;
+	u64 cpCount, stageCount;
+	if (bytes.empty() || bytes[offset++] != SPLITS_VERSION || !Splits_ReadVarint(bytes, offset, cpCount)
+		|| !Splits_ReadVarint(bytes, offset, stageCount))
+	{
+		return false;
+	}
+	// Every split takes at least a byte.
+	if (cpCount > bytes.size() || stageCount > bytes.size())
+	{
+		return false;
+	}
+	u64 previous = 0;
+	return Splits_ReadTimes(bytes, offset, cpZoneTimes, (u32)cpCount, maxCpCount, previous)
+		   && Splits_ReadTimes(bytes, offset, stageZoneTimes, (u32)stageCount, maxStageCount, previous);
+}
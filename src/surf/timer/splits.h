@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common.h"
+
+#include <string>
+#include <string_view>
+
+/*
+	Compact encoding of the checkpoint and stage split times of a run, stored in the Splits column of Times.
+
+	Version byte, number of checkpoint and stage splits, then every split in microseconds as a zigzag varint of the difference
+	to the previous one (missed splits are -1), all of it base64url encoded so it can go through the drivers as text. A typical
+	run takes a few bytes per split instead of the ~20 characters per split of the JSON run metadata, which is only built for
+	global submissions now.
+*/
+
+namespace Surf::splits
+{
+	std::string Encode(const f64 *cpZoneTimes, u32 cpCount, const f64 *stageZoneTimes, u32 stageCount);
+
+	// Fills both arrays entirely, splits that aren't in the data are -1. Also reads the JSON run metadata of runs saved
+	// before splits were encoded. Returns false if the data can't be read.
+	bool Decode(std::string_view data, f64 *cpZoneTimes, u32 maxCpCount, f64 *stageZoneTimes, u32 maxStageCount);
+} // namespace Surf::splits
@@ -10,6 +10,8 @@
 #include "surf/trigger/surf_trigger.h"
 #include "surf/spec/surf_spec.h"
 #include "announce.h"
+#include "leaderboard.h"
+#include "splits.h"
 
 #include "utils/utils.h"
 #include "utils/simplecmds.h"
@@ -34,6 +36,115 @@ constexpr const char *missedTimeKeys[SurfTimerService::CompareType::COMPARETYPE_
 
 // clang-format on
 
+// Seconds a player waits for others to join before their PBs are loaded, so a full server reconnecting after a map change
+// is loaded with one query.
+#define SURF_PB_CACHE_BATCH_DELAY 0.5
+
+// Players waiting to have their PBs loaded. Main thread only.
+static_global struct
+{
+	std::vector<CPlayerUserId> players;
+	// Zero while nobody is waiting.
+	f64 flushTime;
+} g_pbCacheQueue;
+
+// Split times of every cached run of the map. Main thread only.
+static_global SplitArena g_splitArena;
+
+// Decode the split times stored with a cached run.
+static_function void Timer_DecodePendingSplits(PBData &pb)
+{
+	if (pb.pendingSplits.IsEmpty())
+	{
+		return;
+	}
+	// Only try once, broken data stays broken.
+	CUtlString splits = pb.pendingSplits;
+	pb.pendingSplits = "";
+	// A new run of the same course fits in the arrays of the old one.
+	if (!pb.overall.pbCpZoneTimes)
+	{
+		pb.overall.pbCpZoneTimes = g_splitArena.Allocate(pb.overall.cpCount);
+	}
+	if (!pb.overall.pbStageZoneTimes)
+	{
+		pb.overall.pbStageZoneTimes = g_splitArena.Allocate(pb.overall.stageCount);
+	}
+	if (!Surf::splits::Decode(splits.Get(), pb.overall.pbCpZoneTimes, pb.overall.cpCount, pb.overall.pbStageZoneTimes, pb.overall.stageCount))
+	{
+		META_CONPRINTF("[Surf::Timer] Failed to decode cached split times.\n");
+	}
+}
+
+// Entry of a cache sized for the course.
+static_function PBData &Timer_GetCacheEntry(PBCache &cache, const SurfCourseDescriptor *course, PluginId modeID)
+{
+	PBData &pb = cache.FindOrInsert(ToPBDataKey(modeID, course->guid));
+	pb.overall.cpCount = (u16)Clamp(course->checkpointCount, 0, SURF_MAX_CHECKPOINT_ZONES);
+	pb.overall.stageCount = (u16)Clamp(course->stageCount, 0, SURF_MAX_STAGE_ZONES);
+	return pb;
+}
+
+static_function void Timer_FlushPBCacheQueue()
+{
+	std::vector<CPlayerUserId> players = std::move(g_pbCacheQueue.players);
+	g_pbCacheQueue.players.clear();
+	g_pbCacheQueue.flushTime = 0.0;
+	if (!SurfDatabaseService::IsReady())
+	{
+		return;
+	}
+
+	std::vector<u64> steamID64s;
+	for (CPlayerUserId uid : players)
+	{
+		SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(uid);
+		if (player)
+		{
+			steamID64s.push_back(player->GetSteamId64());
+		}
+	}
+	if (steamID64s.empty())
+	{
+		return;
+	}
+
+	auto onQuerySuccess = [players](std::vector<ISQLQuery *> queries)
+	{
+		// Players might have left or been replaced while the query ran.
+		std::unordered_map<u64, SurfPlayer *> playersBySteamID;
+		for (CPlayerUserId uid : players)
+		{
+			SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(uid);
+			if (player)
+			{
+				playersBySteamID[player->GetSteamId64()] = player;
+			}
+		}
+		ISQLResult *result = queries[0]->GetResultSet();
+		while (result && result->FetchRow())
+		{
+			auto it = playersBySteamID.find(result->GetInt64(0));
+			if (it == playersBySteamID.end())
+			{
+				continue;
+			}
+			auto modeInfo = Surf::mode::GetModeInfoFromDatabaseID(result->GetInt(3));
+			if (modeInfo.databaseID < 0)
+			{
+				continue;
+			}
+			const SurfCourseDescriptor *course = Surf::course::GetCourseByLocalCourseID(result->GetInt(2));
+			if (!course)
+			{
+				continue;
+			}
+			it->second->timerService->InsertPBToCache(result->GetFloat(1), course, modeInfo.id, false, result->GetString(4));
+		}
+	};
+	SurfDatabaseService::QueryAllPBs(steamID64s, g_pSurfUtils->GetCurrentMapName(), onQuerySuccess, SurfDatabaseService::OnGenericTxnFailure);
+}
+
 static_global class SurfDatabaseServiceEventListener_Timer : public SurfDatabaseServiceEventListener
 {
 public:
@@ -49,8 +160,8 @@ static_global class SurfOptionServiceEventListener_Timer : public SurfOptionServ
 	}
 } optionEventListener;
 
-std::unordered_map<PBDataKey, PBData> SurfTimerService::srCache;
-std::unordered_map<PBDataKey, PBData> SurfTimerService::wrCache;
+PBCache SurfTimerService::srCache;
+PBCache SurfTimerService::wrCache;
 
 static_global CUtlVector<SurfTimerServiceEventListener *> eventListeners;
 
@@ -117,7 +228,7 @@ void SurfTimerService::StageZoneStartTouch(const SurfCourseDescriptor *course, i
 	if (stageNumber > this->currentStage + 1)
 	{
 		this->PlayMissedZoneSound();
-		this->player->languageService->PrintChat(true, false, "Touched too high stage number (Missed stage)", this->currentStage + 1);
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Touched too high stage number (Missed stage)"), this->currentStage + 1);
 		return;
 	}
 
@@ -225,11 +336,11 @@ bool SurfTimerService::TimerStart(const SurfCourseDescriptor *courseDesc, bool p
 
 	if (!this->player->IsAuthenticated())
 	{
-		this->player->languageService->PrintChat(true, false, "No Steam Authentication Warning");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("No Steam Authentication Warning"));
 	}
 	if (SurfGlobalService::IsAvailable() && !this->player->hasPrime)
 	{
-		this->player->languageService->PrintChat(true, false, "No Prime Warning");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("No Prime Warning"));
 	}
 
 	const char *language = this->player->languageService->GetLanguage();
@@ -265,7 +376,7 @@ bool SurfTimerService::TimerEnd(const SurfCourseDescriptor *courseDesc)
 	if (courseDesc->stageCount > 0 && (this->currentStage - 1 != courseDesc->stageCount))
 	{
 		this->PlayMissedZoneSound();
-		this->player->languageService->PrintChat(true, false, "Can't Finish Run (Missed Stage)", this->currentStage + 1);
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Finish Run (Missed Stage)"), this->currentStage + 1);
 		return false;
 	}
 
@@ -275,11 +386,11 @@ bool SurfTimerService::TimerEnd(const SurfCourseDescriptor *courseDesc)
 		i32 missCount = courseDesc->checkpointCount - this->reachedCheckpoints;
 		if (missCount == 1)
 		{
-			this->player->languageService->PrintChat(true, false, "Can't Finish Run (Missed a Checkpoint Zone)");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Finish Run (Missed a Checkpoint Zone)"));
 		}
 		else
 		{
-			this->player->languageService->PrintChat(true, false, "Can't Finish Run (Missed Checkpoint Zones)", missCount);
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Finish Run (Missed Checkpoint Zones)"), missCount);
 		}
 		return false;
 	}
@@ -501,7 +612,7 @@ void SurfTimerService::Pause()
 	}
 	if (!allowPause)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Pause (Generic)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Pause (Generic)"));
 		this->player->PlayErrorSound();
 		return;
 	}
@@ -542,7 +653,7 @@ bool SurfTimerService::CanPause(bool showError)
 		{
 			if (showError)
 			{
-				this->player->languageService->PrintChat(true, false, "Can't Pause (Just Resumed)");
+				this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Pause (Just Resumed)"));
 				this->player->PlayErrorSound();
 			}
 			return false;
@@ -551,7 +662,7 @@ bool SurfTimerService::CanPause(bool showError)
 		{
 			if (showError)
 			{
-				this->player->languageService->PrintChat(true, false, "Can't Pause (Midair)");
+				this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Pause (Midair)"));
 				this->player->PlayErrorSound();
 			}
 			return false;
@@ -578,7 +689,7 @@ void SurfTimerService::Resume(bool force)
 	}
 	if (!allowResume)
 	{
-		this->player->languageService->PrintChat(true, false, "Can't Resume (Generic)");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Resume (Generic)"));
 		this->player->PlayErrorSound();
 		return;
 	}
@@ -617,7 +728,7 @@ bool SurfTimerService::CanResume(bool showError)
 	{
 		if (showError)
 		{
-			this->player->languageService->PrintChat(true, false, "Can't Resume (Just Paused)");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Can't Resume (Just Paused)"));
 			this->player->PlayErrorSound();
 		}
 		return false;
@@ -843,14 +954,14 @@ void SurfTimerService::SetCompareTarget(const char *typeString)
 {
 	if (!typeString || !V_stricmp("", typeString))
 	{
-		this->player->languageService->PrintChat(true, false, "Compare Command Usage");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Compare Command Usage"));
 		return;
 	}
 
 	CompareType type = GetCompareTypeFromString(typeString);
 	if (type == COMPARETYPE_COUNT)
 	{
-		this->player->languageService->PrintChat(true, false, "Compare Command Usage");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Compare Command Usage"));
 		return;
 	}
 
@@ -859,27 +970,27 @@ void SurfTimerService::SetCompareTarget(const char *typeString)
 	{
 		case COMPARE_NONE:
 		{
-			this->player->languageService->PrintChat(true, false, "Compare Disabled");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Compare Disabled"));
 			break;
 		}
 		case COMPARE_SPB:
 		{
-			this->player->languageService->PrintChat(true, false, "Compare Server PB");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Compare Server PB"));
 			break;
 		}
 		case COMPARE_GPB:
 		{
-			this->player->languageService->PrintChat(true, false, "Compare Global PB");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Compare Global PB"));
 			break;
 		}
 		case COMPARE_SR:
 		{
-			this->player->languageService->PrintChat(true, false, "Compare Server Record");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Compare Server Record"));
 			break;
 		}
 		case COMPARE_WR:
 		{
-			this->player->languageService->PrintChat(true, false, "Compare World Record");
+			this->player->languageService->PrintChat(true, false, SURF_PHRASE("Compare World Record"));
 			break;
 		}
 	}
@@ -910,35 +1021,19 @@ const PBData *SurfTimerService::GetCompareTargetForType(CompareType type, PBData
 	{
 		case COMPARE_WR:
 		{
-			if (SurfTimerService::wrCache.find(key) != SurfTimerService::wrCache.end())
-			{
-				return &SurfTimerService::wrCache[key];
-			}
-			break;
+			return SurfTimerService::wrCache.Find(key);
 		}
 		case COMPARE_SR:
 		{
-			if (SurfTimerService::srCache.find(key) != SurfTimerService::srCache.end())
-			{
-				return &SurfTimerService::srCache[key];
-			}
-			break;
+			return SurfTimerService::srCache.Find(key);
 		}
 		case COMPARE_GPB:
 		{
-			if (SurfTimerService::globalPBCache.find(key) != SurfTimerService::globalPBCache.end())
-			{
-				return &this->globalPBCache[key];
-			}
-			break;
+			return this->globalPBCache.Find(key);
 		}
 		case COMPARE_SPB:
 		{
-			if (SurfTimerService::localPBCache.find(key) != SurfTimerService::localPBCache.end())
-			{
-				return &this->localPBCache[key];
-			}
-			break;
+			return this->localPBCache.Find(key);
 		}
 	}
 	return nullptr;
@@ -946,56 +1041,53 @@ const PBData *SurfTimerService::GetCompareTargetForType(CompareType type, PBData
 
 const PBData *SurfTimerService::GetCompareTarget(PBDataKey key)
 {
+	PBData *pb = nullptr;
 	switch (this->currentCompareType)
 	{
 		case COMPARE_WR:
 		{
-			if (SurfTimerService::wrCache.find(key) != SurfTimerService::wrCache.end())
-			{
-				return &SurfTimerService::wrCache[key];
-			}
+			pb = SurfTimerService::wrCache.Find(key);
 			break;
 		}
 		case COMPARE_SR:
 		{
-			if (SurfTimerService::srCache.find(key) != SurfTimerService::srCache.end())
-			{
-				return &SurfTimerService::srCache[key];
-			}
+			pb = SurfTimerService::srCache.Find(key);
 			break;
 		}
 		case COMPARE_GPB:
 		{
-			if (SurfTimerService::globalPBCache.find(key) != SurfTimerService::globalPBCache.end())
-			{
-				return &this->globalPBCache[key];
-			}
+			pb = this->globalPBCache.Find(key);
 			break;
 		}
 		case COMPARE_SPB:
 		{
-			if (SurfTimerService::localPBCache.find(key) != SurfTimerService::localPBCache.end())
-			{
-				return &this->localPBCache[key];
-			}
+			pb = this->localPBCache.Find(key);
 			break;
 		}
 	}
-	return nullptr;
+	if (pb)
+	{
+		Timer_DecodePendingSplits(*pb);
+	}
+	return pb;
 }
 
 void SurfTimerService::ClearRecordCache()
 {
-	SurfTimerService::srCache.clear();
-	SurfTimerService::wrCache.clear();
+	SurfTimerService::srCache.Clear();
+	SurfTimerService::wrCache.Clear();
 	for (i32 i = 0; i < MAXPLAYERS + 1; i++)
 	{
 		SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(i);
 		if (player && player->timerService)
 		{
 			player->timerService->ClearPBCache();
+			// Global PBs are fetched again when the player joins the new map.
+			player->timerService->globalPBCache.Clear();
 		}
 	}
+	// Nothing refers to the split times anymore.
+	g_splitArena.Reset();
 }
 
 void SurfTimerService::UpdateLocalRecordCache()
@@ -1024,119 +1116,48 @@ void SurfTimerService::UpdateLocalRecordCache()
 	SurfDatabaseService::QueryAllRecords(g_pSurfUtils->GetCurrentMapName(), onQuerySuccess, SurfDatabaseService::OnGenericTxnFailure);
 }
 
-void SurfTimerService::InsertRecordToCache(f64 time, const SurfCourseDescriptor *course, PluginId modeID, bool global, CUtlString metadata)
+const PBData *SurfTimerService::GetCachedRecord(const SurfCourseDescriptor *course, PluginId modeID, bool global)
 {
-	PBData &pb = global ? SurfTimerService::wrCache[ToPBDataKey(modeID, course->guid)] : SurfTimerService::srCache[ToPBDataKey(modeID, course->guid)];
-
-	pb.overall.pbTime = time;
-	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
-	CUtlString error = "";
-	if (metadata.IsEmpty())
-	{
-		return;
-	}
-	LoadKV3FromJSON(&kv, &error, metadata.Get(), "");
-	if (!error.IsEmpty())
-	{
-		META_CONPRINTF("[Surf::Timer] Failed to insert PB to cache due to metadata error: %s\n", error.Get());
-		return;
-	}
+	return (global ? SurfTimerService::wrCache : SurfTimerService::srCache).Find(ToPBDataKey(modeID, course->guid));
+}
 
-	KeyValues3 *data = kv.FindMember("cpZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->checkpointCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			pb.overall.pbCpZoneTimes[i] = time;
-		}
-	}
+void SurfTimerService::InsertRecordToCache(f64 time, const SurfCourseDescriptor *course, PluginId modeID, bool global, CUtlString splits)
+{
+	PBData &pb = Timer_GetCacheEntry(global ? SurfTimerService::wrCache : SurfTimerService::srCache, course, modeID);
 
-	data = kv.FindMember("stageZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
+	pb.overall.pbTime = time;
+	// Split times are only decoded once someone compares against them.
+	if (!splits.IsEmpty())
 	{
-		for (i32 i = 0; i < course->stageCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			pb.overall.pbStageZoneTimes[i] = time;
-		}
+		pb.pendingSplits = splits;
 	}
 }
 
 void SurfTimerService::ClearPBCache()
 {
-	this->localPBCache.clear();
+	this->localPBCache.Clear();
 }
 
 const PBData *SurfTimerService::GetGlobalCachedPB(const SurfCourseDescriptor *course, PluginId modeID)
 {
-	PBDataKey key = ToPBDataKey(modeID, course->guid);
-
-	if (this->globalPBCache.find(key) == this->globalPBCache.end())
-	{
-		return nullptr;
-	}
+	return this->globalPBCache.Find(ToPBDataKey(modeID, course->guid));
+}
 
-	return &this->globalPBCache[key];
+const PBData *SurfTimerService::GetLocalCachedPB(const SurfCourseDescriptor *course, PluginId modeID)
+{
+	return this->localPBCache.Find(ToPBDataKey(modeID, course->guid));
 }
 
-void SurfTimerService::InsertPBToCache(f64 time, const SurfCourseDescriptor *course, PluginId modeID, bool global, CUtlString metadata, f64 points)
+void SurfTimerService::InsertPBToCache(f64 time, const SurfCourseDescriptor *course, PluginId modeID, bool global, CUtlString splits, f64 points)
 {
-	PBData &pb = global ? this->globalPBCache[ToPBDataKey(modeID, course->guid)] : this->localPBCache[ToPBDataKey(modeID, course->guid)];
+	PBData &pb = Timer_GetCacheEntry(global ? this->globalPBCache : this->localPBCache, course, modeID);
 
 	pb.overall.points = points;
 	pb.overall.pbTime = time;
-	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
-	CUtlString error = "";
-	if (metadata.IsEmpty())
+	// Split times are only decoded once someone compares against them.
+	if (!splits.IsEmpty())
 	{
-		return;
-	}
-	LoadKV3FromJSON(&kv, &error, metadata.Get(), "");
-	if (!error.IsEmpty())
-	{
-		META_CONPRINTF("[Surf::Timer] Failed to insert server record to cache due to metadata error: %s\n", error.Get());
-		return;
-	}
-
-	KeyValues3 *data = kv.FindMember("cpZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->checkpointCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			pb.overall.pbCpZoneTimes[i] = time;
-		}
-	}
-
-	data = kv.FindMember("stageZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->stageCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			pb.overall.pbStageZoneTimes[i] = time;
-		}
+		pb.pendingSplits = splits;
 	}
 }
 
@@ -1206,16 +1227,16 @@ void SurfTimerService::ShowCheckpointText(u32 currentCheckpoint)
 	const PBData *pb = this->GetCompareTarget(key);
 	if (pb)
 	{
-		if (pb->overall.pbCpZoneTimes[currentCheckpoint - 1] > 0)
+		if (pb->overall.GetCpZoneTime(currentCheckpoint - 1) > 0)
 		{
-			f64 diff = this->cpZoneTimes[currentCheckpoint - 1] - pb->overall.pbCpZoneTimes[currentCheckpoint - 1];
+			f64 diff = this->cpZoneTimes[currentCheckpoint - 1] - pb->overall.GetCpZoneTime(currentCheckpoint - 1);
 			CUtlString diffText = SurfTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiff = this->player->languageService->PrepareMessage(diffTextKeys[this->currentCompareType], diffText.Get());
 		}
 	}
 
-	this->player->languageService->PrintChat(true, false, "Course Checkpoint Reached", currentCheckpoint, time.Get(), pbDiff.c_str());
+	this->player->languageService->PrintChat(true, false, SURF_PHRASE("Course Checkpoint Reached"), currentCheckpoint, time.Get(), pbDiff.c_str());
 }
 
 void SurfTimerService::ShowStageText()
@@ -1244,16 +1265,16 @@ void SurfTimerService::ShowStageText()
 	const PBData *pb = this->GetCompareTarget(key);
 	if (pb)
 	{
-		if (pb->overall.pbStageZoneTimes[this->currentStage - 1] > 0)
+		if (pb->overall.GetStageZoneTime(this->currentStage - 1) > 0)
 		{
-			f64 diff = this->stageZoneTimes[this->currentStage - 1] - pb->overall.pbStageZoneTimes[this->currentStage - 1];
+			f64 diff = this->stageZoneTimes[this->currentStage - 1] - pb->overall.GetStageZoneTime(this->currentStage - 1);
 			CUtlString diffText = SurfTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiff = this->player->languageService->PrepareMessage(diffTextKeys[this->currentCompareType], diffText.Get());
 		}
 	}
 
-	this->player->languageService->PrintChat(true, false, "Course Stage Reached", this->currentStage, time.Get(), pbDiff.c_str());
+	this->player->languageService->PrintChat(true, false, SURF_PHRASE("Course Stage Reached"), this->currentStage, time.Get(), pbDiff.c_str());
 }
 
 CUtlString SurfTimerService::GetCurrentRunMetadata()
@@ -1284,38 +1305,38 @@ CUtlString SurfTimerService::GetCurrentRunMetadata()
 	return "";
 }
 
+std::string SurfTimerService::GetCurrentRunSplits()
+{
+	return Surf::splits::Encode(this->cpZoneTimes.Base(), this->cpZoneTimes.Count(), this->stageZoneTimes.Base(), this->stageZoneTimes.Count());
+}
+
 void SurfTimerService::UpdateLocalPBCache()
 {
 	CPlayerUserId uid = player->GetClient()->GetUserID();
-
-	auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
+	for (CPlayerUserId queued : g_pbCacheQueue.players)
 	{
-		SurfPlayer *pl = g_pSurfPlayerManager->ToPlayer(uid);
-		if (!pl)
+		if (queued.Get() == uid.Get())
 		{
 			return;
 		}
-		ISQLResult *result = queries[0]->GetResultSet();
-		if (result && result->GetRowCount() > 0)
-		{
-			while (result->FetchRow())
-			{
-				auto modeInfo = Surf::mode::GetModeInfoFromDatabaseID(result->GetInt(2));
-				if (modeInfo.databaseID < 0)
-				{
-					continue;
-				}
-				const SurfCourseDescriptor *course = Surf::course::GetCourseByLocalCourseID(result->GetInt(1));
-				if (!course)
-				{
-					continue;
-				}
-				pl->timerService->InsertPBToCache(result->GetFloat(0), course, modeInfo.id, false, result->GetString(3));
-			}
-		}
-	};
-	SurfDatabaseService::QueryAllPBs(player->GetSteamId64(), g_pSurfUtils->GetCurrentMapName(), onQuerySuccess,
-									 SurfDatabaseService::OnGenericTxnFailure);
+	}
+	g_pbCacheQueue.players.push_back(uid);
+	if (g_pbCacheQueue.flushTime == 0.0)
+	{
+		g_pbCacheQueue.flushTime = Plat_FloatTime() + SURF_PB_CACHE_BATCH_DELAY;
+	}
+	if (g_pbCacheQueue.players.size() >= MAXPLAYERS)
+	{
+		Timer_FlushPBCacheQueue();
+	}
+}
+
+void SurfTimerService::ProcessPBCacheQueue()
+{
+	if (g_pbCacheQueue.flushTime != 0.0 && Plat_FloatTime() >= g_pbCacheQueue.flushTime)
+	{
+		Timer_FlushPBCacheQueue();
+	}
 }
 
 std::string SurfTimerService::GetStartSpeedText(const char *language)
@@ -1351,6 +1372,7 @@ void SurfDatabaseServiceEventListener_Timer::OnMapSetup()
 	// TODO: find a better way to do this, we now call SetupLocalCourses after all trigger_multiple spawns
 	// Surf::course::SetupLocalCourses();
 	SurfTimerService::UpdateLocalRecordCache();
+	Surf::leaderboard::Load();
 }
 
 void SurfDatabaseServiceEventListener_Timer::OnClientSetup(Player *player, u64 steamID64, bool isCheater)
@@ -3,6 +3,7 @@
 #include "../surf.h"
 #include "../checkpoint/surf_checkpoint.h"
 #include "surf/mappingapi/surf_mappingapi.h"
+#include "pb_cache.h"
 
 #define SURF_MAX_MODE_NAME_LENGTH 128
 
@@ -20,49 +21,6 @@
 
 #define SURF_PAUSE_COOLDOWN 1.0f
 
-struct PBData
-{
-	PBData()
-	{
-		Reset();
-	}
-
-	void Reset()
-	{
-		overall.pbTime = {};
-		overall.pbCpZoneTimes.FillWithValue(-1.0);
-		overall.pbStageZoneTimes.FillWithValue(-1.0);
-	}
-
-	struct
-	{
-		f64 pbTime {};
-		f64 points {};
-		CUtlVectorFixed<f64, SURF_MAX_CHECKPOINT_ZONES> pbCpZoneTimes;
-		CUtlVectorFixed<f64, SURF_MAX_STAGE_ZONES> pbStageZoneTimes;
-	} overall;
-};
-
-// Convert mode and course ID to one single value.
-typedef u64 PBDataKey;
-
-inline PBDataKey ToPBDataKey(u32 modeID, u32 courseID)
-{
-	return modeID | ((u64)courseID << 32);
-}
-
-inline void ConvertFromPBDataKey(PBDataKey key, uint32_t *modeID, uint32_t *courseID)
-{
-	if (modeID)
-	{
-		*modeID = (uint32_t)key;
-	}
-	if (courseID)
-	{
-		*courseID = (uint32_t)(key >> 32);
-	}
-}
-
 class SurfTimerServiceEventListener
 {
 public:
@@ -123,13 +81,13 @@ private:
 	CUtlVectorFixed<f64, SURF_MAX_STAGE_ZONES> stageEndTouchTimes {};
 
 	// PB cache per mode and per course.
-	std::unordered_map<PBDataKey, PBData> localPBCache;
-	std::unordered_map<PBDataKey, PBData> globalPBCache;
+	PBCache localPBCache;
+	PBCache globalPBCache;
 
 	// SR cache should be loaded upon map start, every time !wr is queried and every time a run beats the server record.
-	static std::unordered_map<PBDataKey, PBData> srCache;
+	static PBCache srCache;
 
-	static std::unordered_map<PBDataKey, PBData> wrCache;
+	static PBCache wrCache;
 
 public:
 	enum CompareType : u8
@@ -161,12 +119,16 @@ private:
 public:
 	static void ClearRecordCache();
 	static void UpdateLocalRecordCache();
-	static void InsertRecordToCache(f64 time, const SurfCourseDescriptor *courseName, PluginId modeID, bool global, CUtlString metadata = "");
+	static const PBData *GetCachedRecord(const SurfCourseDescriptor *course, PluginId modeID, bool global);
+	static void InsertRecordToCache(f64 time, const SurfCourseDescriptor *courseName, PluginId modeID, bool global, CUtlString splits = "");
 
 	void ClearPBCache();
 	const PBData *GetGlobalCachedPB(const SurfCourseDescriptor *course, PluginId modeID);
+	const PBData *GetLocalCachedPB(const SurfCourseDescriptor *course, PluginId modeID);
+	// Queue the player to have their PBs loaded, players joining around the same time are loaded with a single query.
 	void UpdateLocalPBCache();
-	void InsertPBToCache(f64 time, const SurfCourseDescriptor *courseName, PluginId modeID, bool global, CUtlString metadata = "", f64 points = 0);
+	static void ProcessPBCacheQueue();
+	void InsertPBToCache(f64 time, const SurfCourseDescriptor *courseName, PluginId modeID, bool global, CUtlString splits = "", f64 points = 0);
 	void SetCompareTarget(const char *typeString);
 
 	void CheckMissedTime();
@@ -174,7 +136,10 @@ public:
 	void ShowCheckpointText(u32 currentCheckpoint);
 	void ShowStageText();
 
+	// JSON metadata sent along global submissions.
 	CUtlString GetCurrentRunMetadata();
+	// Split times in the format of the local database.
+	std::string GetCurrentRunSplits();
 
 private:
 	bool validJump {};
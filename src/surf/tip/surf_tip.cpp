@@ -126,7 +126,7 @@ void SurfTipService::OnPlayerJoinTeam(i32 team)
 	this->teamJoinedAtLeastOnce = true;
 	if (g_pMultiAddonManager)
 	{
-		this->player->languageService->PrintChat(true, false, "Menu Hint");
+		this->player->languageService->PrintChat(true, false, SURF_PHRASE("Menu Hint"));
 	}
 	this->QueryBeamCvar();
 }
@@ -0,0 +1,406 @@
+/*
+	Static AABB tree of every trigger on the map, used as a broad phase for TriggerFix.
+
+	Most of the time players are nowhere near a trigger, and asking the engine to trace against every trigger just to find out
+	that nothing was hit is the most expensive part of trigger touching. The tree only answers whether a box might overlap a trigger;
+	the engine trace is still used for brush-accurate results whenever it does.
+
+	The tree is built at round start. Triggers that are parented to something or that spawn after the tree was built are kept in a
+	separate list whose bounds are refreshed every tick. Triggers in the tree are checked once per tick as well, and if one was
+	moved, rotated or resized (e.g. teleported by an input) the tree is refitted. One that gets parented moves to the list.
+*/
+
+#include "surf_trigger.h"
+#include "sdk/entity/cbasetrigger.h"
+#include "sdk/ccollisionproperty.h"
+#include "mathlib/mathlib.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "tier0/memdbgon.h"
+
+// Triggers are expanded by this much to make up for float imprecision, the engine trace does the exact test anyway.
+#define BVH_BOUNDS_MARGIN 1.0f
+#define BVH_MAX_LEAF_SIZE 4
+#define BVH_MAX_DEPTH     64
+
+struct TriggerBVHItem
+{
+	Vector mins;
+	Vector maxs;
+	Vector center;
+	CEntityHandle handle;
+	// What the bounds were computed from, to notice triggers that changed after the tree was built.
+	Vector origin;
+	QAngle angles;
+	Vector localMins;
+	Vector localMaxs;
+};
+
+struct TriggerBVHNode
+{
+	Vector mins;
+	Vector maxs;
+	// Leaf: first item index. Branch: index of the right child, the left child immediately follows its parent.
+	i32 offset;
+	// Number of items in the leaf, 0 for branches.
+	i32 count;
+};
+
+static_global struct
+{
+	bool built;
+	CUtlVector<TriggerBVHItem> items;
+	CUtlVector<TriggerBVHNode> nodes;
+
+	// Parented or late-spawned triggers, tested linearly.
+	CUtlVector<TriggerBVHItem> dynamicItems;
+	i32 dynamicRefreshTick = -1;
+	i32 staticRefreshTick = -1;
+} g_triggerBVH;
+
+static_function bool BVH_HasBounds(CBaseEntity *trigger)
+{
+	return trigger && trigger->m_pCollision() && trigger->m_CBodyComponent() && trigger->m_CBodyComponent()->m_pSceneNode();
+}
+
+// Expects BVH_HasBounds to be true.
+static_function void BVH_UpdateItem(CBaseEntity *trigger, TriggerBVHItem &item)
+{
+	CGameSceneNode *node = trigger->m_CBodyComponent()->m_pSceneNode();
+	item.origin = node->m_vecAbsOrigin();
+	item.angles = node->m_angAbsRotation();
+	item.localMins = trigger->m_pCollision()->m_vecMins();
+	item.localMaxs = trigger->m_pCollision()->m_vecMaxs();
+
+	matrix3x4_t transform;
+	AngleMatrix(item.angles, item.origin, transform);
+	TransformAABB(transform, item.localMins, item.localMaxs, item.mins, item.maxs);
+
+	Vector margin(BVH_BOUNDS_MARGIN, BVH_BOUNDS_MARGIN, BVH_BOUNDS_MARGIN);
+	item.mins -= margin;
+	item.maxs += margin;
+	item.center = (item.mins + item.maxs) * 0.5f;
+}
+
+static_function bool BVH_ItemChanged(CBaseEntity *trigger, const TriggerBVHItem &item)
+{
+	CGameSceneNode *node = trigger->m_CBodyComponent()->m_pSceneNode();
+	return node->m_vecAbsOrigin() != item.origin || node->m_angAbsRotation() != item.angles
+		   || trigger->m_pCollision()->m_vecMins() != item.localMins || trigger->m_pCollision()->m_vecMaxs() != item.localMaxs;
+}
+
+// Triggers that were removed or parented keep their slot in the tree with inverted bounds that never overlap anything.
+static_function void BVH_EmptyItem(TriggerBVHItem &item)
+{
+	item.mins = Vector(1, 1, 1);
+	item.maxs = Vector(-1, -1, -1);
+	item.handle = CEntityHandle();
+}
+
+static_function bool BVH_IsEmptyItem(const TriggerBVHItem &item)
+{
+	return item.mins.x > item.maxs.x;
+}
+
+static_function bool BVH_IsDynamicTrigger(CBaseEntity *trigger)
+{
+	return trigger->m_CBodyComponent()->m_pSceneNode()->m_pParent() != nullptr;
+}
+
+static_function inline bool BVH_BoxesOverlap(const Vector &mins1, const Vector &maxs1, const Vector &mins2, const Vector &maxs2)
+{
+	return mins1.x <= maxs2.x && maxs1.x >= mins2.x && mins1.y <= maxs2.y && maxs1.y >= mins2.y && mins1.z <= maxs2.z && maxs1.z >= mins2.z;
+}
+
+// Build the subtree covering items [first, first + count) and return its node index.
+static_function i32 BVH_BuildNode(i32 first, i32 count, i32 depth)
+{
+	i32 nodeIndex = g_triggerBVH.nodes.AddToTail();
+	TriggerBVHNode node {};
+	node.mins = g_triggerBVH.items[first].mins;
+	node.maxs = g_triggerBVH.items[first].maxs;
+	Vector centerMins = g_triggerBVH.items[first].center;
+	Vector centerMaxs = g_triggerBVH.items[first].center;
+	for (i32 i = first + 1; i < first + count; i++)
+	{
+		const TriggerBVHItem &item = g_triggerBVH.items[i];
+		VectorMin(node.mins, item.mins, node.mins);
+		VectorMax(node.maxs, item.maxs, node.maxs);
+		VectorMin(centerMins, item.center, centerMins);
+		VectorMax(centerMaxs, item.center, centerMaxs);
+	}
+
+	if (count <= BVH_MAX_LEAF_SIZE || depth >= BVH_MAX_DEPTH - 1)
+	{
+		node.offset = first;
+		node.count = count;
+		g_triggerBVH.nodes[nodeIndex] = node;
+		return nodeIndex;
+	}
+
+	// Median split along the longest axis of the item centers.
+	Vector extent = centerMaxs - centerMins;
+	i32 axis = 0;
+	if (extent.y > extent[axis])
+	{
+		axis = 1;
+	}
+	if (extent.z > extent[axis])
+	{
+		axis = 2;
+	}
+	std::nth_element(g_triggerBVH.items.Base() + first, g_triggerBVH.items.Base() + first + count / 2, g_triggerBVH.items.Base() + first + count,
+					 [axis](const TriggerBVHItem &a, const TriggerBVHItem &b) { return a.center[axis] < b.center[axis]; });
+
+	BVH_BuildNode(first, count / 2, depth + 1);
+	node.offset = BVH_BuildNode(first + count / 2, count - count / 2, depth + 1);
+	node.count = 0;
+	g_triggerBVH.nodes[nodeIndex] = node;
+	return nodeIndex;
+}
+
+// Recompute the bounds of every node from its items or children. Children always come after their parent, so going backwards works.
+static_function void BVH_Refit()
+{
+	FOR_EACH_VEC_BACK(g_triggerBVH.nodes, nodeIndex)
+	{
+		TriggerBVHNode &node = g_triggerBVH.nodes[nodeIndex];
+		if (node.count == 0)
+		{
+			const TriggerBVHNode &left = g_triggerBVH.nodes[nodeIndex + 1];
+			const TriggerBVHNode &right = g_triggerBVH.nodes[node.offset];
+			VectorMin(left.mins, right.mins, node.mins);
+			VectorMax(left.maxs, right.maxs, node.maxs);
+			continue;
+		}
+		// Stays inverted if every item of the leaf is empty.
+		node.mins = Vector(FLT_MAX, FLT_MAX, FLT_MAX);
+		node.maxs = Vector(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (i32 i = node.offset; i < node.offset + node.count; i++)
+		{
+			const TriggerBVHItem &item = g_triggerBVH.items[i];
+			if (BVH_IsEmptyItem(item))
+			{
+				continue;
+			}
+			VectorMin(node.mins, item.mins, node.mins);
+			VectorMax(node.maxs, item.maxs, node.maxs);
+		}
+	}
+}
+
+// Catch triggers in the tree that were moved, rotated, resized or parented since the tree was built.
+static_function void BVH_RefreshStaticTriggers()
+{
+	i32 tick = g_pSurfUtils->GetServerGlobals()->tickcount;
+	if (g_triggerBVH.staticRefreshTick == tick)
+	{
+		return;
+	}
+	g_triggerBVH.staticRefreshTick = tick;
+
+	bool changed = false;
+	FOR_EACH_VEC(g_triggerBVH.items, i)
+	{
+		TriggerBVHItem &item = g_triggerBVH.items[i];
+		if (BVH_IsEmptyItem(item))
+		{
+			continue;
+		}
+		CBaseEntity *trigger = static_cast<CBaseEntity *>(GameEntitySystem()->GetEntityInstance(item.handle));
+		if (!BVH_HasBounds(trigger))
+		{
+			BVH_EmptyItem(item);
+			changed = true;
+			continue;
+		}
+		if (BVH_IsDynamicTrigger(trigger))
+		{
+			g_triggerBVH.dynamicItems.AddToTail(item);
+			g_triggerBVH.dynamicRefreshTick = -1;
+			BVH_EmptyItem(item);
+			changed = true;
+			continue;
+		}
+		if (BVH_ItemChanged(trigger, item))
+		{
+			BVH_UpdateItem(trigger, item);
+			changed = true;
+		}
+	}
+	if (changed)
+	{
+		BVH_Refit();
+	}
+}
+
+static_function void BVH_RefreshDynamicTriggers()
+{
+	i32 tick = g_pSurfUtils->GetServerGlobals()->tickcount;
+	if (g_triggerBVH.dynamicRefreshTick == tick)
+	{
+		return;
+	}
+	g_triggerBVH.dynamicRefreshTick = tick;
+
+	FOR_EACH_VEC_BACK(g_triggerBVH.dynamicItems, i)
+	{
+		TriggerBVHItem &item = g_triggerBVH.dynamicItems[i];
+		CBaseEntity *trigger = static_cast<CBaseEntity *>(GameEntitySystem()->GetEntityInstance(item.handle));
+		if (!BVH_HasBounds(trigger))
+		{
+			g_triggerBVH.dynamicItems.FastRemove(i);
+			continue;
+		}
+		BVH_UpdateItem(trigger, item);
+	}
+}
+
+void Surf::trigger::ClearBVH()
+{
+	g_triggerBVH.built = false;
+	g_triggerBVH.items.RemoveAll();
+	g_triggerBVH.nodes.RemoveAll();
+	g_triggerBVH.dynamicItems.RemoveAll();
+	g_triggerBVH.dynamicRefreshTick = -1;
+	g_triggerBVH.staticRefreshTick = -1;
+}
+
+void Surf::trigger::BuildBVH()
+{
+	Surf::trigger::ClearBVH();
+
+	for (CEntityIdentity *entID = GameEntitySystem()->m_EntityList.m_pFirstActiveEntity; entID != NULL; entID = entID->m_pNext)
+	{
+		if (!entID->m_pInstance || !V_strstr(entID->GetClassname(), "trigger_"))
+		{
+			continue;
+		}
+		CBaseEntity *trigger = static_cast<CBaseEntity *>(entID->m_pInstance);
+		if (!BVH_HasBounds(trigger))
+		{
+			continue;
+		}
+		TriggerBVHItem item {};
+		BVH_UpdateItem(trigger, item);
+		item.handle = trigger->GetRefEHandle();
+		if (BVH_IsDynamicTrigger(trigger))
+		{
+			g_triggerBVH.dynamicItems.AddToTail(item);
+		}
+		else
+		{
+			g_triggerBVH.items.AddToTail(item);
+		}
+	}
+
+	if (g_triggerBVH.items.Count() > 0)
+	{
+		g_triggerBVH.nodes.EnsureCapacity(g_triggerBVH.items.Count() * 2);
+		BVH_BuildNode(0, g_triggerBVH.items.Count(), 0);
+	}
+	g_triggerBVH.built = true;
+
+	META_CONPRINTF("[Surf::Trigger] Built trigger tree with %i static and %i dynamic triggers (%i nodes).\n", g_triggerBVH.items.Count(),
+				   g_triggerBVH.dynamicItems.Count(), g_triggerBVH.nodes.Count());
+}
+
+void Surf::trigger::OnTriggerSpawned(CBaseEntity *trigger)
+{
+	if (!g_triggerBVH.built)
+	{
+		return;
+	}
+
+	TriggerBVHItem item {};
+	item.handle = trigger->GetRefEHandle();
+	// Bounds are filled in the next time the dynamic triggers are refreshed.
+	g_triggerBVH.dynamicItems.AddToTail(item);
+	g_triggerBVH.dynamicRefreshTick = -1;
+}
+
+void Surf::trigger::OnTriggerDeleted(CBaseEntity *trigger)
+{
+	if (!g_triggerBVH.built)
+	{
+		return;
+	}
+
+	CEntityHandle handle = trigger->GetRefEHandle();
+	FOR_EACH_VEC(g_triggerBVH.dynamicItems, i)
+	{
+		if (g_triggerBVH.dynamicItems[i].handle == handle)
+		{
+			g_triggerBVH.dynamicItems.FastRemove(i);
+			return;
+		}
+	}
+	// Static triggers stay in the tree with empty bounds, rebuilding the tree isn't worth it.
+	FOR_EACH_VEC(g_triggerBVH.items, i)
+	{
+		if (g_triggerBVH.items[i].handle == handle)
+		{
+			BVH_EmptyItem(g_triggerBVH.items[i]);
+			return;
+		}
+	}
+}
+
+bool Surf::trigger::MightTouchTriggers(const Vector &mins, const Vector &maxs)
+{
+	// Without a tree we know nothing, let the engine figure it out.
+	if (!g_triggerBVH.built)
+	{
+		return true;
+	}
+
+	// Static triggers can turn into dynamic ones, so this goes first.
+	BVH_RefreshStaticTriggers();
+	if (g_triggerBVH.dynamicItems.Count() > 0)
+	{
+		BVH_RefreshDynamicTriggers();
+		FOR_EACH_VEC(g_triggerBVH.dynamicItems, i)
+		{
+			const TriggerBVHItem &item = g_triggerBVH.dynamicItems[i];
+			if (BVH_BoxesOverlap(mins, maxs, item.mins, item.maxs))
+			{
+				return true;
+			}
+		}
+	}
+
+	if (g_triggerBVH.nodes.Count() == 0)
+	{
+		return false;
+	}
+
+	i32 stack[BVH_MAX_DEPTH + 1];
+	i32 stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		i32 nodeIndex = stack[--stackSize];
+		const TriggerBVHNode &node = g_triggerBVH.nodes[nodeIndex];
+		if (!BVH_BoxesOverlap(mins, maxs, node.mins, node.maxs))
+		{
+			continue;
+		}
+		if (node.count > 0)
+		{
+			for (i32 i = node.offset; i < node.offset + node.count; i++)
+			{
+				const TriggerBVHItem &item = g_triggerBVH.items[i];
+				if (BVH_BoxesOverlap(mins, maxs, item.mins, item.maxs))
+				{
+					return true;
+				}
+			}
+			continue;
+		}
+		stack[stackSize++] = nodeIndex + 1;
+		stack[stackSize++] = node.offset;
+	}
+	return false;
+}
@@ -103,6 +103,13 @@ void SurfTriggerService::TouchTriggersAlongPath(const Vector &start, const Vecto
 	{
 		return;
 	}
+	Vector sweptMins, sweptMaxs;
+	VectorMin(start, end, sweptMins);
+	VectorMax(start, end, sweptMaxs);
+	if (!Surf::trigger::MightTouchTriggers(sweptMins + bounds.mins, sweptMaxs + bounds.maxs))
+	{
+		return;
+	}
 	CTraceFilterHitAllTriggers filter;
 	trace_t tr;
 	g_pSurfUtils->TracePlayerBBox(start, end, bounds, &filter, tr);
@@ -147,8 +154,12 @@ void SurfTriggerService::UpdateTriggerTouchList()
 	bbox_t bounds;
 	this->player->GetBBoxBounds(&bounds);
 	CTraceFilterHitAllTriggers filter;
-	trace_t tr;
-	g_pSurfUtils->TracePlayerBBox(origin, origin, bounds, &filter, tr);
+	// Nothing can be hit if the broad phase says so, any trigger still being touched gets its EndTouch below.
+	if (Surf::trigger::MightTouchTriggers(origin + bounds.mins, origin + bounds.maxs))
+	{
+		trace_t tr;
+		g_pSurfUtils->TracePlayerBBox(origin, origin, bounds, &filter, tr);
+	}
 
 	FOR_EACH_VEC_BACK(this->triggerTrackers, i)
 	{
@@ -179,3 +179,15 @@ inline bool operator==(const SurfTriggerService::PushEvent &left, const SurfTrig
 	assert(right.source);
 	return left.source->entity == right.source->entity;
 }
+
+namespace Surf::trigger
+{
+	// Broad phase for TriggerFix, see bvh.cpp.
+	void ClearBVH();
+	void BuildBVH();
+	void OnTriggerSpawned(CBaseEntity *trigger);
+	void OnTriggerDeleted(CBaseEntity *trigger);
+
+	// Return false if the box is guaranteed to not touch any trigger.
+	bool MightTouchTriggers(const Vector &mins, const Vector &maxs);
+} // namespace Surf::trigger
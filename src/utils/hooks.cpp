@@ -15,12 +15,15 @@
 #include "surf/beam/surf_beam.h"
 #include "surf/option/surf_option.h"
 #include "surf/quiet/surf_quiet.h"
+#include "surf/replays/surf_replays.h"
 #include "surf/timer/surf_timer.h"
 #include "surf/timer/announce.h"
+#include "surf/timer/leaderboard.h"
 #include "surf/timer/queries/base_request.h"
 #include "surf/telemetry/surf_telemetry.h"
 #include "surf/trigger/surf_trigger.h"
 #include "surf/db/surf_db.h"
+#include "surf/db/write_queue.h"
 #include "surf/mappingapi/surf_mappingapi.h"
 #include "surf/global/surf_global.h"
 #include "surf/profile/surf_profile.h"
@@ -342,14 +345,17 @@ void EntListener::OnEntitySpawned(CEntityInstance *pEntity)
 		trigger->m_fEffects() &= ~EF_NODRAW;
 		AddEntityHooks(static_cast<CBaseEntity *>(pEntity));
 		Surf::mapapi::CheckEndTimerTrigger((CBaseTrigger *)pEntity);
+		Surf::trigger::OnTriggerSpawned(static_cast<CBaseEntity *>(pEntity));
 	}
 }
 
 void EntListener::OnEntityDeleted(CEntityInstance *pEntity)
 {
+	Surf::mapapi::OnEntityDeleted(pEntity);
 	if (V_strstr(pEntity->GetClassname(), "trigger_"))
 	{
 		RemoveEntityHooks(static_cast<CBaseEntity *>(pEntity));
+		Surf::trigger::OnTriggerDeleted(static_cast<CBaseEntity *>(pEntity));
 	}
 }
 
@@ -458,7 +464,6 @@ static_function void Hook_CheckTransmit(CCheckTransmitInfo **pInfos, int infoCou
 										const Entity2Networkable_t **pNetworkables, const uint16 *pEntityIndicies, int nEntities)
 {
 	Surf::quiet::OnCheckTransmit(pInfos, infoCount);
-	SurfProfileService::OnCheckTransmit();
 	RETURN_META(MRES_IGNORED);
 }
 
@@ -546,6 +551,8 @@ static_function void Hook_ClientDisconnect(CPlayerSlot slot, ENetworkDisconnecti
 	player->timerService->OnClientDisconnect();
 	player->optionService->OnClientDisconnect();
 	player->globalService->OnClientDisconnect();
+	// The server stops simulating once it's empty, don't leave the player's last writes behind.
+	Surf::Database::FlushWriteQueue();
 	g_pSurfPlayerManager->OnClientDisconnect(slot, reason, pszName, xuid, pszNetworkID);
 	RETURN_META(MRES_IGNORED);
 }
@@ -575,6 +582,7 @@ static_function void Hook_StartupServer(const GameSessionConfiguration_t &config
 	g_SurfPlugin.AddonInit();
 	Surf::course::ClearCourses();
 	Surf::mapapi::Init();
+	Surf::trigger::ClearBVH();
 	RETURN_META(MRES_IGNORED);
 }
 
@@ -597,6 +605,7 @@ static_function bool Hook_FireEvent(IGameEvent *event, bool bDontBroadcast)
 		{
 			hooks::HookEntities();
 			Surf::mapapi::OnRoundPreStart();
+			Surf::trigger::ClearBVH();
 		}
 		else if (SURF_STREQI(event->GetName(), "round_start"))
 		{
@@ -604,6 +613,7 @@ static_function bool Hook_FireEvent(IGameEvent *event, bool bDontBroadcast)
 			SurfTimerService::OnRoundStart();
 			Surf::misc::OnRoundStart();
 			Surf::mapapi::OnRoundStart();
+			Surf::trigger::BuildBVH();
 		}
 		else if (SURF_STREQI(event->GetName(), "player_team"))
 		{
@@ -618,6 +628,7 @@ static_function bool Hook_FireEvent(IGameEvent *event, bool bDontBroadcast)
 				if (player)
 				{
 					player->timerService->OnPlayerSpawn();
+					player->profileService->OnPlayerSpawn();
 				}
 			}
 		}
@@ -670,9 +681,11 @@ static_function bool Hook_ActivateServer()
 	META_CONPRINTF("[Surf] Loading map %s, workshop ID %llu, size %llu\n", g_pSurfUtils->GetCurrentMapVPK().Get(), id, size);
 
 	RecordAnnounce::Clear();
+	Surf::leaderboard::Clear();
 	Surf::misc::OnServerActivate();
 	SurfDatabaseService::SetupMap();
 	SurfGlobalService::OnActivateServer();
+	SurfReplayService::OnActivateServer();
 
 	char md5[33];
 	g_pSurfUtils->GetCurrentMapMD5(md5, sizeof(md5));
@@ -704,6 +717,8 @@ static_function CServerSideClientBase *Hook_ConnectClientPost(const char *pszNam
 static_function void Hook_ServerGamePostSimulate(const EventServerGamePostSimulate_t *)
 {
 	ProcessTimers();
+	Surf::Database::ProcessWriteQueue();
+	SurfTimerService::ProcessPBCacheQueue();
 	SurfGlobalService::OnServerGamePostSimulate();
 }
 
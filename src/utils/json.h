@@ -20,11 +20,38 @@ public:
 		value.ToJson(*this);
 	}
 
+	/**
+	 * Decodes a MessagePack or CBOR document. Check `IsValid()` for errors, like with text.
+	 */
+	static Json FromMsgPack(const std::string &data)
+	{
+		return Json(nlohmann::json::from_msgpack(data, true, false));
+	}
+
+	static Json FromCBOR(const std::string &data)
+	{
+		return Json(nlohmann::json::from_cbor(data, true, false));
+	}
+
 	std::string ToString() const
 	{
 		return this->inner.dump();
 	}
 
+	std::string ToMsgPack() const
+	{
+		std::string data;
+		nlohmann::json::to_msgpack(this->inner, data);
+		return data;
+	}
+
+	std::string ToCBOR() const
+	{
+		std::string data;
+		nlohmann::json::to_cbor(this->inner, data);
+		return data;
+	}
+
 	template<typename T>
 	bool Set(const std::string &key, const T &value)
 	{
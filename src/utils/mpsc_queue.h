@@ -0,0 +1,297 @@
+#pragma once
+#include "common.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Move-only replacement for std::function that keeps small callables inline instead of allocating.
+ * Callables that don't fit in `Capacity` bytes (or can throw while being moved) are stored on the heap.
+ */
+template<typename Signature, size_t Capacity = 64>
+class SmallFunction;
+
+template<typename R, typename... Args, size_t Capacity>
+class SmallFunction<R(Args...), Capacity>
+{
+public:
+	SmallFunction() = default;
+
+	template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallFunction>>>
+	SmallFunction(F &&f)
+	{
+		this->Assign(std::forward<F>(f));
+	}
+
+	SmallFunction(SmallFunction &&other) noexcept
+	{
+		this->MoveFrom(other);
+	}
+
+	SmallFunction &operator=(SmallFunction &&other) noexcept
+	{
+		if (this != &other)
+		{
+			this->Reset();
+			this->MoveFrom(other);
+		}
+		return *this;
+	}
+
+	SmallFunction(const SmallFunction &) = delete;
+	SmallFunction &operator=(const SmallFunction &) = delete;
+
+	~SmallFunction()
+	{
+		this->Reset();
+	}
+
+	explicit operator bool() const
+	{
+		return this->ops != nullptr;
+	}
+
+	R operator()(Args... args)
+	{
+		return this->ops->invoke(this->storage, std::forward<Args>(args)...);
+	}
+
+	void Reset()
+	{
+		if (this->ops)
+		{
+			this->ops->destroy(this->storage);
+			this->ops = nullptr;
+		}
+	}
+
+private:
+	struct Ops
+	{
+		R (*invoke)(void *storage, Args &&...args);
+		// Moves the callable into an empty storage and leaves the source empty.
+		void (*move)(void *dest, void *src);
+		void (*destroy)(void *storage);
+	};
+
+	template<typename F>
+	static constexpr bool IsInline = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+	template<typename F>
+	static const Ops *GetOps()
+	{
+		if constexpr (IsInline<F>)
+		{
+			// clang-format off
+			static const Ops ops = {
+				[](void *storage, Args &&...args) -> R { return (*(F *)storage)(std::forward<Args>(args)...); },
+				[](void *dest, void *src) { new (dest) F(std::move(*(F *)src)); ((F *)src)->~F(); },
+				[](void *storage) { ((F *)storage)->~F(); },
+			};
+			// clang-format on
+			return &ops;
+		}
+		else
+		{
+			// clang-format off
+			static const Ops ops = {
+				[](void *storage, Args &&...args) -> R { return (**(F **)storage)(std::forward<Args>(args)...); },
+				[](void *dest, void *src) { *(F **)dest = *(F **)src; },
+				[](void *storage) { delete *(F **)storage; },
+			};
+			// clang-format on
+			return &ops;
+		}
+	}
+
+	template<typename F>
+	void Assign(F &&f)
+	{
+		using T = std::decay_t<F>;
+		if constexpr (IsInline<T>)
+		{
+			new (this->storage) T(std::forward<F>(f));
+		}
+		else
+		{
+			*(T **)this->storage = new T(std::forward<F>(f));
+		}
+		this->ops = GetOps<T>();
+	}
+
+	void MoveFrom(SmallFunction &other)
+	{
+		if (other.ops)
+		{
+			other.ops->move(this->storage, other.storage);
+			this->ops = other.ops;
+			other.ops = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) unsigned char storage[Capacity];
+	const Ops *ops {};
+};
+
+/*
+ * Bounded multi-producer/single-consumer queue.
+ *
+ * Producers claim a slot with a single CAS and never wait on the consumer (Vyukov's bounded queue, restricted to one consumer).
+ * If the ring is full, items spill into a locked vector instead of being dropped. While items are spilled, producers keep
+ * spilling, and the consumer only takes the spilled items once every ring slot claimed before the first spill has been read,
+ * so items from one producer come out in the order they were pushed.
+ */
+template<typename T, u32 Capacity>
+class MPSCQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MPSCQueue capacity must be a power of two");
+
+public:
+	MPSCQueue()
+	{
+		for (u32 i = 0; i < Capacity; i++)
+		{
+			this->cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MPSCQueue(const MPSCQueue &) = delete;
+	MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+	// Can be called from any thread.
+	void Push(T &&item)
+	{
+		if (!this->spilling.load(std::memory_order_acquire) && this->TryPush(item))
+		{
+			return;
+		}
+
+		std::unique_lock lock(this->spillMutex);
+		if (this->spill.empty())
+		{
+			this->spillStart = this->enqueuePos.load(std::memory_order_relaxed);
+		}
+		this->spill.push_back(std::move(item));
+		this->spilling.store(true, std::memory_order_release);
+		this->spillCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/*
+	 * Consumer thread only. Calls `fn` with every item that was queued before the call.
+	 * Items pushed while draining (including by `fn` itself) are left for the next call, as are spilled items if a ring slot
+	 * that was claimed before them isn't written yet.
+	 */
+	template<typename F>
+	u32 Drain(F &&fn)
+	{
+		u64 end = this->enqueuePos.load(std::memory_order_acquire);
+		u32 count = 0;
+		while (this->dequeuePos.load(std::memory_order_relaxed) < end)
+		{
+			Cell &cell = this->cells[this->dequeuePos.load(std::memory_order_relaxed) & (Capacity - 1)];
+			u64 pos = this->dequeuePos.load(std::memory_order_relaxed);
+			// A producer claimed this slot but hasn't finished writing it yet.
+			if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+			{
+				break;
+			}
+			T item = std::move(cell.value);
+			cell.sequence.store(pos + Capacity, std::memory_order_release);
+			this->dequeuePos.store(pos + 1, std::memory_order_relaxed);
+			fn(item);
+			count++;
+		}
+
+		if (this->spilling.load(std::memory_order_acquire))
+		{
+			std::vector<T> spilled;
+			{
+				std::unique_lock lock(this->spillMutex);
+				if (this->dequeuePos.load(std::memory_order_relaxed) >= this->spillStart)
+				{
+					spilled.swap(this->spill);
+					this->spilling.store(false, std::memory_order_release);
+				}
+			}
+			for (T &item : spilled)
+			{
+				fn(item);
+				count++;
+			}
+		}
+		return count;
+	}
+
+	// Approximate number of items waiting in the ring, not counting spilled ones.
+	u32 GetDepth() const
+	{
+		u64 enqueued = this->enqueuePos.load(std::memory_order_relaxed);
+		u64 dequeued = this->dequeuePos.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? (u32)(enqueued - dequeued) : 0;
+	}
+
+	// How many items ever had to be spilled because the ring was full.
+	u64 GetSpillCount() const
+	{
+		return this->spillCount.load(std::memory_order_relaxed);
+	}
+
+	static constexpr u32 GetCapacity()
+	{
+		return Capacity;
+	}
+
+private:
+	// Only moves from `item` if there was room.
+	bool TryPush(T &item)
+	{
+		u64 pos = this->enqueuePos.load(std::memory_order_relaxed);
+		Cell *cell;
+		while (true)
+		{
+			cell = &this->cells[pos & (Capacity - 1)];
+			i64 diff = (i64)cell->sequence.load(std::memory_order_acquire) - (i64)pos;
+			if (diff == 0)
+			{
+				if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = this->enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->value = std::move(item);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Cache line sized so producers writing neighbouring slots don't fight over the same line.
+	struct alignas(64) Cell
+	{
+		std::atomic<u64> sequence;
+		T value;
+	};
+
+	Cell cells[Capacity];
+	alignas(64) std::atomic<u64> enqueuePos {};
+	alignas(64) std::atomic<u64> dequeuePos {};
+
+	std::atomic<bool> spilling {};
+	std::atomic<u64> spillCount {};
+	std::mutex spillMutex;
+	std::vector<T> spill;
+	// Ring position claimed next when the first item of `spill` was pushed, guarded by `spillMutex`.
+	u64 spillStart {};
+};
@@ -106,8 +106,8 @@ static_global void PrintCategoryCommands(SurfPlayer *player, i32 category, bool
 SCMD(surf_help, SCFL_MISC)
 {
 	SurfPlayer *player = g_pSurfPlayerManager->ToPlayer(controller);
-	player->languageService->PrintChat(true, false, "Command Help Response (Chat)");
-	player->languageService->PrintConsole(false, false, "Command Help Response (Console)");
+	player->languageService->PrintChat(true, false, SURF_PHRASE("Command Help Response (Chat)"));
+	player->languageService->PrintConsole(false, false, SURF_PHRASE("Command Help Response (Console)"));
 	u64 category = 0;
 	bool foundCategory {};
 	if (args->ArgC() >= 2)
@@ -127,7 +127,7 @@ SCMD(surf_help, SCFL_MISC)
 
 	if (!foundCategory)
 	{
-		player->languageService->PrintConsole(false, false, "Command Help Response Category Hint (Console)");
+		player->languageService->PrintConsole(false, false, SURF_PHRASE("Command Help Response Category Hint (Console)"));
 		for (i32 i = 0; i < SURF_ARRAYSIZE(cmdFlagNames); i++)
 		{
 			PrintCategoryCommands(player, i, false);